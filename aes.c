@@ -38,6 +38,7 @@
 #endif
 
 #include "beecrypt/aes.h"
+#include "beecrypt/blockmode.h"
 
 #if defined(BYTE_ORDER) && defined(BIG_ENDIAN) && defined(LITTLE_ENDIAN)
 # if (BYTE_ORDER != BIG_ENDIAN) && (BYTE_ORDER != LITTLE_ENDIAN)
@@ -51,24 +52,403 @@
 #  include "beecrypt/aes_le.h"
 #endif
 
+#if !WORDS_BIGENDIAN && (defined(__i386__) || defined(__x86_64__)) && ((defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || defined(__clang__))
+# include <wmmintrin.h>
+# include <tmmintrin.h>
+# include "beecrypt/cpu.h"
+# define AESNI_AVAILABLE 1
+# define AESNI_TARGET __attribute__((target("aes,ssse3")))
+# define AESNI_FEATURES (CPUF_X86_AESNI | CPUF_X86_SSSE3)
+# define aesniEnabled() ((cpuFeatures() & AESNI_FEATURES) == AESNI_FEATURES)
+#endif
+
+#if AESNI_AVAILABLE
+/*
+ * The AES-NI code uses the same key schedule layout as the table code, i.e.
+ * the round keys in byte order, and for decryption in reverse order with
+ * InvMixColumns applied to the inner round keys; a parameter block set up by
+ * either can be used by the other.
+ *
+ * Independent blocks are processed eight at a time, to hide the latency of
+ * the aesenc/aesdec instructions.
+ */
+
+#define AESNI_BLOCKS	8
+
+/*
+ * aesniExpand
+ *  computes the next four key words from the previous four and the
+ *  (already broadcast) output of aeskeygenassist
+ */
+AESNI_TARGET
+static inline __m128i aesniExpand(__m128i k, __m128i t)
+{
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 8));
+	return _mm_xor_si128(k, t);
+}
+
+#define aesniExpand128(i, rcon) \
+	ks[i] = aesniExpand(ks[i-1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(ks[i-1], rcon), 0xff))
+
+#define aesniExpand256(i, rcon) \
+	ks[i] = aesniExpand(ks[i-2], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(ks[i-1], rcon), 0xff)); \
+	ks[i+1] = aesniExpand(ks[i-1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(ks[i], 0x00), 0xaa))
+
+/*
+ * aesniExpand192
+ *  computes the next six key words; t holds the upper four of the previous
+ *  six words, u the lower two
+ */
+#define aesniExpand192(rcon) \
+	t = aesniExpand(t, _mm_shuffle_epi32(_mm_aeskeygenassist_si128(u, rcon), 0x55)); \
+	u = _mm_xor_si128(u, _mm_slli_si128(u, 4)); \
+	u = _mm_xor_si128(u, _mm_shuffle_epi32(t, 0xff))
+
+#define aesniJoin(lo, hi) \
+	_mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(lo), _mm_castsi128_pd(hi), 0))
+
+#define aesniSplit(lo, hi) \
+	_mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(lo), _mm_castsi128_pd(hi), 1))
+
+AESNI_TARGET
+static void aesniSetup(aesParam* ap, const byte* key, size_t keybits, cipherOperation op)
+{
+	__m128i* rk = (__m128i*) ap->k;
+	__m128i ks[15];
+	unsigned int i, nr = ap->nr;
+
+	ks[0] = _mm_loadu_si128((const __m128i*) key);
+
+	if (keybits == 128)
+	{
+		aesniExpand128( 1, 0x01);
+		aesniExpand128( 2, 0x02);
+		aesniExpand128( 3, 0x04);
+		aesniExpand128( 4, 0x08);
+		aesniExpand128( 5, 0x10);
+		aesniExpand128( 6, 0x20);
+		aesniExpand128( 7, 0x40);
+		aesniExpand128( 8, 0x80);
+		aesniExpand128( 9, 0x1b);
+		aesniExpand128(10, 0x36);
+	}
+	else if (keybits == 192)
+	{
+		__m128i t = ks[0], u = _mm_loadl_epi64((const __m128i*) (key+16));
+
+		ks[1] = u;
+		aesniExpand192(0x01);
+		ks[1] = aesniJoin(ks[1], t);
+		ks[2] = aesniSplit(t, u);
+		aesniExpand192(0x02);
+		ks[3] = t;
+		ks[4] = u;
+		aesniExpand192(0x04);
+		ks[4] = aesniJoin(ks[4], t);
+		ks[5] = aesniSplit(t, u);
+		aesniExpand192(0x08);
+		ks[6] = t;
+		ks[7] = u;
+		aesniExpand192(0x10);
+		ks[7] = aesniJoin(ks[7], t);
+		ks[8] = aesniSplit(t, u);
+		aesniExpand192(0x20);
+		ks[9] = t;
+		ks[10] = u;
+		aesniExpand192(0x40);
+		ks[10] = aesniJoin(ks[10], t);
+		ks[11] = aesniSplit(t, u);
+		aesniExpand192(0x80);
+		ks[12] = t;
+	}
+	else
+	{
+		ks[1] = _mm_loadu_si128((const __m128i*) (key+16));
+
+		aesniExpand256( 2, 0x01);
+		aesniExpand256( 4, 0x02);
+		aesniExpand256( 6, 0x04);
+		aesniExpand256( 8, 0x08);
+		aesniExpand256(10, 0x10);
+		aesniExpand256(12, 0x20);
+		ks[14] = aesniExpand(ks[12], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(ks[13], 0x40), 0xff));
+	}
+
+	if (op == DECRYPT)
+	{
+		_mm_storeu_si128(rk, ks[nr]);
+		for (i = 1; i < nr; i++)
+			_mm_storeu_si128(rk+i, _mm_aesimc_si128(ks[nr-i]));
+		_mm_storeu_si128(rk+nr, ks[0]);
+	}
+	else
+	{
+		for (i = 0; i <= nr; i++)
+			_mm_storeu_si128(rk+i, ks[i]);
+	}
+}
+
+/*
+ * aesniLoadKey
+ *  loads the round keys of ap into rk
+ */
+AESNI_TARGET
+static inline unsigned int aesniLoadKey(const aesParam* ap, __m128i* rk)
+{
+	register unsigned int i, nr = ap->nr;
+
+	for (i = 0; i <= nr; i++)
+		rk[i] = _mm_loadu_si128(((const __m128i*) ap->k)+i);
+
+	return nr;
+}
+
+AESNI_TARGET
+static inline __m128i aesniEncrypt1(const __m128i* rk, unsigned int nr, __m128i b)
+{
+	register unsigned int i;
+
+	b = _mm_xor_si128(b, rk[0]);
+	for (i = 1; i < nr; i++)
+		b = _mm_aesenc_si128(b, rk[i]);
+	return _mm_aesenclast_si128(b, rk[nr]);
+}
+
+AESNI_TARGET
+static inline __m128i aesniDecrypt1(const __m128i* rk, unsigned int nr, __m128i b)
+{
+	register unsigned int i;
+
+	b = _mm_xor_si128(b, rk[0]);
+	for (i = 1; i < nr; i++)
+		b = _mm_aesdec_si128(b, rk[i]);
+	return _mm_aesdeclast_si128(b, rk[nr]);
+}
+
+/*
+ * aesniEncrypt8, aesniDecrypt8
+ *  the eight blocks are kept in separate variables, so that the compiler
+ *  keeps them in registers for all rounds
+ */
+#define aesniRound8(op, k) \
+	b0 = op(b0, k); b1 = op(b1, k); b2 = op(b2, k); b3 = op(b3, k); \
+	b4 = op(b4, k); b5 = op(b5, k); b6 = op(b6, k); b7 = op(b7, k)
+
+#define aesniCrypt8(round, last) \
+	register unsigned int i; \
+	__m128i b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3]; \
+	__m128i b4 = b[4], b5 = b[5], b6 = b[6], b7 = b[7]; \
+	aesniRound8(_mm_xor_si128, rk[0]); \
+	for (i = 1; i < nr; i++) \
+	{ \
+		aesniRound8(round, rk[i]); \
+	} \
+	aesniRound8(last, rk[nr]); \
+	b[0] = b0; b[1] = b1; b[2] = b2; b[3] = b3; \
+	b[4] = b4; b[5] = b5; b[6] = b6; b[7] = b7
+
+AESNI_TARGET
+static inline void aesniEncrypt8(const __m128i* rk, unsigned int nr, __m128i* b)
+{
+	aesniCrypt8(_mm_aesenc_si128, _mm_aesenclast_si128);
+}
+
+AESNI_TARGET
+static inline void aesniDecrypt8(const __m128i* rk, unsigned int nr, __m128i* b)
+{
+	aesniCrypt8(_mm_aesdec_si128, _mm_aesdeclast_si128);
+}
+
+AESNI_TARGET
+static void aesniEncrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
+{
+	__m128i rk[15];
+	unsigned int nr = aesniLoadKey(ap, rk);
+
+	_mm_storeu_si128((__m128i*) dst, aesniEncrypt1(rk, nr, _mm_loadu_si128((const __m128i*) src)));
+}
+
+AESNI_TARGET
+static void aesniDecrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
+{
+	__m128i rk[15];
+	unsigned int nr = aesniLoadKey(ap, rk);
+
+	_mm_storeu_si128((__m128i*) dst, aesniDecrypt1(rk, nr, _mm_loadu_si128((const __m128i*) src)));
+}
+
+AESNI_TARGET
+static void aesniEncryptECB(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	const __m128i* in = (const __m128i*) src;
+	__m128i* out = (__m128i*) dst;
+	__m128i rk[15], b[AESNI_BLOCKS];
+	unsigned int j, nr = aesniLoadKey(ap, rk);
+
+	for (; nblocks >= AESNI_BLOCKS; nblocks -= AESNI_BLOCKS)
+	{
+		for (j = 0; j < AESNI_BLOCKS; j++)
+			b[j] = _mm_loadu_si128(in++);
+		aesniEncrypt8(rk, nr, b);
+		for (j = 0; j < AESNI_BLOCKS; j++)
+			_mm_storeu_si128(out++, b[j]);
+	}
+	while (nblocks--)
+		_mm_storeu_si128(out++, aesniEncrypt1(rk, nr, _mm_loadu_si128(in++)));
+}
+
+AESNI_TARGET
+static void aesniDecryptECB(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	const __m128i* in = (const __m128i*) src;
+	__m128i* out = (__m128i*) dst;
+	__m128i rk[15], b[AESNI_BLOCKS];
+	unsigned int j, nr = aesniLoadKey(ap, rk);
+
+	for (; nblocks >= AESNI_BLOCKS; nblocks -= AESNI_BLOCKS)
+	{
+		for (j = 0; j < AESNI_BLOCKS; j++)
+			b[j] = _mm_loadu_si128(in++);
+		aesniDecrypt8(rk, nr, b);
+		for (j = 0; j < AESNI_BLOCKS; j++)
+			_mm_storeu_si128(out++, b[j]);
+	}
+	while (nblocks--)
+		_mm_storeu_si128(out++, aesniDecrypt1(rk, nr, _mm_loadu_si128(in++)));
+}
+
+AESNI_TARGET
+static void aesniEncryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	const __m128i* in = (const __m128i*) src;
+	__m128i* out = (__m128i*) dst;
+	__m128i rk[15], fb = _mm_loadu_si128((const __m128i*) ap->fdback);
+	unsigned int nr = aesniLoadKey(ap, rk);
+
+	while (nblocks--)
+	{
+		fb = aesniEncrypt1(rk, nr, _mm_xor_si128(fb, _mm_loadu_si128(in++)));
+		_mm_storeu_si128(out++, fb);
+	}
+
+	_mm_storeu_si128((__m128i*) ap->fdback, fb);
+}
+
+AESNI_TARGET
+static void aesniDecryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	const __m128i* in = (const __m128i*) src;
+	__m128i* out = (__m128i*) dst;
+	__m128i rk[15], b[AESNI_BLOCKS], c[AESNI_BLOCKS], fb = _mm_loadu_si128((const __m128i*) ap->fdback);
+	unsigned int j, nr = aesniLoadKey(ap, rk);
+
+	/* dst may equal src, so the ciphertext is kept until it has been used */
+	for (; nblocks >= AESNI_BLOCKS; nblocks -= AESNI_BLOCKS)
+	{
+		for (j = 0; j < AESNI_BLOCKS; j++)
+			b[j] = c[j] = _mm_loadu_si128(in++);
+		aesniDecrypt8(rk, nr, b);
+		_mm_storeu_si128(out++, _mm_xor_si128(b[0], fb));
+		for (j = 1; j < AESNI_BLOCKS; j++)
+			_mm_storeu_si128(out++, _mm_xor_si128(b[j], c[j-1]));
+		fb = c[AESNI_BLOCKS-1];
+	}
+	while (nblocks--)
+	{
+		c[0] = _mm_loadu_si128(in++);
+		_mm_storeu_si128(out++, _mm_xor_si128(aesniDecrypt1(rk, nr, c[0]), fb));
+		fb = c[0];
+	}
+
+	_mm_storeu_si128((__m128i*) ap->fdback, fb);
+}
+
+/*
+ * aesniCounter
+ *  the counter is a 128-bit number in fdback, stored as mpw words, most
+ *  significant first, each in host order; like blockEncryptCTR, the block
+ *  to encrypt is its byte-reversed image. With 64-bit words the counter is
+ *  kept in two local variables, so that it doesn't go through memory; it's
+ *  copied in and out with memcpy, since fdback is an array of uint32_t.
+ */
+#if MP_WBITS == 64
+# define aesniCounterLoad() \
+	mpw ctr[2], chi, clo; \
+	memcpy(ctr, ap->fdback, sizeof(ctr)); \
+	chi = ctr[0]; clo = ctr[1]
+# define aesniCounterNext(b) \
+	b = _mm_set_epi64x((long long) __builtin_bswap64(chi), (long long) __builtin_bswap64(clo)); \
+	if (++clo == 0) chi++
+# define aesniCounterSave() \
+	ctr[0] = chi, ctr[1] = clo, memcpy(ap->fdback, ctr, sizeof(ctr))
+#else
+# define aesniCounterLoad() \
+	__m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)
+# define aesniCounterNext(b) \
+	b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) ap->fdback), swap); \
+	mpaddw(MP_BYTES_TO_WORDS(16), (mpw*) ap->fdback, 1)
+# define aesniCounterSave()
+#endif
+
+AESNI_TARGET
+static void aesniEncryptCTR(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	const __m128i* in = (const __m128i*) src;
+	__m128i* out = (__m128i*) dst;
+	__m128i rk[15], b[AESNI_BLOCKS];
+	unsigned int j, nr = aesniLoadKey(ap, rk);
+
+	aesniCounterLoad();
+
+	for (; nblocks >= AESNI_BLOCKS; nblocks -= AESNI_BLOCKS)
+	{
+		for (j = 0; j < AESNI_BLOCKS; j++)
+		{
+			aesniCounterNext(b[j]);
+		}
+		aesniEncrypt8(rk, nr, b);
+		for (j = 0; j < AESNI_BLOCKS; j++)
+			_mm_storeu_si128(out++, _mm_xor_si128(b[j], _mm_loadu_si128(in++)));
+	}
+	while (nblocks--)
+	{
+		aesniCounterNext(b[0]);
+		_mm_storeu_si128(out++, _mm_xor_si128(aesniEncrypt1(rk, nr, b[0]), _mm_loadu_si128(in++)));
+	}
+
+	aesniCounterSave();
+}
+#endif
+
 #ifdef ASM_AESENCRYPTECB
 extern int aesEncryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+#else
+static int aesEncryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
 #endif
 
 #ifdef ASM_AESDECRYPTECB
 extern int aesDecryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+#else
+static int aesDecryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
 #endif
 
 #ifdef ASM_AESENCRYPTCBC
 extern int aesEncryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+#else
+static int aesEncryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
 #endif
 
 #ifdef ASM_AESDECRYPTCBC
 extern int aesDecryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+#else
+static int aesDecryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
 #endif
 
 #ifdef ASM_AESENCRYPTCTR
 extern int aesEncryptCTR(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+#else
+static int aesEncryptCTR(aesParam*, uint32_t*, const uint32_t*, unsigned int);
 #endif
 
 #ifdef ASM_AESDECRYPTCTR
@@ -89,45 +469,28 @@ const blockCipher aes = {
 	.raw =
 	{
 		.encrypt = (blockCipherRawcrypt) aesEncrypt,
-		.decrypt = (blockCipherRawcrypt) aesDecrypt
+		.decrypt = (blockCipherRawcrypt) aesDecrypt,
+		.encryptn = (blockCipherModcrypt) aesEncryptECB,
+		.decryptn = (blockCipherModcrypt) aesDecryptECB
 	},
 	.ecb =
 	{
-		#ifdef ASM_AESENCRYPTECB
 		.encrypt = (blockCipherModcrypt) aesEncryptECB,
-		#else
-		.encrypt = (blockCipherModcrypt) 0,
-		#endif
-		#ifdef ASM_AESDECRYPTECB
-		.decrypt = (blockCipherModcrypt) aesDecryptECB,
-		#else
-		.decrypt = (blockCipherModcrypt) 0,
-		#endif
+		.decrypt = (blockCipherModcrypt) aesDecryptECB
 	},
 	.cbc =
 	{
-		#ifdef ASM_AESENCRYPTCBC
 		.encrypt = (blockCipherModcrypt) aesEncryptCBC,
-		#else
-		.encrypt = (blockCipherModcrypt) 0,
-		#endif
-		#ifdef ASM_AESDECRYPTCBC
-		.decrypt = (blockCipherModcrypt) aesDecryptCBC,
-		#else
-		.decrypt = (blockCipherModcrypt) 0
-		#endif
+		.decrypt = (blockCipherModcrypt) aesDecryptCBC
 	},
 	.ctr =
 	{
-		#ifdef ASM_AESENCRYPTCTR
 		.encrypt = (blockCipherModcrypt) aesEncryptCTR,
-		#else
-		.encrypt = (blockCipherModcrypt) 0,
-		#endif
+		/* decryption is the same operation in ctr mode */
 		#ifdef ASM_AESDECRYPTCTR
-		.decrypt = (blockCipherModcrypt) aesDecryptCTR,
+		.decrypt = (blockCipherModcrypt) aesDecryptCTR
 		#else
-		.decrypt = (blockCipherModcrypt) 0
+		.decrypt = (blockCipherModcrypt) aesEncryptCTR
 		#endif
 	}
 };
@@ -149,6 +512,14 @@ int aesSetup(aesParam* ap, const byte* key, size_t keybits, cipherOperation op)
 
 		ap->nr = 6 + (keybits >> 5);
 
+		#if AESNI_AVAILABLE
+		if (aesniEnabled())
+		{
+			aesniSetup(ap, key, keybits, op);
+			return 0;
+		}
+		#endif
+
 		rk = ap->k;
 
 		memcpy(rk, key, keybits >> 3);
@@ -363,6 +734,14 @@ int aesEncrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
 	#endif
 	register uint32_t* rk = ap->k;
 
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniEncrypt(ap, dst, src);
+		return 0;
+	}
+	#endif
+
 	#if defined (OPTIMIZE_MMX) && (defined(OPTIMIZE_I586) || defined(OPTIMIZE_I686))
 	s0 = _mm_cvtsi32_si64(src[0] ^ rk[0]);
 	s1 = _mm_cvtsi32_si64(src[1] ^ rk[1]);
@@ -423,6 +802,14 @@ int aesDecrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
 	register uint32_t t0, t1, t2, t3;
 	register uint32_t* rk = ap->k;
 
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniDecrypt(ap, dst, src);
+		return 0;
+	}
+	#endif
+
 	s0 = src[0] ^ rk[0];
 	s1 = src[1] ^ rk[1];
 	s2 = src[2] ^ rk[2];
@@ -466,3 +853,83 @@ uint32_t* aesFeedback(aesParam* ap)
 {
 	return ap->fdback;
 }
+
+/*
+ * The mode functions below use AES-NI if available, and otherwise the
+ * generic modes on top of the table code.
+ */
+
+#ifndef ASM_AESENCRYPTECB
+static int aesEncryptECB(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniEncryptECB(ap, dst, src, nblocks);
+		return 0;
+	}
+	#endif
+
+	return blockEncryptECB(&aes, (blockCipherParam*) ap, dst, src, nblocks);
+}
+#endif
+
+#ifndef ASM_AESDECRYPTECB
+static int aesDecryptECB(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniDecryptECB(ap, dst, src, nblocks);
+		return 0;
+	}
+	#endif
+
+	return blockDecryptECB(&aes, (blockCipherParam*) ap, dst, src, nblocks);
+}
+#endif
+
+#ifndef ASM_AESENCRYPTCBC
+static int aesEncryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniEncryptCBC(ap, dst, src, nblocks);
+		return 0;
+	}
+	#endif
+
+	return blockEncryptCBC(&aes, (blockCipherParam*) ap, dst, src, nblocks);
+}
+#endif
+
+#ifndef ASM_AESDECRYPTCBC
+static int aesDecryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniDecryptCBC(ap, dst, src, nblocks);
+		return 0;
+	}
+	#endif
+
+	return blockDecryptCBC(&aes, (blockCipherParam*) ap, dst, src, nblocks);
+}
+#endif
+
+#ifndef ASM_AESENCRYPTCTR
+static int aesEncryptCTR(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if AESNI_AVAILABLE
+	if (aesniEnabled())
+	{
+		aesniEncryptCTR(ap, dst, src, nblocks);
+		return 0;
+	}
+	#endif
+
+	return blockEncryptCTR(&aes, (blockCipherParam*) ap, dst, src, nblocks);
+}
+#endif
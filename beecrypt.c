@@ -30,10 +30,15 @@
 
 #include "beecrypt/beecrypt.h"
 
+#include "beecrypt/entropysys.h"
 #include "beecrypt/entropy.h"
 
+#include "beecrypt/ctrdrbg.h"
 #include "beecrypt/fips186.h"
 #include "beecrypt/mtprng.h"
+#include "beecrypt/poolprng.h"
+#include "beecrypt/sfmt.h"
+#include "beecrypt/threadprng.h"
 
 #include "beecrypt/md4.h"
 #include "beecrypt/md5.h"
@@ -65,6 +70,9 @@ static entropySource entropySourceList[] =
 	{ "console", entropy_console },
 	{ "wavein", entropy_wavein },
 #else
+# if HAVE_SYS_GETRANDOM
+	{ "getrandom", entropy_getrandom },
+# endif
 # if HAVE_DEV_URANDOM
 	{ "urandom", entropy_dev_urandom },
 # endif
@@ -152,7 +160,12 @@ int entropyGatherNext(byte* data, size_t size)
 static const randomGenerator* randomGeneratorList[] =
 {
 	&fips186prng,
-	&mtprng
+	&mtprng,
+	&ctrdrbg,
+	&fips186threadprng,
+	&mtthreadprng,
+	&poolprng,
+	&sfmtprng
 };
 
 #define RANDOMGENERATORS	(sizeof(randomGeneratorList) / sizeof(randomGenerator*))
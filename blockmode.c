@@ -30,6 +30,23 @@
 #endif
 
 #include "beecrypt/blockmode.h"
+#include "beecrypt/endianness.h"
+
+/*
+ * The number of blocks which CBC decryption and CTR mode hand to the
+ * cipher's multi-block raw functions at once.
+ */
+#define BLOCKMODE_BLOCKS	8
+/*
+ * The largest block size, in 32-bit words, which the buffers on the stack
+ * are sized for; ciphers with larger blocks are handled in smaller groups
+ */
+#define BLOCKMODE_MAXWORDS	4
+/*
+ * CBC decryption and CTR mode return -1 for ciphers with blocks of more
+ * than this many words, i.e. 64 bytes; the buffers still hold two of them
+ */
+#define BLOCKMODE_LIMIT		16
 
 int blockEncryptECB(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
 {
@@ -104,42 +121,63 @@ int blockEncryptCBC(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst,
 
 int blockDecryptCBC(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
 {
+	/* the blocks are decrypted into buf, in groups of up to BLOCKMODE_BLOCKS;
+	 * the extra block holds the last ciphertext block of the group, which
+	 * becomes the feedback, since dst may equal src
+	 */
+
 	register const unsigned int blockwords = bc->blocksize >> 2;
 	register uint32_t* fdback = bc->getfb(bp);
-	register uint32_t* buf = (uint32_t*) malloc(blockwords * sizeof(uint32_t));
+	register unsigned int group;
+	uint32_t buf[(BLOCKMODE_BLOCKS+1) * BLOCKMODE_MAXWORDS];
 
-	if (buf)
+	if (blockwords > BLOCKMODE_LIMIT)
+		return -1;
+
+	group = (BLOCKMODE_BLOCKS+1) * BLOCKMODE_MAXWORDS / blockwords - 1;
+	if (group > BLOCKMODE_BLOCKS)
+		group = BLOCKMODE_BLOCKS;
+
+	while (nblocks > 0)
 	{
-		while (nblocks > 0)
+		register unsigned int i, k, n = (nblocks < group) ? nblocks : group;
+		register uint32_t* last = buf + n * blockwords;
+
+		if (bc->raw.decryptn)
+			bc->raw.decryptn(bp, buf, src, n);
+		else
 		{
-			register uint32_t tmp;
-			register unsigned int i;
+			for (k = 0; k < n; k++)
+				bc->raw.decrypt(bp, buf + k * blockwords, src + k * blockwords);
+		}
 
-			bc->raw.decrypt(bp, buf, src);
+		for (i = 0; i < blockwords; i++)
+			last[i] = src[(n-1) * blockwords + i];
 
+		/* work backwards, so that in-place decryption doesn't overwrite ciphertext which is still needed */
+		for (k = n-1; k > 0; k--)
 			for (i = 0; i < blockwords; i++)
-			{
-				tmp = src[i];
-				dst[i] = buf[i] ^ fdback[i];
-				fdback[i] = tmp;
-			}
+				dst[k * blockwords + i] = buf[k * blockwords + i] ^ src[(k-1) * blockwords + i];
 
-			dst += blockwords;
-			src += blockwords;
-
-			nblocks--;
+		for (i = 0; i < blockwords; i++)
+		{
+			dst[i] = buf[i] ^ fdback[i];
+			fdback[i] = last[i];
 		}
-		free(buf);
-		return 0;
+
+		dst += n * blockwords;
+		src += n * blockwords;
+
+		nblocks -= n;
 	}
 
-	return -1;
+	return 0;
 }
 
 int blockEncryptCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
 {
 	/* host-endian counter is kept in fdback;
-	 * swap to big-endian buffer;
+	 * swap to big-endian buffer, for up to BLOCKMODE_BLOCKS counter values;
 	 * encrypt buffer;
 	 * src ^ ciphertext -> dst
 	 * increment fdback (as mpi) by one inlined;
@@ -147,36 +185,52 @@ int blockEncryptCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst,
 
 	register const unsigned int blockwords = bc->blocksize >> 2;
 	register uint32_t* fdback = bc->getfb(bp);
-	register uint32_t* buf = (uint32_t*) malloc(blockwords * sizeof(uint32_t));
+	register unsigned int group;
+	uint32_t buf[BLOCKMODE_BLOCKS * BLOCKMODE_MAXWORDS];
+
+	if (blockwords > BLOCKMODE_LIMIT)
+		return -1;
 
-	if (buf)
+	group = BLOCKMODE_BLOCKS * BLOCKMODE_MAXWORDS / blockwords;
+	if (group > BLOCKMODE_BLOCKS)
+		group = BLOCKMODE_BLOCKS;
+
+	while (nblocks > 0)
 	{
-		while (nblocks > 0)
+		unsigned int i, j, k, n = (nblocks < group) ? nblocks : group;
+
+		for (k = 0; k < n; k++)
 		{
-			unsigned int i, j;
+			register uint32_t* ctr = buf + k * blockwords;
 
 			#if WORDS_BIGENDIAN
-			bc->raw.encrypt(bp, buf, fdback);
+			for (i = 0; i < blockwords; i++)
+				ctr[i] = fdback[i];
 			#else
 			for (i = 0, j = blockwords-1; i < blockwords; i++, j--)
-				buf[i] = swapu32(fdback[j]);
-			bc->raw.encrypt(bp, buf, buf);
+				ctr[i] = swapu32(fdback[j]);
 			#endif
 
-			for (i = 0; i < blockwords; i++)
-				dst[i] = src[i] ^ buf[i];
-
-			dst += blockwords;
-			src += blockwords;
-
-			nblocks--;
-
 			/* increment counter */
 			mpaddw((blockwords >> 1), (mpw*) fdback, 1);
 		}
-		free(buf);
-		return 0;
+
+		if (bc->raw.encryptn)
+			bc->raw.encryptn(bp, buf, buf, n);
+		else
+		{
+			for (k = 0; k < n; k++)
+				bc->raw.encrypt(bp, buf + k * blockwords, buf + k * blockwords);
+		}
+
+		for (i = 0; i < n * blockwords; i++)
+			dst[i] = src[i] ^ buf[i];
+
+		dst += n * blockwords;
+		src += n * blockwords;
+
+		nblocks -= n;
 	}
 
-	return -1;
+	return 0;
 }
@@ -340,7 +340,9 @@ const blockCipher blowfish = {
 	.raw =
 	{
 		.encrypt = (blockCipherRawcrypt) blowfishEncrypt,
-		.decrypt = (blockCipherRawcrypt) blowfishDecrypt
+		.decrypt = (blockCipherRawcrypt) blowfishDecrypt,
+		.encryptn = (blockCipherModcrypt) 0,
+		.decryptn = (blockCipherModcrypt) 0
 	},
 	.ecb =
 	{
@@ -652,3 +652,19 @@ int Cipher::update(const byte* input, int inputOffset, int inputLength, bytearra
 
 	return _cspi->engineUpdate(input, inputOffset, inputLength, output, outputOffset);
 }
+
+void Cipher::updateAAD(const bytearray& input) throw (IllegalStateException, UnsupportedOperationException)
+{
+	if (!_init)
+		throw IllegalStateException("Cipher not initialized");
+
+	_cspi->engineUpdateAAD(input.data(), 0, input.size());
+}
+
+void Cipher::updateAAD(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, UnsupportedOperationException)
+{
+	if (!_init)
+		throw IllegalStateException("Cipher not initialized");
+
+	_cspi->engineUpdateAAD(input, inputOffset, inputLength);
+}
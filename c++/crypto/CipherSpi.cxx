@@ -23,8 +23,6 @@
 #endif
 
 #include "beecrypt/c++/crypto/CipherSpi.h"
-#include "beecrypt/c++/lang/UnsupportedOperationException.h"
-using beecrypt::lang::UnsupportedOperationException;
 
 using namespace beecrypt::crypto;
 
@@ -32,3 +30,8 @@ int CipherSpi::engineGetKeySize(const Key& key) const throw (InvalidKeyException
 {
 	throw UnsupportedOperationException();
 }
+
+void CipherSpi::engineUpdateAAD(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, UnsupportedOperationException)
+{
+	throw UnsupportedOperationException("cipher doesn't support additional authenticated data");
+}
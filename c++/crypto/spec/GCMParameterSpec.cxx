@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define BEECRYPT_CXX_DLL_EXPORT
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/c++/crypto/spec/GCMParameterSpec.h"
+
+using namespace beecrypt::crypto::spec;
+
+GCMParameterSpec::GCMParameterSpec(int tLen, const byte* iv, size_t offset, size_t length) : _tlen(tLen), _iv(iv+offset, length)
+{
+}
+
+GCMParameterSpec::GCMParameterSpec(int tLen, const bytearray& iv) : _tlen(tLen), _iv(iv)
+{
+}
+
+int GCMParameterSpec::getTLen() const throw ()
+{
+	return _tlen;
+}
+
+const bytearray& GCMParameterSpec::getIV() const throw ()
+{
+	return _iv;
+}
+
+bytearray* GCMParameterSpec::getIV()
+{
+	return new bytearray(_iv);
+}
@@ -23,6 +23,7 @@
 #endif
 
 #include "beecrypt/c++/math/BigInteger.h"
+#include "beecrypt/mpprime.h"
 #include "beecrypt/c++/lang/Character.h"
 using beecrypt::lang::Character;
 #include "beecrypt/c++/lang/StringBuilder.h"
@@ -511,6 +512,41 @@ BigInteger BigInteger::multiply(const BigInteger& val) const
 	return BigInteger(rsize, rdata, sign * val.sign);
 }
 
+bool BigInteger::isProbablePrime(jint certainty) const
+{
+	if (certainty <= 0)
+		return true;
+
+	// as in Java, the test applies to the magnitude
+	if (sign == 0 || mpisone(size, data))
+		return false;
+
+	if (mpeven(size, data))
+		return mpistwo(size, data);
+
+	mpbarrett b;
+
+	mpbzero(&b);
+	mpbset(&b, size, data);
+	if (b.modl == 0)
+		throw OutOfMemoryError();
+
+	mpw* wksp = (mpw*) malloc((8*size+2) * sizeof(mpw));
+	if (wksp == 0)
+	{
+		mpbfree(&b);
+		throw OutOfMemoryError();
+	}
+
+	// no composite is known to pass Baillie-PSW, so it meets any certainty
+	int result = mppbpsw_w(&b, wksp);
+
+	free(wksp);
+	mpbfree(&b);
+
+	return result != 0;
+}
+
 #if 0
 BigInteger BigInteger::mod(const BigInteger& m) const throw (ArithmeticException)
 {
@@ -45,6 +45,7 @@
 #include "beecrypt/c++/provider/HMACSHA512.h"
 #include "beecrypt/c++/provider/MD5Digest.h"
 #include "beecrypt/c++/provider/MD5withRSASignature.h"
+#include "beecrypt/c++/provider/PBKDF2KeyFactory.h"
 #include "beecrypt/c++/provider/PKCS12KeyFactory.h"
 #include "beecrypt/c++/provider/RSAKeyFactory.h"
 #include "beecrypt/c++/provider/RSAKeyPairGenerator.h"
@@ -217,6 +218,24 @@ void* beecrypt_MD5withRSASignature_create()
 	return new beecrypt::provider::MD5withRSASignature();
 }
 
+PROVAPI
+void* beecrypt_PBKDF2WithHmacSHA1KeyFactory_create()
+{
+	return new beecrypt::provider::PBKDF2KeyFactory(sha1, "PBKDF2WithHmacSHA1");
+}
+
+PROVAPI
+void* beecrypt_PBKDF2WithHmacSHA256KeyFactory_create()
+{
+	return new beecrypt::provider::PBKDF2KeyFactory(sha256, "PBKDF2WithHmacSHA256");
+}
+
+PROVAPI
+void* beecrypt_PBKDF2WithHmacSHA512KeyFactory_create()
+{
+	return new beecrypt::provider::PBKDF2KeyFactory(sha512, "PBKDF2WithHmacSHA512");
+}
+
 PROVAPI
 void* beecrypt_PKCS12KeyFactory_create()
 {
@@ -345,6 +364,9 @@ void BaseProvider::init()
 	setProperty("MessageDigest.SHA-256"                    , "beecrypt_SHA256Digest_create");
 	setProperty("MessageDigest.SHA-384"                    , "beecrypt_SHA384Digest_create");
 	setProperty("MessageDigest.SHA-512"                    , "beecrypt_SHA512Digest_create");
+	setProperty("SecretKeyFactory.PBKDF2WithHmacSHA1"       , "beecrypt_PBKDF2WithHmacSHA1KeyFactory_create");
+	setProperty("SecretKeyFactory.PBKDF2WithHmacSHA256"     , "beecrypt_PBKDF2WithHmacSHA256KeyFactory_create");
+	setProperty("SecretKeyFactory.PBKDF2WithHmacSHA512"     , "beecrypt_PBKDF2WithHmacSHA512KeyFactory_create");
 	setProperty("SecretKeyFactory.PKCS#12/PBE"             , "beecrypt_PKCS12KeyFactory_create");
 	setProperty("SecureRandom.BEE"                         , "beecrypt_BeeSecureRandom_create");
 	setProperty("Signature.MD5withRSA"                     , "beecrypt_MD5withRSASignature_create");
@@ -20,11 +20,25 @@
 # include "config.h"
 #endif
 
+#include "beecrypt/poolprng.h"
+#include "beecrypt/c++/security/Security.h"
+using beecrypt::security::Security;
 #include "beecrypt/c++/provider/BeeSecureRandom.h"
 
 using namespace beecrypt::provider;
 
-BeeSecureRandom::BeeSecureRandom()
+const randomGenerator* BeeSecureRandom::defaultGenerator()
+{
+	// check value of property securerandom.pool in beecrypt.conf
+	const String* tmp = Security::getProperty("securerandom.pool");
+
+	if (tmp && tmp->equalsIgnoreCase("true"))
+		return &poolprng;
+
+	return randomGeneratorDefault();
+}
+
+BeeSecureRandom::BeeSecureRandom() : _rngc(defaultGenerator())
 {
 }
 
@@ -30,6 +30,8 @@ using beecrypt::lang::Integer;
 using beecrypt::crypto::Cipher;
 #include "beecrypt/c++/crypto/SecretKey.h"
 using beecrypt::crypto::SecretKey;
+#include "beecrypt/c++/crypto/spec/GCMParameterSpec.h"
+using beecrypt::crypto::spec::GCMParameterSpec;
 #include "beecrypt/c++/crypto/spec/IvParameterSpec.h"
 using beecrypt::crypto::spec::IvParameterSpec;
 #include "beecrypt/c++/security/ProviderException.h"
@@ -44,10 +46,12 @@ using std::auto_ptr;
 using namespace beecrypt::provider;
 
 #define BUFFER_SIZE		4096	// must be a whole number of blocks
+#define GCM_IV_SIZE		12		// the recommended IV length for GCM
 
 const int BlockCipher::MODE_ECB = 0;
 const int BlockCipher::MODE_CBC = 1;
 const int BlockCipher::MODE_CTR = 2;
+const int BlockCipher::MODE_GCM = 3;
 
 const int BlockCipher::PADDING_NONE = 0;
 const int BlockCipher::PADDING_PKCS5 = 1;
@@ -111,16 +115,18 @@ BlockCipher::BlockCipher(const blockCipher& cipher) : _ctxt(&cipher), _iv(cipher
 	_padding = PADDING_NONE;
 	_bufcnt = 0;
 	_buflwm = 0;
-
+	_taglen = 16;
+	_gcmspent = false;
 }
 
-bytearray* BlockCipher::engineDoFinal(const byte* input, int inputOffset, int inputLength) throw (IllegalBlockSizeException, BadPaddingException)
+bytearray* BlockCipher::engineDoFinal(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, IllegalBlockSizeException, BadPaddingException)
 {
 	bytearray* tmp = 0;
 
 	int outputLength = engineGetOutputSize(inputLength);
 
-	if (outputLength > 0)
+	// GCM always has to check the tag, even if there is no output
+	if (outputLength > 0 || _blmode == MODE_GCM)
 	{
 		tmp = new bytearray(outputLength);
 
@@ -143,10 +149,23 @@ bytearray* BlockCipher::engineDoFinal(const byte* input, int inputOffset, int in
 	return tmp;
 }
 
-int BlockCipher::engineDoFinal(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (ShortBufferException, IllegalBlockSizeException, BadPaddingException)
+int BlockCipher::engineDoFinal(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (IllegalStateException, ShortBufferException, IllegalBlockSizeException, BadPaddingException)
 {
 	int blocksize = _ctxt.algo->blocksize;
 
+	if (_blmode == MODE_GCM)
+	{
+		int total = processGCM(input+inputOffset, inputLength, output.data() + outputOffset, output.size() - outputOffset);
+		int last = finishGCM(output.data() + outputOffset + total, output.size() - outputOffset - total);
+
+		engineReset();
+
+		if (last < 0)
+			throw BadPaddingException("GCM tag mismatch");
+
+		return total + last;
+	}
+
 	_buflwm = 0;
 
 	int total = process(input+inputOffset, inputLength, output.data() + outputOffset, output.size() - outputOffset);
@@ -230,6 +249,17 @@ int BlockCipher::engineGetOutputSize(int inputLength) throw ()
 {
 	int total = _bufcnt + inputLength;
 
+	if (_blmode == MODE_GCM)
+	{
+		// encryption appends the tag; decryption strips it
+		if (_opmode == Cipher::ENCRYPT_MODE)
+			return inputLength + _taglen;
+
+		total = _gcmbuf.size() + inputLength - _taglen;
+
+		return (total > 0) ? total : 0;
+	}
+
 	// PKCS5 padding + encryption can add up to (blocksize) bytes
 	if ((_padding == PADDING_PKCS5) && (_opmode == Cipher::ENCRYPT_MODE))
 	{
@@ -252,6 +282,29 @@ AlgorithmParameters* BlockCipher::engineGetParameters() throw ()
 }
 
 void BlockCipher::engineInit(int opmode, const Key& key, SecureRandom* random) throw (InvalidKeyException)
+{
+	if (_blmode == MODE_GCM)
+	{
+		// GCM must never reuse an IV with the same key, so pick a random one
+		if (opmode != Cipher::ENCRYPT_MODE)
+			throw InvalidKeyException("GCM decryption requires parameters");
+
+		_iv.resize(GCM_IV_SIZE);
+		if (random)
+			random->nextBytes(_iv.data(), _iv.size());
+		else
+		{
+			SecureRandom rng;
+
+			rng.nextBytes(_iv.data(), _iv.size());
+		}
+		_taglen = 16;
+	}
+
+	initKey(opmode, key);
+}
+
+void BlockCipher::initKey(int opmode, const Key& key) throw (InvalidKeyException)
 {
 	_opmode = opmode;
 
@@ -262,6 +315,16 @@ void BlockCipher::engineInit(int opmode, const Key& key, SecureRandom* random) t
 
 	_key = *(dynamic_cast<const SecretKey&>(key).getEncoded());
 
+	// a new key or IV makes GCM encryption possible again
+	_gcmspent = false;
+
+	if (_blmode == MODE_GCM && opmode == Cipher::ENCRYPT_MODE)
+	{
+		// remember the pair, so that it can't be used for another encryption
+		_gcmkey = _key;
+		_gcmiv = _iv;
+	}
+
 	engineReset();
 }
 
@@ -286,6 +349,40 @@ void BlockCipher::engineInit(int opmode, const Key& key, AlgorithmParameters* pa
 
 void BlockCipher::engineInit(int opmode, const Key& key, const AlgorithmParameterSpec& params, SecureRandom* random) throw (InvalidKeyException, InvalidAlgorithmParameterException)
 {
+	if (_blmode == MODE_GCM)
+	{
+		const GCMParameterSpec* gcm = dynamic_cast<const GCMParameterSpec*>(&params);
+		const IvParameterSpec* iv = dynamic_cast<const IvParameterSpec*>(&params);
+		const SecretKey* secret = dynamic_cast<const SecretKey*>(&key);
+		int tlen = 128;
+
+		if (gcm)
+		{
+			tlen = gcm->getTLen();
+
+			// the tag lengths allowed by NIST SP 800-38D
+			if (tlen != 32 && tlen != 64 && (tlen < 96 || tlen > 128 || (tlen & 7)))
+				throw InvalidAlgorithmParameterException("unsupported GCM tag length");
+		}
+		else if (!iv)
+			throw InvalidAlgorithmParameterException("GCM only accepts a GCMParameterSpec or an IvParameterSpec");
+
+		const bytearray& newiv = gcm ? gcm->getIV() : iv->getIV();
+
+		if (newiv.size() == 0)
+			throw InvalidAlgorithmParameterException("IV must not be empty");
+
+		// like the JCE, refuse to encrypt again with the last key and IV
+		if (opmode == Cipher::ENCRYPT_MODE && secret && secret->getEncoded() && newiv == _gcmiv && *secret->getEncoded() == _gcmkey)
+			throw InvalidAlgorithmParameterException("GCM must not reuse an IV with the same key for encryption");
+
+		_iv = newiv;
+		_taglen = tlen >> 3;
+
+		initKey(opmode, key);
+		return;
+	}
+
 	const IvParameterSpec* iv = dynamic_cast<const IvParameterSpec*>(&params);
 	if (!iv)
 		throw InvalidAlgorithmParameterException("BlockCipher only accepts an IvParameterSpec");
@@ -298,7 +395,7 @@ void BlockCipher::engineInit(int opmode, const Key& key, const AlgorithmParamete
 
 	_iv = iv->getIV();
 
-	engineInit(opmode, key, random);
+	initKey(opmode, key);
 }
 
 bytearray* BlockCipher::engineUpdate(const byte* input, int inputOffset, int inputLength)
@@ -320,11 +417,27 @@ bytearray* BlockCipher::engineUpdate(const byte* input, int inputOffset, int inp
 	return tmp;
 }
 
-int BlockCipher::engineUpdate(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (ShortBufferException)
+int BlockCipher::engineUpdate(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (IllegalStateException, ShortBufferException)
 {
 	return process(input+inputOffset, inputLength, output.data() + outputOffset, output.size() - outputOffset);
 }
 
+void BlockCipher::engineUpdateAAD(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, UnsupportedOperationException)
+{
+	if (_blmode != MODE_GCM)
+		throw UnsupportedOperationException("only GCM supports additional authenticated data");
+
+	if (_opmode != Cipher::ENCRYPT_MODE && _opmode != Cipher::DECRYPT_MODE)
+		throw IllegalStateException("Cipher not initialized");
+
+	if (_gcmspent)
+		throw IllegalStateException("GCM encryption must be initialized again with a new IV");
+
+	// decryption holds back the text, so check the buffer too
+	if (_gcmbuf.size() || gcmContextUpdateAAD(&_gcm, input+inputOffset, inputLength))
+		throw IllegalStateException("additional authenticated data must precede the text");
+}
+
 void BlockCipher::engineSetMode(const String& mode) throw (NoSuchAlgorithmException)
 {
 	if (mode.length() == 0 || mode.equalsIgnoreCase("ECB"))
@@ -333,6 +446,8 @@ void BlockCipher::engineSetMode(const String& mode) throw (NoSuchAlgorithmExcept
 		_blmode = MODE_CBC;
 	else if (mode.equalsIgnoreCase("CTR"))
 		_blmode = MODE_CTR;
+	else if (mode.equalsIgnoreCase("GCM") && _ctxt.algo->blocksize == 16 && _padding == PADDING_NONE)
+		_blmode = MODE_GCM;
 	else
 		throw NoSuchAlgorithmException();
 }
@@ -343,9 +458,9 @@ void BlockCipher::engineSetPadding(const String& padding) throw (NoSuchPaddingEx
 			padding.equalsIgnoreCase("None") ||
 			padding.equalsIgnoreCase("NoPadding"))
 		_padding = PADDING_NONE;
-	else if (padding.equalsIgnoreCase("PKCS5") ||
+	else if ((padding.equalsIgnoreCase("PKCS5") ||
 			padding.equalsIgnoreCase("PKCS#5") ||
-			padding.equalsIgnoreCase("PKCS5Padding"))
+			padding.equalsIgnoreCase("PKCS5Padding")) && _blmode != MODE_GCM)
 		_padding = PADDING_PKCS5;
 	else
 		throw NoSuchPaddingException();
@@ -356,11 +471,14 @@ void BlockCipher::engineSetPadding(const String& padding) throw (NoSuchPaddingEx
  *        - all input and output is properly 32-bit aligned
  *        - at least 'buffer low water mark' bytes remain in the buffer (for unpadding)
  */
-int BlockCipher::process(const byte* input, int inputLength, byte* output, int outputLength) throw (ShortBufferException)
+int BlockCipher::process(const byte* input, int inputLength, byte* output, int outputLength) throw (IllegalStateException, ShortBufferException)
 {
 	int blocksize = _ctxt.algo->blocksize;
 	int total = 0;
 
+	if (_blmode == MODE_GCM)
+		return processGCM(input, inputLength, output, outputLength);
+
 	do
 	{
 		bool copyIn, copyOut;
@@ -471,9 +589,95 @@ int BlockCipher::process(const byte* input, int inputLength, byte* output, int o
 	return total;
 }
 
+/*!\brief Encrypts GCM text straight away; ciphertext is held back until
+ *        the tag has been checked.
+ */
+int BlockCipher::processGCM(const byte* input, int inputLength, byte* output, int outputLength)
+{
+	if (_opmode == Cipher::ENCRYPT_MODE)
+	{
+		if (_gcmspent)
+			throw IllegalStateException("GCM encryption must be initialized again with a new IV");
+
+		if (inputLength > outputLength)
+			throw ShortBufferException("BlockCipher output buffer too short");
+
+		if (gcmContextEncrypt(&_gcm, output, input, inputLength))
+			throw ProviderException("GCM message too long");
+
+		return inputLength;
+	}
+
+	if (inputLength > 0)
+	{
+		int offset = _gcmbuf.size();
+
+		_gcmbuf.resize(offset + inputLength);
+
+		memcpy(_gcmbuf.data() + offset, input, inputLength);
+	}
+
+	return 0;
+}
+
+/*!\brief Appends the tag when encrypting; decrypts the held back text and
+ *        checks the tag when decrypting.
+ * \return the number of bytes written, or -1 if the tag doesn't match.
+ */
+int BlockCipher::finishGCM(byte* output, int outputLength) throw (ShortBufferException)
+{
+	if (_opmode == Cipher::ENCRYPT_MODE)
+	{
+		if (outputLength < _taglen)
+			throw ShortBufferException("BlockCipher output buffer too short");
+
+		gcmContextDigest(&_gcm, output, _taglen);
+
+		// the IV mustn't be used for another encryption
+		_gcmspent = true;
+
+		return _taglen;
+	}
+
+	int size = _gcmbuf.size() - _taglen;
+
+	if (size < 0)
+		return -1;
+
+	if (size > outputLength)
+		throw ShortBufferException("BlockCipher output buffer too short");
+
+	if (gcmContextDecrypt(&_gcm, output, _gcmbuf.data(), size))
+		return -1;
+
+	if (!gcmContextVerify(&_gcm, _gcmbuf.data() + size, _taglen))
+	{
+		// don't release unauthenticated cleartext
+		memset(output, 0, size);
+		return -1;
+	}
+
+	return size;
+}
+
 void BlockCipher::engineReset()
 {
-	if (_opmode == Cipher::ENCRYPT_MODE || _opmode == Cipher::DECRYPT_MODE)
+	if (_blmode == MODE_GCM && (_opmode == Cipher::ENCRYPT_MODE || _opmode == Cipher::DECRYPT_MODE))
+	{
+		// GCM only uses the block cipher's encryption function
+		if (blockCipherContextSetup(&_ctxt, _key.data(), _keybits, ENCRYPT))
+			throw ProviderException("BeeCrypt internal error in blockCipherContextSetup");
+
+		if (gcmContextInit(&_gcm, &_ctxt))
+			throw ProviderException("BeeCrypt internal error in gcmContextInit");
+
+		// only decryption may start over with the same IV
+		if (!_gcmspent && gcmContextSetIV(&_gcm, _iv.data(), _iv.size()))
+			throw ProviderException("BeeCrypt internal error in gcmContextSetIV");
+
+		_gcmbuf.resize(0);
+	}
+	else if (_opmode == Cipher::ENCRYPT_MODE || _opmode == Cipher::DECRYPT_MODE)
 	{
 		if (blockCipherContextSetup(&_ctxt, _key.data(), _keybits, (cipherOperation) _opmode))
 			throw ProviderException("BeeCrypt internal error in blockCipherContextSetup");
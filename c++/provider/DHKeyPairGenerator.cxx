@@ -23,6 +23,7 @@
 #include "beecrypt/c++/adapter.h"
 #include "beecrypt/c++/crypto/spec/DHParameterSpec.h"
 #include "beecrypt/c++/provider/DHKeyPairGenerator.h"
+#include "beecrypt/c++/provider/GeneratorThreads.h"
 #include "beecrypt/c++/provider/DHPublicKeyImpl.h"
 #include "beecrypt/c++/provider/DHPrivateKeyImpl.h"
 #include "beecrypt/c++/security/KeyPair.h"
@@ -46,6 +47,8 @@ DHKeyPairGenerator::DHKeyPairGenerator()
 	_size = 0;
 	_spec = 0;
 	_srng = 0;
+	// check value of property dh.paramgen.threads in beecrypt.conf; 0 means one per processor
+	_threads = generatorThreads("dh.paramgen.threads");
 }
 
 DHKeyPairGenerator::~DHKeyPairGenerator()
@@ -95,7 +98,7 @@ KeyPair* DHKeyPairGenerator::genpair(randomGeneratorContext* rngc)
 		}
 		else
 		{
-			if (dldp_pgonMakeSafe(&param, rngc, _size))
+			if (dldp_pgonMakeSafeThreads(&param, rngc, _size, _threads))
 				throw "unexpected error in dldp_pMakeSafe";
 		}
 	}
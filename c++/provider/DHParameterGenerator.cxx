@@ -23,6 +23,7 @@
 #include "beecrypt/c++/adapter.h"
 using beecrypt::randomGeneratorContextAdapter;
 #include "beecrypt/c++/provider/DHParameterGenerator.h"
+#include "beecrypt/c++/provider/GeneratorThreads.h"
 #include "beecrypt/c++/security/AlgorithmParameters.h"
 using beecrypt::security::AlgorithmParameters;
 #include "beecrypt/c++/crypto/spec/DHParameterSpec.h"
@@ -35,6 +36,8 @@ DHParameterGenerator::DHParameterGenerator()
 	_size = 0;
 	_spec = 0;
 	_srng = 0;
+	// check value of property dh.paramgen.threads in beecrypt.conf; 0 means one per processor
+	_threads = generatorThreads("dh.paramgen.threads");
 }
  
 DHParameterGenerator::~DHParameterGenerator()
@@ -51,13 +54,13 @@ AlgorithmParameters* DHParameterGenerator::engineGenerateParameters()
 		if (_srng)
 		{
 			randomGeneratorContextAdapter rngc(_srng);
-			if (dldp_pgonMakeSafe(&param, &rngc, _size))
+			if (dldp_pgonMakeSafeThreads(&param, &rngc, _size, _threads))
 				throw "unexpected error in dldp_pMake";
 		}
 		else
 		{
 			randomGeneratorContext rngc(randomGeneratorDefault());
-			if (dldp_pgonMakeSafe(&param, &rngc, _size))
+			if (dldp_pgonMakeSafeThreads(&param, &rngc, _size, _threads))
 				throw "unexpected error in dldp_pMake";
 		}
 
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/c++/lang/Integer.h"
+using beecrypt::lang::Integer;
+#include "beecrypt/c++/security/Security.h"
+using beecrypt::security::Security;
+#include "beecrypt/c++/provider/GeneratorThreads.h"
+
+int beecrypt::provider::generatorThreads(const char* property) throw (ProviderException)
+{
+	try
+	{
+		const String* tmp = Security::getProperty(property);
+		if (tmp)
+		{
+			int threads = Integer::parseInteger(*tmp);
+
+			if (threads < 0)
+				throw ProviderException(String(property) + " must be greater than or equal to 0");
+
+			return threads;
+		}
+	}
+	catch (NumberFormatException&)
+	{
+		throw ProviderException(String(property) + " not set to a numeric value");
+	}
+
+	return 1;
+}
@@ -93,14 +93,14 @@ KeyProtector::KeyProtector(PBEKey& key) throw (InvalidKeyException)
 
 	_iter = key.getIterationCount();
 
-	if (pkcs12_derive_key(&sha256, PKCS12_ID_CIPHER, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, _cipher_key, 32))
-        throw InvalidKeyException("pkcs12_derive_key returned error");
+	// the three derivations share the password and salt, and their hash chains run in parallel
+	static const byte ids[3] = { PKCS12_ID_CIPHER, PKCS12_ID_MAC, PKCS12_ID_IV };
 
-	if (pkcs12_derive_key(&sha256, PKCS12_ID_MAC, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, _mac_key, 32))
-        throw InvalidKeyException("pkcs12_derive_key returned error");
+	byte* ndata[3] = { _cipher_key, _mac_key, _iv };
+	size_t nsize[3] = { 32, 32, 16 };
 
-	if (pkcs12_derive_key(&sha256, PKCS12_ID_IV, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, _iv, 16))
-        throw InvalidKeyException("pkcs12_derive_key returned error");
+	if (pkcs12_derive_keys(&sha256, ids, 3, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, ndata, nsize))
+        throw InvalidKeyException("pkcs12_derive_keys returned error");
 }
 
 KeyProtector::~KeyProtector() throw ()
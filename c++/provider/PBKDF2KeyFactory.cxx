@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/pkcs5.h"
+#include "beecrypt/c++/crypto/spec/PBEKeySpec.h"
+using beecrypt::crypto::spec::PBEKeySpec;
+#include "beecrypt/c++/crypto/spec/SecretKeySpec.h"
+using beecrypt::crypto::spec::SecretKeySpec;
+#include "beecrypt/c++/provider/PBKDF2KeyFactory.h"
+
+using namespace beecrypt::provider;
+
+namespace {
+	/* converts the UTF-16 password to UTF-8; an unpaired surrogate is
+	 * encoded as if it were a character by itself */
+	void encode(bytearray& result, const array<jchar>& password)
+	{
+		int i, n = 0;
+
+		result.resize(password.size() * 3);
+
+		for (i = 0; i < password.size(); i++)
+		{
+			unsigned int c = password[i];
+
+			if (c >= 0xd800 && c < 0xdc00 && i+1 < password.size() && password[i+1] >= 0xdc00 && password[i+1] < 0xe000)
+				c = 0x10000 + ((c - 0xd800) << 10) + (password[++i] - 0xdc00);
+
+			if (c < 0x80)
+				result[n++] = (byte) c;
+			else if (c < 0x800)
+			{
+				result[n++] = (byte) (0xc0 | (c >> 6));
+				result[n++] = (byte) (0x80 | (c & 0x3f));
+			}
+			else if (c < 0x10000)
+			{
+				result[n++] = (byte) (0xe0 | (c >> 12));
+				result[n++] = (byte) (0x80 | ((c >> 6) & 0x3f));
+				result[n++] = (byte) (0x80 | (c & 0x3f));
+			}
+			else
+			{
+				result[n++] = (byte) (0xf0 | (c >> 18));
+				result[n++] = (byte) (0x80 | ((c >> 12) & 0x3f));
+				result[n++] = (byte) (0x80 | ((c >> 6) & 0x3f));
+				result[n++] = (byte) (0x80 | (c & 0x3f));
+			}
+		}
+
+		result.resize(n);
+	}
+}
+
+PBKDF2KeyFactory::PBKDF2KeyFactory(const hashFunction& hash, const String& algorithm) : _hf(&hash), _algo(algorithm)
+{
+}
+
+SecretKey* PBKDF2KeyFactory::engineGenerateSecret(const KeySpec& spec) throw (InvalidKeySpecException)
+{
+	const PBEKeySpec* pbe = dynamic_cast<const PBEKeySpec*>(&spec);
+	if (pbe)
+	{
+		const bytearray* salt = pbe->getSalt();
+
+		if (!salt)
+			throw InvalidKeySpecException("PBEKeySpec has no salt");
+		if (pbe->getIterationCount() == 0)
+			throw InvalidKeySpecException("PBEKeySpec has no iteration count");
+		if (pbe->getKeyLength() == 0 || (pbe->getKeyLength() & 7))
+			throw InvalidKeySpecException("PBEKeySpec key length must be a positive multiple of 8 bits");
+
+		bytearray pswd, key(pbe->getKeyLength() >> 3);
+
+		encode(pswd, pbe->getPassword());
+
+		int rc = pkcs5_pbkdf2(_hf, pswd.data(), pswd.size(), salt->data(), salt->size(), pbe->getIterationCount(), key.data(), key.size());
+
+		memset(pswd.data(), 0, pswd.size());
+
+		if (rc)
+			throw InvalidKeySpecException("pkcs5_pbkdf2 returned error");
+
+		SecretKey* result = new SecretKeySpec(key, _algo);
+
+		memset(key.data(), 0, key.size());
+
+		return result;
+	}
+	throw InvalidKeySpecException("Expected a PBEKeySpec");
+}
+
+KeySpec* PBKDF2KeyFactory::engineGetKeySpec(const SecretKey& key, const type_info& info) throw (InvalidKeySpecException)
+{
+	if (key.getAlgorithm().equals(_algo) && key.getEncoded())
+	{
+		if (info == typeid(KeySpec) || info == typeid(SecretKeySpec))
+		{
+			return new SecretKeySpec(*key.getEncoded(), _algo);
+		}
+		throw InvalidKeySpecException("Unsupported KeySpec type");
+	}
+	throw InvalidKeySpecException("Unsupported SecretKey type");
+}
+
+SecretKey* PBKDF2KeyFactory::engineTranslateKey(const SecretKey& key) throw (InvalidKeyException)
+{
+	if (key.getAlgorithm().equals(_algo) && key.getEncoded())
+	{
+		return new SecretKeySpec(*key.getEncoded(), _algo);
+	}
+	throw InvalidKeyException("Unsupported SecretKey type");
+}
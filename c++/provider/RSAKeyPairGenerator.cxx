@@ -22,6 +22,7 @@
 
 #include "beecrypt/c++/adapter.h"
 using beecrypt::randomGeneratorContextAdapter;
+#include "beecrypt/c++/provider/GeneratorThreads.h"
 #include "beecrypt/c++/provider/RSAKeyPairGenerator.h"
 #include "beecrypt/c++/provider/RSAPublicKeyImpl.h"
 #include "beecrypt/c++/provider/RSAPrivateCrtKeyImpl.h"
@@ -37,6 +38,8 @@ RSAKeyPairGenerator::RSAKeyPairGenerator()
 	_size = 1024;
 	_e = RSAKeyGenParameterSpec::F4;
 	_srng = 0;
+	// check value of property rsa.keygen.threads in beecrypt.conf; 0 means one per processor
+	_threads = generatorThreads("rsa.keygen.threads");
 }
 
 KeyPair* RSAKeyPairGenerator::genpair(randomGeneratorContext* rngc)
@@ -45,8 +48,8 @@ KeyPair* RSAKeyPairGenerator::genpair(randomGeneratorContext* rngc)
 
 	transform(_pair.e, _e);
 
-	if (rsakpMake(&_pair, rngc, _size ? _size : 1024))
-		throw ProviderException("unexpected error in rsakpMake");
+	if (rsakpMakeThreads(&_pair, rngc, _size ? _size : 1024, _threads))
+		throw ProviderException("unexpected error in rsakpMakeThreads");
 
 	return new KeyPair(new RSAPublicKeyImpl(_pair.n, _pair.e), new RSAPrivateCrtKeyImpl(_pair.n, _pair.e, _pair.d, _pair.p, _pair.q, _pair.dp, _pair.dq, _pair.qi));
 }
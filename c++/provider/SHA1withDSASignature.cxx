@@ -324,13 +324,13 @@ void SHA1withDSASignature::rawsign(mpnumber& r, mpnumber& s) throw (SignatureExc
 	if (_srng)
 	{
 		randomGeneratorContextAdapter rngc(_srng);
-		if (dsasign(&_params.p, &_params.q, &_params.g, &rngc, &hm, &_x, &r, &s))
+		if (dsasign_dp(&_params, &rngc, &hm, &_x, &r, &s))
 			throw SignatureException("internal error in dsasign function");
 	}
 	else
 	{
 		randomGeneratorContext rngc(randomGeneratorDefault());
-		if (dsasign(&_params.p, &_params.q, &_params.g, &rngc, &hm, &_x, &r, &s))
+		if (dsasign_dp(&_params, &rngc, &hm, &_x, &r, &s))
 			throw SignatureException("internal error in dsasign function");
 	}
 }
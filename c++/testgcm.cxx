@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2004 Beeyond Software Holding BV
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/c++/crypto/Cipher.h"
+using beecrypt::crypto::Cipher;
+#include "beecrypt/c++/crypto/spec/GCMParameterSpec.h"
+using beecrypt::crypto::spec::GCMParameterSpec;
+#include "beecrypt/c++/crypto/spec/IvParameterSpec.h"
+using beecrypt::crypto::spec::IvParameterSpec;
+#include "beecrypt/c++/crypto/spec/SecretKeySpec.h"
+using beecrypt::crypto::spec::SecretKeySpec;
+#include "beecrypt/c++/security/InvalidAlgorithmParameterException.h"
+using beecrypt::security::InvalidAlgorithmParameterException;
+
+#include <iostream>
+using namespace std;
+#include <unicode/ustream.h>
+
+int main(int argc, char* argv[])
+{
+	int failures = 0;
+
+	try
+	{
+		bytearray original(1000), k(16), iv(12), other(12);
+
+		SecureRandom::getSeed(original.data(), original.size());
+		SecureRandom::getSeed(k.data(), k.size());
+		SecureRandom::getSeed(iv.data(), iv.size());
+
+		other = iv;
+		other[0] ^= 1;
+
+		SecretKeySpec key(k, "AES");
+
+		Cipher* c = Cipher::getInstance("AES/GCM/NoPadding");
+
+		c->init(Cipher::ENCRYPT_MODE, key, GCMParameterSpec(128, iv));
+
+		bytearray* ciphertext = c->doFinal(original);
+
+		// encrypting again with the same key and IV must be refused
+		try
+		{
+			c->init(Cipher::ENCRYPT_MODE, key, GCMParameterSpec(128, iv));
+			cerr << "GCM accepted the same key and IV twice" << endl;
+			failures++;
+		}
+		catch (InvalidAlgorithmParameterException&)
+		{
+		}
+
+		try
+		{
+			c->init(Cipher::ENCRYPT_MODE, key, IvParameterSpec(iv));
+			cerr << "GCM accepted the same key and IV twice through an IvParameterSpec" << endl;
+			failures++;
+		}
+		catch (InvalidAlgorithmParameterException&)
+		{
+		}
+
+		// decryption with the same pair is fine
+		c->init(Cipher::DECRYPT_MODE, key, GCMParameterSpec(128, iv));
+
+		bytearray* cleartext = c->doFinal(*ciphertext);
+
+		if (!cleartext || original != *cleartext)
+		{
+			cerr << "GCM decryption failed" << endl;
+			failures++;
+		}
+
+		// and so is encryption with a different IV
+		c->init(Cipher::ENCRYPT_MODE, key, GCMParameterSpec(128, other));
+
+		delete cleartext;
+		delete ciphertext;
+		delete c;
+	}
+	catch (Exception& ex)
+	{
+		cerr << "Exception: " << *ex.getMessage() << endl;
+		failures++;
+	}
+	catch (...)
+	{
+		cerr << "exception" << endl;
+		failures++;
+	}
+
+	return failures;
+}
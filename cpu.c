@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file cpu.c
+ * \brief Runtime detection of processor features.
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/cpu.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+# include <cpuid.h>
+# define CPU_X86_GNUC 1
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+# define CPU_X86_MSC 1
+#endif
+
+/* the detected features; -1 until detection has run */
+static int cpudetected = -1;
+
+/* the enabled features; also read directly, PC-relative, by the assembler
+ * routines in mpopt, so it mustn't be preempted from outside the library */
+#if defined(__GNUC__) && (__GNUC__ >= 4) && (defined(__ELF__) || defined(__APPLE__))
+__attribute__((visibility("hidden")))
+#endif
+unsigned int beecrypt_cpufeatures = 0;
+
+#if CPU_X86_GNUC || CPU_X86_MSC
+static void cpux86(unsigned int leaf, unsigned int subleaf, unsigned int* regs)
+{
+	#if CPU_X86_GNUC
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+	#else
+	__cpuidex((int*) regs, (int) leaf, (int) subleaf);
+	#endif
+}
+
+static unsigned int cpux86xcr0()
+{
+	#if CPU_X86_GNUC
+	unsigned int lo, hi;
+
+	/* xgetbv, encoded for assemblers which don't know the mnemonic */
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (lo), "=d" (hi) : "c" (0));
+
+	return lo;
+	#else
+	return (unsigned int) _xgetbv(0);
+	#endif
+}
+
+static unsigned int cpux86detect()
+{
+	unsigned int regs[4], max, xcr0 = 0, rc = 0;
+
+	cpux86(0, 0, regs);
+	max = regs[0];
+
+	if (max < 1)
+		return 0;
+
+	cpux86(1, 0, regs);
+
+	if (regs[3] & (1U << 26))
+		rc |= CPUF_X86_SSE2;
+	if (regs[2] & (1U << 9))
+		rc |= CPUF_X86_SSSE3;
+	if (regs[2] & (1U << 19))
+		rc |= CPUF_X86_SSE41;
+	if (regs[2] & (1U << 25))
+		rc |= CPUF_X86_AESNI;
+	if (regs[2] & (1U << 1))
+		rc |= CPUF_X86_PCLMUL;
+
+	/* the AVX register state must also be enabled by the operating system */
+	if (regs[2] & (1U << 27))
+		xcr0 = cpux86xcr0();
+
+	if ((regs[2] & (1U << 28)) && (xcr0 & 0x06) == 0x06)
+		rc |= CPUF_X86_AVX;
+
+	if (max >= 7)
+	{
+		cpux86(7, 0, regs);
+
+		if ((rc & CPUF_X86_AVX) && (regs[1] & (1U << 5)))
+			rc |= CPUF_X86_AVX2;
+		if (regs[1] & (1U << 8))
+			rc |= CPUF_X86_BMI2;
+		if (regs[1] & (1U << 19))
+			rc |= CPUF_X86_ADX;
+		if (regs[1] & (1U << 29))
+			rc |= CPUF_X86_SHA;
+
+		/* AVX-512 needs the opmask and upper ZMM state as well */
+		if ((rc & CPUF_X86_AVX) && (xcr0 & 0xe0) == 0xe0)
+		{
+			if (regs[1] & (1U << 16))
+				rc |= CPUF_X86_AVX512F;
+			if ((rc & CPUF_X86_AVX512F) && (regs[1] & (1U << 31)))
+				rc |= CPUF_X86_AVX512VL;
+			if ((rc & CPUF_X86_AVX512F) && (regs[1] & (1U << 21)))
+				rc |= CPUF_X86_AVX512IFMA;
+		}
+	}
+
+	return rc;
+}
+#endif
+
+static void cpuinit()
+{
+	if (cpudetected < 0)
+	{
+		#if CPU_X86_GNUC || CPU_X86_MSC
+		cpudetected = (int) cpux86detect();
+		#else
+		cpudetected = 0;
+		#endif
+		beecrypt_cpufeatures = (unsigned int) cpudetected;
+	}
+}
+
+#if defined(__GNUC__)
+/* make sure the assembler routines see the features before the first call */
+static void cpuconstructor(void) __attribute__((constructor));
+
+static void cpuconstructor(void)
+{
+	cpuinit();
+}
+#endif
+
+unsigned int cpuFeatures()
+{
+	cpuinit();
+
+	return beecrypt_cpufeatures;
+}
+
+unsigned int cpuFeaturesMask(unsigned int mask)
+{
+	cpuinit();
+
+	beecrypt_cpufeatures = ((unsigned int) cpudetected) & mask;
+
+	return beecrypt_cpufeatures;
+}
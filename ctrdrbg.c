@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file ctrdrbg.c
+ * \brief CTR_DRBG pseudo-random number generator with AES-256.
+ *
+ * Implements the CTR_DRBG of NIST SP 800-90A, with the block cipher
+ * derivation function. Output is produced CTRDRBG_BLOCKS blocks at a time
+ * through the cipher's multi-block function, which pipelines them when the
+ * processor supports AES-NI.
+ *
+ * \ingroup PRNG_m PRNG_ctrdrbg_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/ctrdrbg.h"
+
+/*!\addtogroup PRNG_ctrdrbg_m
+ * \{
+ */
+
+/* the number of blocks generated at a time */
+#define CTRDRBG_BLOCKS	64
+
+const randomGenerator ctrdrbg = {
+	"AES-CTR-DRBG",
+	sizeof(ctrdrbgParam),
+	(randomGeneratorSetup) ctrdrbgSetup,
+	(randomGeneratorSeed) ctrdrbgSeed,
+	(randomGeneratorNext) ctrdrbgNext,
+	(randomGeneratorCleanup) ctrdrbgCleanup
+};
+
+static const byte ctrdrbgdfkey[32] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static int ctrdrbglock(ctrdrbgParam* dp)
+{
+	#ifdef _REENTRANT
+	# if WIN32
+	if (WaitForSingleObject(dp->lock, INFINITE) != WAIT_OBJECT_0)
+		return -1;
+	# else
+	#  if HAVE_THREAD_H && HAVE_SYNCH_H
+	if (mutex_lock(&dp->lock))
+		return -1;
+	#  elif HAVE_PTHREAD_H
+	if (pthread_mutex_lock(&dp->lock))
+		return -1;
+	#  endif
+	# endif
+	#endif
+	return 0;
+}
+
+static int ctrdrbgunlock(ctrdrbgParam* dp)
+{
+	#ifdef _REENTRANT
+	# if WIN32
+	if (!ReleaseMutex(dp->lock))
+		return -1;
+	# else
+	#  if HAVE_THREAD_H && HAVE_SYNCH_H
+	if (mutex_unlock(&dp->lock))
+		return -1;
+	#  elif HAVE_PTHREAD_H
+	if (pthread_mutex_unlock(&dp->lock))
+		return -1;
+	#  endif
+	# endif
+	#endif
+	return 0;
+}
+
+/*
+ * ctrdrbgbcc
+ *  xors data into the chaining value x, encrypting each time a block is
+ *  complete; off tracks the position within the block
+ */
+static void ctrdrbgbcc(aesParam* ap, uint32_t* x, unsigned int* off, const byte* data, size_t size)
+{
+	byte* xb = (byte*) x;
+
+	while (size--)
+	{
+		xb[(*off)++] ^= *(data++);
+		if (*off == 16)
+		{
+			aesEncrypt(ap, x, x);
+			*off = 0;
+		}
+	}
+}
+
+/*
+ * ctrdrbgdf
+ *  the block cipher derivation function, compressing the input into
+ *  CTRDRBG_SEEDLEN bytes
+ */
+static int ctrdrbgdf(byte* seed, const byte* data, size_t size)
+{
+	aesParam k;
+	uint32_t temp[CTRDRBG_SEEDLEN >> 2], x[4];
+	byte hdr[8], pad = 0x80;
+	unsigned int i, off;
+
+	hdr[0] = (byte) (size >> 24);
+	hdr[1] = (byte) (size >> 16);
+	hdr[2] = (byte) (size >> 8);
+	hdr[3] = (byte) size;
+	hdr[4] = hdr[5] = hdr[6] = 0;
+	hdr[7] = CTRDRBG_SEEDLEN;
+
+	if (aesSetup(&k, ctrdrbgdfkey, 256, ENCRYPT))
+		return -1;
+
+	/* each block of temp is the CBC-MAC of IV || L || N || data || 0x80 */
+	for (i = 0; i < (CTRDRBG_SEEDLEN >> 4); i++)
+	{
+		memset(x, 0, 16);
+		((byte*) x)[3] = (byte) i;
+		aesEncrypt(&k, x, x);
+
+		off = 0;
+		ctrdrbgbcc(&k, x, &off, hdr, 8);
+		ctrdrbgbcc(&k, x, &off, data, size);
+		ctrdrbgbcc(&k, x, &off, &pad, 1);
+		if (off)
+			aesEncrypt(&k, x, x);
+
+		memcpy(temp + 4*i, x, 16);
+	}
+
+	/* temp holds a key and a block, which produce the output */
+	if (aesSetup(&k, (const byte*) temp, 256, ENCRYPT))
+		return -1;
+
+	memcpy(x, temp + 8, 16);
+	for (i = 0; i < (CTRDRBG_SEEDLEN >> 4); i++)
+	{
+		aesEncrypt(&k, x, x);
+		memcpy(seed + 16*i, x, 16);
+	}
+
+	memset(&k, 0, sizeof(k));
+	memset(temp, 0, sizeof(temp));
+	memset(x, 0, sizeof(x));
+
+	return 0;
+}
+
+/*
+ * ctrdrbgkeystream
+ *  encrypts the next n values of V into buf, n at most CTRDRBG_BLOCKS
+ */
+static int ctrdrbgkeystream(ctrdrbgParam* dp, uint32_t* buf, unsigned int n)
+{
+	unsigned int k, i;
+
+	for (k = 0; k < n; k++)
+	{
+		/* increment V, as a 128-bit big-endian number */
+		for (i = 16; i-- && ++dp->v[i] == 0; );
+
+		memcpy(buf + 4*k, dp->v, 16);
+	}
+
+	return aes.raw.encryptn((blockCipherParam*) &dp->aes, buf, buf, n);
+}
+
+/*
+ * ctrdrbgupdate
+ *  replaces key and V with the next CTRDRBG_SEEDLEN bytes of keystream,
+ *  xored with the provided data if any
+ */
+static int ctrdrbgupdate(ctrdrbgParam* dp, const byte* data)
+{
+	uint32_t temp[CTRDRBG_SEEDLEN >> 2];
+	byte* t = (byte*) temp;
+	int rc, i;
+
+	rc = ctrdrbgkeystream(dp, temp, CTRDRBG_SEEDLEN >> 4);
+	if (rc == 0)
+	{
+		if (data)
+			for (i = 0; i < CTRDRBG_SEEDLEN; i++)
+				t[i] ^= data[i];
+
+		rc = aesSetup(&dp->aes, t, 256, ENCRYPT);
+		memcpy(dp->v, t + 32, 16);
+	}
+
+	memset(temp, 0, sizeof(temp));
+
+	return rc;
+}
+
+static int ctrdrbginstantiate(ctrdrbgParam* dp, const byte* data, size_t size)
+{
+	byte seed[CTRDRBG_SEEDLEN];
+	int rc;
+
+	/* key and V start out as zero */
+	memset(seed, 0, sizeof(seed));
+	memset(dp->v, 0, 16);
+	if (aesSetup(&dp->aes, seed, 256, ENCRYPT))
+		return -1;
+
+	rc = ctrdrbgdf(seed, data, size);
+	if (rc == 0)
+		rc = ctrdrbgupdate(dp, seed);
+
+	dp->reseed = 1;
+
+	memset(seed, 0, sizeof(seed));
+
+	return rc;
+}
+
+static int ctrdrbgreseed(ctrdrbgParam* dp, const byte* data, size_t size)
+{
+	byte seed[CTRDRBG_SEEDLEN];
+	int rc;
+
+	rc = ctrdrbgdf(seed, data, size);
+	if (rc == 0)
+		rc = ctrdrbgupdate(dp, seed);
+
+	dp->reseed = 1;
+
+	memset(seed, 0, sizeof(seed));
+
+	return rc;
+}
+
+/*
+ * ctrdrbggenerate
+ *  performs one request; the generator reseeds itself from the entropy
+ *  sources when it reaches the reseed interval
+ */
+static int ctrdrbggenerate(ctrdrbgParam* dp, byte* data, size_t size)
+{
+	uint32_t buf[CTRDRBG_BLOCKS << 2];
+	size_t n;
+
+	if (dp->reseed > CTRDRBG_RESEED_INTERVAL)
+	{
+		byte entropy[CTRDRBG_SEEDLEN - 16];
+		int rc;
+
+		rc = entropyGatherNext(entropy, sizeof(entropy));
+		if (rc == 0)
+			rc = ctrdrbgreseed(dp, entropy, sizeof(entropy));
+
+		memset(entropy, 0, sizeof(entropy));
+
+		if (rc)
+			return -1;
+	}
+
+	while (size)
+	{
+		n = (size < sizeof(buf)) ? size : sizeof(buf);
+
+		/* a partial block uses up its value of V all the same */
+		if (ctrdrbgkeystream(dp, buf, (unsigned int) ((n + 15) >> 4)))
+		{
+			/* the buffer may still hold keystream of earlier chunks */
+			memset(buf, 0, sizeof(buf));
+			return -1;
+		}
+
+		memcpy(data, buf, n);
+
+		data += n;
+		size -= n;
+	}
+
+	memset(buf, 0, sizeof(buf));
+
+	dp->reseed++;
+
+	return ctrdrbgupdate(dp, (const byte*) 0);
+}
+
+int ctrdrbgSetup(ctrdrbgParam* dp)
+{
+	if (dp)
+	{
+		byte seed[CTRDRBG_SEEDLEN];
+		int rc;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!(dp->lock = CreateMutex(NULL, FALSE, NULL)))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_init(&dp->lock, USYNC_THREAD, (void *) 0))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_init(&dp->lock, (pthread_mutexattr_t *) 0))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		/* 32 bytes of entropy input, and a 16-byte nonce */
+		if (entropyGatherNext(seed, sizeof(seed)))
+			return -1;
+
+		rc = ctrdrbginstantiate(dp, seed, sizeof(seed));
+
+		memset(seed, 0, sizeof(seed));
+
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgInstantiate(ctrdrbgParam* dp, const byte* data, size_t size)
+{
+	if (dp && data)
+	{
+		int rc;
+
+		if (ctrdrbglock(dp))
+			return -1;
+
+		rc = ctrdrbginstantiate(dp, data, size);
+
+		if (ctrdrbgunlock(dp))
+			return -1;
+
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgSeed(ctrdrbgParam* dp, const byte* data, size_t size)
+{
+	if (dp)
+	{
+		int rc = 0;
+
+		if (data)
+		{
+			if (ctrdrbglock(dp))
+				return -1;
+
+			rc = ctrdrbgreseed(dp, data, size);
+
+			if (ctrdrbgunlock(dp))
+				return -1;
+		}
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgNext(ctrdrbgParam* dp, byte* data, size_t size)
+{
+	if (dp)
+	{
+		int rc = 0;
+
+		if (ctrdrbglock(dp))
+			return -1;
+
+		while (size && rc == 0)
+		{
+			size_t n = (size < CTRDRBG_MAX_REQUEST) ? size : CTRDRBG_MAX_REQUEST;
+
+			rc = ctrdrbggenerate(dp, data, n);
+
+			data += n;
+			size -= n;
+		}
+
+		if (ctrdrbgunlock(dp))
+			return -1;
+
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgCleanup(ctrdrbgParam* dp)
+{
+	if (dp)
+	{
+		memset(&dp->aes, 0, sizeof(aesParam));
+		memset(dp->v, 0, 16);
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!CloseHandle(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_destroy(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_destroy(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return 0;
+	}
+	return -1;
+}
+
+/*!\}
+ */
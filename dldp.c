@@ -31,6 +31,7 @@
 
 #include "beecrypt/dldp.h"
 #include "beecrypt/mp.h"
+#include "beecrypt/mpmont.h"
 #include "beecrypt/mpprime.h"
 
 /*!\addtogroup DL_m
@@ -71,7 +72,7 @@ int dldp_pPublic(const dldp_p* dp, const mpnumber* x, mpnumber* y)
 	 * Public key y is computed as g^x mod p
 	 */
 
-	mpbnpowmod(&dp->p, &dp->g, x, y);
+	dldp_pgPowMod(dp, x, y);
 
 	return 0;
 }
@@ -83,7 +84,7 @@ int dldp_pPair(const dldp_p* dp, randomGeneratorContext* rgc, mpnumber* x, mpnum
 	 */
 
 	mpbnrnd(&dp->q, rgc, x);
-	mpbnpowmod(&dp->p, &dp->g, x, y);
+	dldp_pgPowMod(dp, x, y);
 
 	return 0;
 }
@@ -92,7 +93,7 @@ int dldp_pPair_s(const dldp_p* dp, randomGeneratorContext* rgc, mpnumber* x, mpn
 {
 	mpbnrnd(&dp->q, rgc, x);
 	mpntrbits(x, xbits);
-	mpbnpowmod(&dp->p, &dp->g, x, y);
+	dldp_pgPowMod(dp, x, y);
 
 	return 0;
 }
@@ -162,6 +163,7 @@ int dldp_pInit(dldp_p* dp)
 	mpnzero(&dp->g);
 	mpnzero(&dp->r);
 	mpbzero(&dp->n);
+	dp->gcomb = (mpmontcomb*) 0;
 
 	return 0;
 }
@@ -173,6 +175,7 @@ int dldp_pFree(dldp_p* dp)
 	mpnfree(&dp->g);
 	mpnfree(&dp->r);
 	mpbfree(&dp->n);
+	dldp_pgCombFree(dp);
 
 	return 0;
 }
@@ -185,6 +188,74 @@ int dldp_pCopy(dldp_p* dst, const dldp_p* src)
 	mpncopy(&dst->g, &src->g);
 	mpbcopy(&dst->n, &src->n);
 
+	if (src->gcomb)
+	{
+		if (dst->gcomb == (mpmontcomb*) 0)
+		{
+			dst->gcomb = (mpmontcomb*) malloc(sizeof(mpmontcomb));
+			if (dst->gcomb == (mpmontcomb*) 0)
+				return -1;
+			mpmontcombzero(dst->gcomb);
+		}
+		if (mpmontcombcopy(dst->gcomb, src->gcomb))
+		{
+			dldp_pgCombFree(dst);
+			return -1;
+		}
+	}
+	else
+		dldp_pgCombFree(dst);
+
+	return 0;
+}
+
+/*
+ * dldp_pgCombMake
+ *  precomputes powers of g for exponents of up to xbits bits;
+ *  if xbits is zero, the size of q is used, which covers the private keys
+ */
+int dldp_pgCombMake(dldp_p* dp, size_t xbits)
+{
+	if (xbits == 0)
+		xbits = mpbits(dp->q.size, dp->q.modl);
+
+	if (dp->gcomb == (mpmontcomb*) 0)
+	{
+		dp->gcomb = (mpmontcomb*) malloc(sizeof(mpmontcomb));
+		if (dp->gcomb == (mpmontcomb*) 0)
+			return -1;
+		mpmontcombzero(dp->gcomb);
+	}
+
+	if (mpmontcombset(dp->gcomb, &dp->p, dp->g.size, dp->g.data, xbits))
+	{
+		dldp_pgCombFree(dp);
+		return -1;
+	}
+
+	return 0;
+}
+
+int dldp_pgCombFree(dldp_p* dp)
+{
+	if (dp->gcomb)
+	{
+		mpmontcombfree(dp->gcomb);
+		free(dp->gcomb);
+		dp->gcomb = (mpmontcomb*) 0;
+	}
+
+	return 0;
+}
+
+/*
+ * dldp_pgPowMod
+ *  computes y = g^x mod p, using the precomputed powers of g if available
+ */
+int dldp_pgPowMod(const dldp_p* dp, const mpnumber* x, mpnumber* y)
+{
+	mpmontcombbnpowmod(dp->gcomb, &dp->p, &dp->g, x, y);
+
 	return 0;
 }
 
@@ -221,10 +292,16 @@ int dldp_pgoqMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t
 }
 
 int dldp_pgoqMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t bits)
+{
+	return dldp_pgoqMakeSafeThreads(dp, rgc, bits, 1);
+}
+
+int dldp_pgoqMakeSafeThreads(dldp_p* dp, randomGeneratorContext* rgc, size_t bits, int threads)
 {
 	/*
 	 * Generate parameters with a safe prime; p = 2q+1 i.e. r=2
 	 *
+	 * The search for p runs on the given number of threads
 	 */
 
 	register size_t size = MP_BITS_TO_WORDS(bits + MP_WBITS - 1);
@@ -233,7 +310,11 @@ int dldp_pgoqMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t bits)
 	if (temp)
 	{
 		/* generate p */
-		mpprndsafe_w(&dp->p, rgc, bits, mpptrials(bits), temp);
+		if (mpprndsafethreads(&dp->p, rgc, bits, mpptrials(bits), threads))
+		{
+			free(temp);
+			return -1;
+		}
 
 		/* set q */
 		mpcopy(size, temp, dp->p.modl);
@@ -345,9 +426,16 @@ int dldp_pgonMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t
 }
 
 int dldp_pgonMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits)
+{
+	return dldp_pgonMakeSafeThreads(dp, rgc, pbits, 1);
+}
+
+int dldp_pgonMakeSafeThreads(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, int threads)
 {
 	/*
 	 * Generate parameters with a safe prime; i.e. p = 2q+1, where q is prime
+	 *
+	 * The search for p runs on the given number of threads
 	 */
 
 	register size_t psize = MP_BITS_TO_WORDS(pbits + MP_WBITS - 1);
@@ -356,7 +444,11 @@ int dldp_pgonMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits)
 	if (temp)
 	{
 		/* generate safe p */
-		mpprndsafe_w(&dp->p, rgc, pbits, mpptrials(pbits), temp);
+		if (mpprndsafethreads(&dp->p, rgc, pbits, mpptrials(pbits), threads))
+		{
+			free(temp);
+			return -1;
+		}
 
 		/* set n */
 		mpbsubone(&dp->p, temp);
@@ -34,6 +34,7 @@
 #endif
 
 #include "beecrypt/dlsvdp-dh.h"
+#include "beecrypt/mpmont.h"
 
 /*!\addtogroup DL_dh_m
  * \{
@@ -56,7 +57,7 @@
  */
 int dlsvdp_pDHSecret(const dhparam* dp, const mpnumber* x, const mpnumber* y, mpnumber* s)
 {
-	mpbnpowmod(&dp->p, y, x, s);
+	mpmontbnpowmod(&dp->p, y, x, s);
 
 	return 0;
 }
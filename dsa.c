@@ -30,31 +30,24 @@
 
 #include "beecrypt/dsa.h"
 #include "beecrypt/dldp.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/mpwksp.h"
 
-int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+/*
+ * dsasign_comb
+ *  computes the signature; g^k is computed with the comb table, if present and valid for p and g
+ */
+static int dsasign_comb(const mpmontcomb* gcomb, const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
 {
 	register size_t psize = p->size;
 	register size_t qsize = q->size;
 
-	register mpw* ptemp;
-	register mpw* qtemp;
+	register mpw* ptemp = wksp;
+	register mpw* qtemp = wksp+5*psize+2;
 
 	register mpw* pwksp;
 	register mpw* qwksp;
 
-	register int rc = -1;
-
-	ptemp = (mpw*) malloc((5*psize+2)*sizeof(mpw));
-	if (ptemp == (mpw*) 0)
-		return rc;
-
-	qtemp = (mpw*) malloc((9*qsize+6)*sizeof(mpw));
-	if (qtemp == (mpw*) 0)
-	{
-		free(ptemp);
-		return rc;
-	}
-
 	pwksp = ptemp+psize;
 	qwksp = qtemp+3*qsize;
 
@@ -66,7 +59,7 @@ int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGen
 	mpbrndinv_w(q, rgc, qtemp, qtemp+qsize, qwksp);
 
 	/* g^k mod p */
-	mpbpowmod_w(p, g->size, g->data, qsize, qtemp, ptemp, pwksp);
+	mpmontcombbpowmod_w(gcomb, p, g->size, g->data, qsize, qtemp, ptemp, pwksp);
 
 	/* (g^k mod p) mod q - simple modulo */
 	mpmod(qtemp+2*qsize, psize, ptemp, qsize, q->modl, pwksp);
@@ -85,21 +78,69 @@ int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGen
 	/* multiply inv(k) mod q */
 	mpbmulmod_w(q, qsize, qtemp+qsize, qsize, qtemp+2*qsize, s->data, qwksp);
 
-	rc = 0;
+	return 0;
+}
+
+int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register mpw* temp;
+	register int rc;
+
+	temp = mpwkspget(DSASIGN_WKSP(p->size, q->size));
+	if (temp == (mpw*) 0)
+		return -1;
+
+	rc = dsasign_comb((const mpmontcomb*) 0, p, q, g, rgc, hm, x, r, s, temp);
+
+	mpwkspput(temp);
+
+	return rc;
+}
+
+int dsasign_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+{
+	return dsasign_comb((const mpmontcomb*) 0, p, q, g, rgc, hm, x, r, s, wksp);
+}
+
+int dsasign_dp(const dsaparam* dp, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register mpw* temp;
+	register int rc;
+
+	temp = mpwkspget(DSASIGN_WKSP(dp->p.size, dp->q.size));
+	if (temp == (mpw*) 0)
+		return -1;
+
+	rc = dsasign_comb(dp->gcomb, &dp->p, &dp->q, &dp->g, rgc, hm, x, r, s, temp);
 
-	free(qtemp);
-	free(ptemp);
+	mpwkspput(temp);
 
 	return rc;
 }
 
 int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+{
+	register mpw* temp;
+	register int rc;
+
+	temp = mpwkspget(DSAVRFY_WKSP(p->size, q->size));
+	if (temp == (mpw*) 0)
+		return 0;
+
+	rc = dsavrfy_w(p, q, g, hm, y, r, s, temp);
+
+	mpwkspput(temp);
+
+	return rc;
+}
+
+int dsavrfy_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
 {
 	register size_t psize = p->size;
 	register size_t qsize = q->size;
 
-	register mpw* ptemp;
-	register mpw* qtemp;
+	register mpw* ptemp = wksp;
+	register mpw* qtemp = wksp+6*psize+2;
 
 	register mpw* pwksp;
 	register mpw* qwksp;
@@ -124,17 +165,6 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 	if (mpgex(s->size, s->data, qsize, q->modl))
 		return rc;
 
-	ptemp = (mpw*) malloc((6*psize+2)*sizeof(mpw));
-	if (ptemp == (mpw*) 0)
-		return rc;
-
-	qtemp = (mpw*) malloc((8*qsize+6)*sizeof(mpw));
-	if (qtemp == (mpw*) 0)
-	{
-		free(ptemp);
-		return rc;
-	}
-
 	pwksp = ptemp+2*psize;
 	qwksp = qtemp+2*qsize;
 
@@ -149,14 +179,8 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 		/* compute u2 = r*w mod q */
 		mpbmulmod_w(q, r->size, r->data, qsize, qtemp, qtemp, qwksp);
 
-		/* compute g^u1 mod p */
-		mpbpowmod_w(p, g->size, g->data, qsize, qtemp+qsize, ptemp, pwksp);
-
-		/* compute y^u2 mod p */
-		mpbpowmod_w(p, y->size, y->data, qsize, qtemp, ptemp+psize, pwksp);
-
-		/* multiply mod p */
-		mpbmulmod_w(p, psize, ptemp, psize, ptemp+psize, ptemp, pwksp);
+		/* compute g^u1 * y^u2 mod p */
+		mpmontbpowmod2_w(p, g->size, g->data, qsize, qtemp+qsize, y->size, y->data, qsize, qtemp, ptemp, pwksp);
 
 		/* modulo q */
 		mpmod(ptemp+psize, psize, ptemp, qsize, q->modl, pwksp);
@@ -164,9 +188,6 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 		rc = mpeqx(r->size, r->data, psize, ptemp+psize);
 	}
 
-	free(qtemp);
-	free(ptemp);
-
 	return rc;
 }
 
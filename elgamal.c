@@ -30,8 +30,13 @@
 
 #include "beecrypt/elgamal.h"
 #include "beecrypt/dldp.h"
+#include "beecrypt/mpmont.h"
 
-int elgv1sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+/*
+ * elgv1sign_comb
+ *  computes the signature; g^k is computed with the comb table, if present and valid for p and g
+ */
+static int elgv1sign_comb(const mpmontcomb* gcomb, const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
 {
 	register size_t size = p->size;
 	register mpw* temp = (mpw*) malloc((8*size+6)*sizeof(mpw));
@@ -44,7 +49,7 @@ int elgv1sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomG
 		/* compute r = g^k mod p */
 		mpnfree(r);
 		mpnsize(r, size);
-		mpbpowmod_w(p, g->size, g->data, size, temp, r->data, temp+2*size);
+		mpmontcombbpowmod_w(gcomb, p, g->size, g->data, size, temp, r->data, temp+2*size);
 
 		/* compute x*r mod n */
 		mpbmulmod_w(n, x->size, x->data, r->size, r->data, temp, temp+2*size);
@@ -68,6 +73,16 @@ int elgv1sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomG
 	return -1;
 }
 
+int elgv1sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	return elgv1sign_comb((const mpmontcomb*) 0, p, n, g, rgc, hm, x, r, s);
+}
+
+int elgv1sign_dp(const dldp_p* dp, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	return elgv1sign_comb(dp->gcomb, &dp->p, &dp->n, &dp->g, rgc, hm, x, r, s);
+}
+
 int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
 {
 	register size_t size = p->size;
@@ -91,14 +106,8 @@ int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 	{
 		register int rc;
 
-		/* compute u1 = y^r mod p */
-		mpbpowmod_w(p, y->size, y->data, r->size, r->data, temp, temp+2*size);
-
-		/* compute u2 = r^s mod p */
-		mpbpowmod_w(p, r->size, r->data, s->size, s->data, temp+size, temp+2*size);
-
-		/* compute v1 = u1*u2 mod p */
-		mpbmulmod_w(p, size, temp, size, temp+size, temp+size, temp+2*size);
+		/* compute v1 = y^r * r^s mod p */
+		mpbpowmod2_w(p, y->size, y->data, r->size, r->data, r->size, r->data, s->size, s->data, temp+size, temp+2*size);
 
 		/* compute v2 = g^h(m) mod p */
 		mpbpowmod_w(p, g->size, g->data, hm->size, hm->data, temp, temp+2*size);
@@ -112,7 +121,11 @@ int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 	return 0;
 }
 
-int elgv3sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+/*
+ * elgv3sign_comb
+ *  computes the signature; g^k is computed with the comb table, if present and valid for p and g
+ */
+static int elgv3sign_comb(const mpmontcomb* gcomb, const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
 {
 	register size_t size = p->size;
 	register mpw* temp = (mpw*) malloc((6*size+2)*sizeof(mpw));
@@ -125,7 +138,7 @@ int elgv3sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomG
 		/* compute r = g^k mod p */
 		mpnfree(r);
 		mpnsize(r, size);
-		mpbpowmod_w(p, g->size, g->data, size, temp, r->data, temp+2*size);
+		mpmontcombbpowmod_w(gcomb, p, g->size, g->data, size, temp, r->data, temp+2*size);
 
 		/* compute u1 = x*r mod n */
 		mpbmulmod_w(n, x->size, x->data, size, r->data, temp+size, temp+2*size);
@@ -145,6 +158,16 @@ int elgv3sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomG
 	return -1;
 }
 
+int elgv3sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	return elgv3sign_comb((const mpmontcomb*) 0, p, n, g, rgc, hm, x, r, s);
+}
+
+int elgv3sign_dp(const dldp_p* dp, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	return elgv3sign_comb(dp->gcomb, &dp->p, &dp->n, &dp->g, rgc, hm, x, r, s);
+}
+
 int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
 {
 	register size_t size = p->size;
@@ -168,14 +191,8 @@ int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 	{
 		register int rc;
 
-		/* compute u1 = y^r mod p */
-		mpbpowmod_w(p, y->size, y->data, r->size, r->data, temp, temp+2*size);
-
-		/* compute u2 = r^h(m) mod p */
-		mpbpowmod_w(p, r->size, r->data, hm->size, hm->data, temp+size, temp+2*size);
-
-		/* compute v2 = u1*u2 mod p */
-		mpbmulmod_w(p, size, temp, size, temp+size, temp+size, temp+2*size);
+		/* compute v2 = y^r * r^h(m) mod p */
+		mpbpowmod2_w(p, y->size, y->data, r->size, r->data, r->size, r->data, hm->size, hm->data, temp+size, temp+2*size);
 
 		/* compute v1 = g^s mod p */
 		mpbpowmod_w(p, g->size, g->data, s->size, s->data, temp, temp+2*size);
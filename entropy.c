@@ -19,7 +19,7 @@
 
 /*!\file entropy.c
  * \author Bob Deblier <bob.deblier@telenet.be>
- * \ingroup ES_m ES_audio_m ES_dsp_m ES_random_m ES_urandom_m ES_tty_m
+ * \ingroup ES_m ES_audio_m ES_dsp_m ES_getrandom_m ES_random_m ES_urandom_m ES_tty_m
  */
 
 #define BEECRYPT_DLL_EXPORT
@@ -28,6 +28,7 @@
 # include "config.h"
 #endif
 
+#include "beecrypt/entropysys.h"
 #include "beecrypt/entropy.h"
 #include "beecrypt/endianness.h"
 
@@ -1378,6 +1379,48 @@ dev_urandom_end:
 }
 #endif
 
+#if HAVE_SYS_GETRANDOM
+/* set once the kernel turns out not to implement the system call */
+static volatile int getrandom_missing = 0;
+
+/*!\ingroup ES_getrandom_m
+ */
+int entropy_getrandom(byte* data, size_t size)
+{
+	if (!getrandom_missing)
+	{
+		/* the system call needs neither a file descriptor nor a lock */
+		while (size)
+		{
+			long rc = syscall(SYS_getrandom, data, size, 0);
+
+			if (rc < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				if (errno != ENOSYS)
+					return -1;
+
+				getrandom_missing = 1;
+				break;
+			}
+
+			data += rc;
+			size -= (size_t) rc;
+		}
+
+		if (size == 0)
+			return 0;
+	}
+
+	#if HAVE_DEV_URANDOM
+	return entropy_dev_urandom(data, size);
+	#else
+	return -1;
+	#endif
+}
+#endif
+
 #if HAVE_DEV_TTY
 /*!\ingroup ES_tty_m
  */
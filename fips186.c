@@ -78,10 +78,33 @@ int fips186Setup(fips186Param* fp)
 	return -1;
 }
 
+int fips186SeedUnlocked(fips186Param* fp, const byte* data, size_t size)
+{
+	if (fp)
+	{
+		if (data)
+		{
+			mpw seed[FIPS186_STATE_SIZE];
+
+			/* if there's too much data, cut off at what we can deal with */
+			if (size > MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE))
+				size = MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE);
+
+			/* convert to multi-precision integer, and add to the state */
+			if (os2ip(seed, FIPS186_STATE_SIZE, data, size) == 0)
+				mpadd(FIPS186_STATE_SIZE, fp->state, seed);
+		}
+		return 0;
+	}
+	return -1;
+}
+
 int fips186Seed(fips186Param* fp, const byte* data, size_t size)
 {
 	if (fp)
 	{
+		int rc;
+
 		#ifdef _REENTRANT
 		# if WIN32
 		if (WaitForSingleObject(fp->lock, INFINITE) != WAIT_OBJECT_0)
@@ -96,18 +119,9 @@ int fips186Seed(fips186Param* fp, const byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		if (data)
-		{
-			mpw seed[FIPS186_STATE_SIZE];
 
-			/* if there's too much data, cut off at what we can deal with */
-			if (size > MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE))
-				size = MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE);
+		rc = fips186SeedUnlocked(fp, data, size);
 
-			/* convert to multi-precision integer, and add to the state */
-			if (os2ip(seed, FIPS186_STATE_SIZE, data, size) == 0)
-				mpadd(FIPS186_STATE_SIZE, fp->state, seed);
-		}
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(fp->lock))
@@ -122,31 +136,17 @@ int fips186Seed(fips186Param* fp, const byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		return 0;
+		return rc;
 	}
 	return -1;
 }
 
-int fips186Next(fips186Param* fp, byte* data, size_t size)
+int fips186NextUnlocked(fips186Param* fp, byte* data, size_t size)
 {
 	if (fp)
 	{
 		mpw dig[FIPS186_STATE_SIZE];
 
-		#ifdef _REENTRANT
-		# if WIN32
-		if (WaitForSingleObject(fp->lock, INFINITE) != WAIT_OBJECT_0)
-			return -1;
-		# else
-		#  if HAVE_THREAD_H && HAVE_SYNCH_H
-		if (mutex_lock(&fp->lock))
-			return -1;
-		#  elif HAVE_PTHREAD_H
-		if (pthread_mutex_lock(&fp->lock))
-			return -1;
-		#  endif
-		# endif
-		#endif
 
 		while (size > 0)
 		{
@@ -202,6 +202,34 @@ int fips186Next(fips186Param* fp, byte* data, size_t size)
 			size -= copy;
 			data += copy;
 		}
+		return 0;
+	}
+	return -1;
+}
+
+int fips186Next(fips186Param* fp, byte* data, size_t size)
+{
+	if (fp)
+	{
+		int rc;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (WaitForSingleObject(fp->lock, INFINITE) != WAIT_OBJECT_0)
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&fp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_lock(&fp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		rc = fips186NextUnlocked(fp, data, size);
+
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(fp->lock))
@@ -216,7 +244,7 @@ int fips186Next(fips186Param* fp, byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		return 0;
+		return rc;
 	}
 	return -1;
 }
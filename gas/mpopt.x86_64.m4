@@ -170,7 +170,18 @@ LOCAL(mpmultwo_loop):
 C_FUNCTION_END(mpmultwo)
 
 
+dnl  mpsetmul, mpaddmul and mpaddsqrtrc select a mulx/adcx/adox variant at
+dnl  runtime, if beecrypt_cpufeatures (see cpu.c) has both CPUF_X86_BMI2
+dnl  (0x80) and CPUF_X86_ADX (0x100) set; it's hidden, so it's read
+dnl  PC-relative. The adx variants use lea and jrcxz for the loop control,
+dnl  since dec would clobber the overflow flag chain.
+
 C_FUNCTION_BEGIN(mpsetmul)
+	movl SYMNAME(beecrypt_cpufeatures)(%rip),%eax
+	andl `$'0x180,%eax
+	cmpl `$'0x180,%eax
+	je LOCAL(mpsetmul_adx)
+
 	movq %rcx,%r8
 	movq %rdi,%rcx
 	movq %rdx,%rdi
@@ -192,10 +203,46 @@ LOCAL(mpsetmul_loop):
 	movq %rdx,%rax
 
 	ret
+
+LOCAL(mpsetmul_adx):
+	movq %rdx,%r8
+	movq %rcx,%rdx
+	movq %rdi,%rcx
+	xorl %eax,%eax
+
+	testb `$'1,%cl
+	jz LOCAL(mpsetmul_adx_loop)
+
+	mulxq -8(%r8,%rcx,8),%r9,%rax
+	movq %r9,-8(%rsi,%rcx,8)
+	leaq -1(%rcx),%rcx
+	jrcxz LOCAL(mpsetmul_adx_done)
+
+	.align 4
+LOCAL(mpsetmul_adx_loop):
+	mulxq -8(%r8,%rcx,8),%r9,%r10
+	mulxq -16(%r8,%rcx,8),%r11,%rdi
+	adcxq %rax,%r9
+	adcxq %r10,%r11
+	movq %r9,-8(%rsi,%rcx,8)
+	movq %r11,-16(%rsi,%rcx,8)
+	movq %rdi,%rax
+	leaq -2(%rcx),%rcx
+	jrcxz LOCAL(mpsetmul_adx_done)
+	jmp LOCAL(mpsetmul_adx_loop)
+
+LOCAL(mpsetmul_adx_done):
+	adcxq %rcx,%rax
+	ret
 C_FUNCTION_END(mpsetmul)
 
 
 C_FUNCTION_BEGIN(mpaddmul)
+	movl SYMNAME(beecrypt_cpufeatures)(%rip),%eax
+	andl `$'0x180,%eax
+	cmpl `$'0x180,%eax
+	je LOCAL(mpaddmul_adx)
+
 	movq %rcx,%r8
 	movq %rdi,%rcx
 	movq %rdx,%rdi
@@ -218,10 +265,50 @@ LOCAL(mpaddmul_loop):
 
 	movq %rdx,%rax
 	ret
+
+LOCAL(mpaddmul_adx):
+	movq %rdx,%r8
+	movq %rcx,%rdx
+	movq %rdi,%rcx
+	xorl %eax,%eax
+
+	testb `$'1,%cl
+	jz LOCAL(mpaddmul_adx_loop)
+
+	mulxq -8(%r8,%rcx,8),%r9,%rax
+	adoxq -8(%rsi,%rcx,8),%r9
+	movq %r9,-8(%rsi,%rcx,8)
+	leaq -1(%rcx),%rcx
+	jrcxz LOCAL(mpaddmul_adx_done)
+
+	.align 4
+LOCAL(mpaddmul_adx_loop):
+	mulxq -8(%r8,%rcx,8),%r9,%r10
+	mulxq -16(%r8,%rcx,8),%r11,%rdi
+	adcxq %rax,%r9
+	adoxq -8(%rsi,%rcx,8),%r9
+	adcxq %r10,%r11
+	adoxq -16(%rsi,%rcx,8),%r11
+	movq %r9,-8(%rsi,%rcx,8)
+	movq %r11,-16(%rsi,%rcx,8)
+	movq %rdi,%rax
+	leaq -2(%rcx),%rcx
+	jrcxz LOCAL(mpaddmul_adx_done)
+	jmp LOCAL(mpaddmul_adx_loop)
+
+LOCAL(mpaddmul_adx_done):
+	adcxq %rcx,%rax
+	adoxq %rcx,%rax
+	ret
 C_FUNCTION_END(mpaddmul)
 
 
 C_FUNCTION_BEGIN(mpaddsqrtrc)
+	movl SYMNAME(beecrypt_cpufeatures)(%rip),%eax
+	andl `$'0x180,%eax
+	cmpl `$'0x180,%eax
+	je LOCAL(mpaddsqrtrc_adx)
+
 	movq %rdi,%rcx
 	movq %rsi,%rdi
 	movq %rdx,%rsi
@@ -248,4 +335,28 @@ LOCAL(mpaddsqrtrc_loop):
 
 	movq %r8,%rax
 	ret
+
+LOCAL(mpaddsqrtrc_adx):
+	movq %rdx,%r8
+	movq %rdi,%rcx
+	leaq -16(%rsi,%rdi,8),%rsi
+	leaq (%rsi,%rdi,8),%rsi
+	xorl %eax,%eax
+
+	.align 4
+LOCAL(mpaddsqrtrc_adx_loop):
+	movq -8(%r8,%rcx,8),%rdx
+	mulxq %rdx,%r9,%r10
+	adcxq 8(%rsi),%r9
+	adcxq (%rsi),%r10
+	movq %r9,8(%rsi)
+	movq %r10,(%rsi)
+	leaq -16(%rsi),%rsi
+	leaq -1(%rcx),%rcx
+	jrcxz LOCAL(mpaddsqrtrc_adx_done)
+	jmp LOCAL(mpaddsqrtrc_adx_loop)
+
+LOCAL(mpaddsqrtrc_adx_done):
+	adcxq %rcx,%rax
+	ret
 C_FUNCTION_END(mpaddsqrtrc)
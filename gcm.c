@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file gcm.c
+ * \brief Galois/Counter Mode, as specified by NIST SP 800-38D.
+ *
+ * GHASH uses carry-less multiplication if the processor has it, and
+ * otherwise Shoup's method with a table of 16 multiples of H and 4-bit
+ * reduction.
+ *
+ * \ingroup BC_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/gcm.h"
+
+#if (defined(__i386__) || defined(__x86_64__)) && ((defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || defined(__clang__))
+# include <wmmintrin.h>
+# include <tmmintrin.h>
+# include "beecrypt/cpu.h"
+# define GHASH_PCLMUL_AVAILABLE 1
+# define GHASH_PCLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+# define GHASH_PCLMUL_FEATURES (CPUF_X86_PCLMUL | CPUF_X86_SSSE3)
+#endif
+
+/* the maximum text length is 2^39-256 bits */
+#define GCM_MAXTEXT	((((uint64_t) 1) << 36) - 32)
+
+static uint64_t gcmload64(const byte* p)
+{
+	return ((uint64_t) p[0] << 56) | ((uint64_t) p[1] << 48) | ((uint64_t) p[2] << 40) | ((uint64_t) p[3] << 32) |
+		((uint64_t) p[4] << 24) | ((uint64_t) p[5] << 16) | ((uint64_t) p[6] << 8) | ((uint64_t) p[7]);
+}
+
+static void gcmstore64(byte* p, uint64_t x)
+{
+	register int i;
+
+	for (i = 7; i >= 0; i--, x >>= 8)
+		p[i] = (byte) x;
+}
+
+/*
+ * gcmrem4
+ *  the reduction of the four bits shifted out at the low end, in the top sixteen bits
+ */
+static const uint64_t gcmrem4[16] = {
+	((uint64_t) 0x0000) << 48, ((uint64_t) 0x1c20) << 48, ((uint64_t) 0x3840) << 48, ((uint64_t) 0x2460) << 48,
+	((uint64_t) 0x7080) << 48, ((uint64_t) 0x6ca0) << 48, ((uint64_t) 0x48c0) << 48, ((uint64_t) 0x54e0) << 48,
+	((uint64_t) 0xe100) << 48, ((uint64_t) 0xfd20) << 48, ((uint64_t) 0xd940) << 48, ((uint64_t) 0xc560) << 48,
+	((uint64_t) 0x9180) << 48, ((uint64_t) 0x8da0) << 48, ((uint64_t) 0xa9c0) << 48, ((uint64_t) 0xb5e0) << 48
+};
+
+/*
+ * gcmtable
+ *  computes the multiples of H for the 4-bit method; the bits of a nibble
+ *  map to H, H*x, H*x^2 and H*x^3, from the most to the least significant
+ */
+static void gcmtable(gcmContext* ctxt)
+{
+	register uint64_t hi = ctxt->h[0], lo = ctxt->h[1];
+	register int i, j;
+
+	ctxt->htable[0][0] = ctxt->htable[0][1] = 0;
+
+	for (i = 8; i > 0; i >>= 1)
+	{
+		register uint64_t reduce = ((uint64_t) 0xe1 << 56) & (0 - (lo & 1));
+
+		ctxt->htable[i][0] = hi;
+		ctxt->htable[i][1] = lo;
+
+		/* multiply by x */
+		lo = (hi << 63) | (lo >> 1);
+		hi = (hi >> 1) ^ reduce;
+	}
+
+	for (i = 2; i < 16; i <<= 1)
+		for (j = 1; j < i; j++)
+		{
+			ctxt->htable[i+j][0] = ctxt->htable[i][0] ^ ctxt->htable[j][0];
+			ctxt->htable[i+j][1] = ctxt->htable[i][1] ^ ctxt->htable[j][1];
+		}
+}
+
+/*
+ * gcmghash4
+ *  adds nblocks blocks of data into the accumulator, with the 4-bit tables
+ */
+static void gcmghash4(gcmContext* ctxt, const byte* data, size_t nblocks)
+{
+	register uint64_t xhi = ctxt->x[0], xlo = ctxt->x[1];
+
+	while (nblocks--)
+	{
+		register uint64_t zhi, zlo, rem;
+		register int i;
+		byte x[16];
+
+		gcmstore64(x, xhi ^ gcmload64(data));
+		gcmstore64(x+8, xlo ^ gcmload64(data+8));
+
+		zhi = zlo = 0;
+
+		/* from the last nibble to the first; each step multiplies by x^4 */
+		for (i = 15; i >= 0; i--)
+		{
+			register int n;
+
+			n = x[i] & 0xf;
+			if (i != 15)
+			{
+				rem = zlo & 0xf;
+				zlo = (zhi << 60) | (zlo >> 4);
+				zhi = (zhi >> 4) ^ gcmrem4[rem];
+			}
+			zhi ^= ctxt->htable[n][0];
+			zlo ^= ctxt->htable[n][1];
+
+			n = x[i] >> 4;
+			rem = zlo & 0xf;
+			zlo = (zhi << 60) | (zlo >> 4);
+			zhi = (zhi >> 4) ^ gcmrem4[rem];
+			zhi ^= ctxt->htable[n][0];
+			zlo ^= ctxt->htable[n][1];
+		}
+
+		xhi = zhi;
+		xlo = zlo;
+		data += 16;
+	}
+
+	ctxt->x[0] = xhi;
+	ctxt->x[1] = xlo;
+}
+
+#if GHASH_PCLMUL_AVAILABLE
+/*
+ * gcmghashclmul
+ *  adds nblocks blocks of data into the accumulator, with pclmulqdq; the
+ *  operands are byte-reversed, so that the bit-reflected product only needs
+ *  a shift by one bit before the reduction
+ */
+GHASH_PCLMUL_TARGET
+static void gcmghashclmul(gcmContext* ctxt, const byte* data, size_t nblocks)
+{
+	const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i h = _mm_set_epi64x((long long) ctxt->h[0], (long long) ctxt->h[1]);
+	__m128i x = _mm_set_epi64x((long long) ctxt->x[0], (long long) ctxt->x[1]);
+	uint64_t temp[2];
+
+	while (nblocks--)
+	{
+		__m128i lo, mid, hi, t, u;
+
+		x = _mm_xor_si128(x, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) data), swap));
+
+		/* 256-bit carry-less product hi:lo */
+		lo = _mm_clmulepi64_si128(x, h, 0x00);
+		hi = _mm_clmulepi64_si128(x, h, 0x11);
+		mid = _mm_xor_si128(_mm_clmulepi64_si128(x, h, 0x10), _mm_clmulepi64_si128(x, h, 0x01));
+		lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+		hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+		/* shift hi:lo left by one bit */
+		t = _mm_srli_epi32(lo, 31);
+		u = _mm_srli_epi32(hi, 31);
+		lo = _mm_slli_epi32(lo, 1);
+		hi = _mm_slli_epi32(hi, 1);
+		hi = _mm_or_si128(hi, _mm_srli_si128(t, 12));
+		hi = _mm_or_si128(hi, _mm_slli_si128(u, 4));
+		lo = _mm_or_si128(lo, _mm_slli_si128(t, 4));
+
+		/* reduce modulo x^128 + x^7 + x^2 + x + 1 */
+		t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+		u = _mm_srli_si128(t, 4);
+		lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+		t = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+		t = _mm_xor_si128(t, u);
+		lo = _mm_xor_si128(lo, t);
+		x = _mm_xor_si128(hi, lo);
+
+		data += 16;
+	}
+
+	_mm_storeu_si128((__m128i*) temp, x);
+	ctxt->x[0] = temp[1];
+	ctxt->x[1] = temp[0];
+}
+#endif
+
+/*
+ * gcmghash
+ *  adds nblocks blocks of data into the accumulator
+ */
+static void gcmghash(gcmContext* ctxt, const byte* data, size_t nblocks)
+{
+	#if GHASH_PCLMUL_AVAILABLE
+	if ((cpuFeatures() & GHASH_PCLMUL_FEATURES) == GHASH_PCLMUL_FEATURES)
+	{
+		gcmghashclmul(ctxt, data, nblocks);
+		return;
+	}
+	#endif
+
+	gcmghash4(ctxt, data, nblocks);
+}
+
+/*
+ * gcmpad
+ *  hashes the partial block, padded with zeroes
+ */
+static void gcmpad(gcmContext* ctxt, size_t fill)
+{
+	if (fill)
+	{
+		memset(ctxt->partial + fill, 0, 16 - fill);
+		gcmghash(ctxt, ctxt->partial, 1);
+	}
+}
+
+/*
+ * gcmkeystream
+ *  encrypts n counter blocks into ctxt->ks, and increments the counter
+ */
+static void gcmkeystream(gcmContext* ctxt, unsigned int n)
+{
+	const blockCipher* bc = ctxt->cipher->algo;
+	byte* ctr = (byte*) ctxt->ctr;
+	unsigned int k;
+
+	for (k = 0; k < n; k++)
+	{
+		register uint32_t c;
+
+		memcpy(ctxt->ks + 4*k, ctxt->ctr, 16);
+
+		/* increment the last 32 bits, big-endian */
+		c = ((uint32_t) ctr[12] << 24) | ((uint32_t) ctr[13] << 16) | ((uint32_t) ctr[14] << 8) | ctr[15];
+		c++;
+		ctr[12] = (byte) (c >> 24);
+		ctr[13] = (byte) (c >> 16);
+		ctr[14] = (byte) (c >> 8);
+		ctr[15] = (byte) c;
+	}
+
+	if (bc->raw.encryptn)
+		bc->raw.encryptn(ctxt->cipher->param, ctxt->ks, ctxt->ks, n);
+	else
+	{
+		for (k = 0; k < n; k++)
+			bc->raw.encrypt(ctxt->cipher->param, ctxt->ks + 4*k, ctxt->ks + 4*k);
+	}
+}
+
+/*
+ * gcmcrypt
+ *  the ciphertext is hashed: after encryption, or before decryption
+ */
+static int gcmcrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size, int encrypt)
+{
+	register size_t used = (size_t) (ctxt->textlength & 15);
+	register size_t i;
+
+	if (!ctxt->started || size > GCM_MAXTEXT - ctxt->textlength)
+		return -1;
+
+	/* the first text byte ends the AAD */
+	if (ctxt->textlength == 0 && size)
+		gcmpad(ctxt, (size_t) (ctxt->aadlength & 15));
+
+	ctxt->textlength += size;
+
+	/* finish a partial block with the remaining keystream */
+	if (used)
+	{
+		const byte* ks = (const byte*) ctxt->ks;
+
+		while (size && used < 16)
+		{
+			byte c = src[0];
+
+			*(dst++) = *(src++) ^ ks[used];
+			ctxt->partial[used++] = encrypt ? dst[-1] : c;
+			size--;
+		}
+
+		if (used < 16)
+			return 0;
+
+		gcmghash(ctxt, ctxt->partial, 1);
+	}
+
+	while (size >= 16)
+	{
+		register unsigned int n = (size >= 16*GCM_BLOCKS) ? GCM_BLOCKS : (unsigned int) (size >> 4);
+		const byte* ks = (const byte*) ctxt->ks;
+
+		gcmkeystream(ctxt, n);
+
+		if (!encrypt)
+			gcmghash(ctxt, src, n);
+
+		for (i = 0; i < 16*n; i++)
+			dst[i] = src[i] ^ ks[i];
+
+		if (encrypt)
+			gcmghash(ctxt, dst, n);
+
+		dst += 16*n;
+		src += 16*n;
+		size -= 16*n;
+	}
+
+	/* start a partial block */
+	if (size)
+	{
+		const byte* ks = (const byte*) ctxt->ks;
+
+		gcmkeystream(ctxt, 1);
+
+		for (i = 0; i < size; i++)
+		{
+			byte c = src[i];
+
+			dst[i] = c ^ ks[i];
+			ctxt->partial[i] = encrypt ? dst[i] : c;
+		}
+	}
+
+	return 0;
+}
+
+int gcmContextInit(gcmContext* ctxt, blockCipherContext* cipher)
+{
+	uint32_t zero[4];
+	byte h[16];
+
+	if (cipher == (blockCipherContext*) 0 || cipher->algo == (const blockCipher*) 0)
+		return -1;
+
+	if (cipher->algo->blocksize != 16 || cipher->op != ENCRYPT)
+		return -1;
+
+	ctxt->cipher = cipher;
+
+	/* H is the encryption of the zero block */
+	memset(zero, 0, sizeof(zero));
+	if (cipher->algo->raw.encrypt(cipher->param, zero, zero))
+		return -1;
+
+	memcpy(h, zero, 16);
+	ctxt->h[0] = gcmload64(h);
+	ctxt->h[1] = gcmload64(h+8);
+
+	gcmtable(ctxt);
+
+	ctxt->x[0] = ctxt->x[1] = 0;
+	ctxt->aadlength = ctxt->textlength = 0;
+	ctxt->started = 0;
+
+	return 0;
+}
+
+int gcmContextFree(gcmContext* ctxt)
+{
+	memset(ctxt, 0, sizeof(gcmContext));
+
+	return 0;
+}
+
+int gcmContextSetIV(gcmContext* ctxt, const byte* iv, size_t ivlen)
+{
+	byte* ctr = (byte*) ctxt->ctr;
+
+	if (iv == (const byte*) 0 || ivlen == 0)
+		return -1;
+
+	ctxt->x[0] = ctxt->x[1] = 0;
+	ctxt->aadlength = ctxt->textlength = 0;
+
+	if (ivlen == 12)
+	{
+		memcpy(ctr, iv, 12);
+		ctr[12] = ctr[13] = ctr[14] = 0;
+		ctr[15] = 1;
+	}
+	else
+	{
+		byte lengths[16];
+
+		/* J0 = GHASH(IV || padding || [0]64 || [len(IV)]64) */
+		if (ivlen >= 16)
+			gcmghash(ctxt, iv, ivlen >> 4);
+		memcpy(ctxt->partial, iv + (ivlen & ~((size_t) 15)), ivlen & 15);
+		gcmpad(ctxt, ivlen & 15);
+
+		memset(lengths, 0, 8);
+		gcmstore64(lengths+8, ((uint64_t) ivlen) << 3);
+		gcmghash(ctxt, lengths, 1);
+
+		gcmstore64(ctr, ctxt->x[0]);
+		gcmstore64(ctr+8, ctxt->x[1]);
+
+		ctxt->x[0] = ctxt->x[1] = 0;
+	}
+
+	/* the tag is masked with the encryption of J0; the text starts at J0+1 */
+	gcmkeystream(ctxt, 1);
+	memcpy(ctxt->ej0, ctxt->ks, 16);
+
+	ctxt->started = 1;
+
+	return 0;
+}
+
+int gcmContextUpdateAAD(gcmContext* ctxt, const byte* data, size_t size)
+{
+	register size_t fill = (size_t) (ctxt->aadlength & 15);
+
+	if (!ctxt->started || ctxt->textlength)
+		return -1;
+
+	ctxt->aadlength += size;
+
+	if (fill)
+	{
+		register size_t copy = 16 - fill;
+
+		if (copy > size)
+			copy = size;
+
+		memcpy(ctxt->partial + fill, data, copy);
+		data += copy;
+		size -= copy;
+
+		if (fill + copy < 16)
+			return 0;
+
+		gcmghash(ctxt, ctxt->partial, 1);
+	}
+
+	if (size >= 16)
+	{
+		gcmghash(ctxt, data, size >> 4);
+		data += size & ~((size_t) 15);
+		size &= 15;
+	}
+
+	memcpy(ctxt->partial, data, size);
+
+	return 0;
+}
+
+int gcmContextEncrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size)
+{
+	return gcmcrypt(ctxt, dst, src, size, 1);
+}
+
+int gcmContextDecrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size)
+{
+	return gcmcrypt(ctxt, dst, src, size, 0);
+}
+
+/*
+ * gcmtaglen
+ *  checks for one of the tag lengths NIST SP 800-38D allows: 4 or 8 bytes,
+ *  or 12 to 16 bytes
+ */
+static int gcmtaglen(size_t taglen)
+{
+	return taglen == 4 || taglen == 8 || (taglen >= 12 && taglen <= 16);
+}
+
+int gcmContextDigest(gcmContext* ctxt, byte* tag, size_t taglen)
+{
+	byte lengths[16];
+	byte s[16];
+	register size_t i;
+
+	if (!ctxt->started || !gcmtaglen(taglen))
+		return -1;
+
+	if (ctxt->textlength)
+		gcmpad(ctxt, (size_t) (ctxt->textlength & 15));
+	else
+		gcmpad(ctxt, (size_t) (ctxt->aadlength & 15));
+
+	gcmstore64(lengths, ctxt->aadlength << 3);
+	gcmstore64(lengths+8, ctxt->textlength << 3);
+	gcmghash(ctxt, lengths, 1);
+
+	gcmstore64(s, ctxt->x[0]);
+	gcmstore64(s+8, ctxt->x[1]);
+
+	for (i = 0; i < taglen; i++)
+		tag[i] = s[i] ^ ((const byte*) ctxt->ej0)[i];
+
+	/* the message is finished */
+	ctxt->started = 0;
+
+	return 0;
+}
+
+int gcmContextVerify(gcmContext* ctxt, const byte* tag, size_t taglen)
+{
+	byte computed[16];
+	byte diff = 0;
+	register size_t i;
+
+	if (gcmContextDigest(ctxt, computed, taglen))
+		return 0;
+
+	for (i = 0; i < taglen; i++)
+		diff |= computed[i] ^ tag[i];
+
+	return diff == 0;
+}
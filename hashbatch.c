@@ -0,0 +1,901 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file hashbatch.c
+ * \brief Hashing of many independent messages at once.
+ *
+ * For MD5, SHA-1, SHA-224 and SHA-256 the messages are spread over sixteen
+ * lanes of SIMD registers, each lane holding the state of one message; a
+ * lane which finishes its message picks up the next one. With AVX-512 each
+ * operation covers all lanes, with AVX2 two halves of eight lanes.
+ *
+ * When too few lanes would stay busy, or a single message is hashed faster
+ * by the processor's SHA extensions, the messages are hashed one by one.
+ *
+ * \ingroup HASH_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/hmac.h"
+#include "beecrypt/md5.h"
+#include "beecrypt/sha1.h"
+#include "beecrypt/sha224.h"
+#include "beecrypt/sha256.h"
+#include "beecrypt/sha2k32.h"
+#include "beecrypt/shani.h"
+
+#if (defined(__i386__) || defined(__x86_64__)) && ((defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || defined(__clang__))
+# include "beecrypt/cpu.h"
+# define BATCH_AVAILABLE 1
+# define BATCH_AVX512_TARGET __attribute__((target("avx512f,avx2")))
+# define BATCH_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+/*!\addtogroup HASH_m
+ * \{
+ */
+
+#define BATCH_LANES		16
+
+/*
+ * batchSerial
+ *  runs the compression function of a hash over whole blocks
+ */
+typedef void (*batchSerial)(uint32_t* h, const byte* blocks, size_t nblocks);
+
+#if BATCH_AVAILABLE
+/* sixteen 32-bit words, one per lane */
+typedef uint32_t batchvec __attribute__((vector_size(64)));
+
+/*
+ * batchLanes
+ *  runs the compression function over one block in each lane; w holds the
+ *  words of the blocks, and is used for the message schedule
+ */
+typedef void (*batchLanes)(batchvec* st, batchvec* w);
+#endif
+
+typedef struct
+{
+	const hashFunction* hash;
+	unsigned int words;
+	int bigendian;
+	batchSerial serial;
+	#if BATCH_AVAILABLE
+	batchLanes avx512;
+	batchLanes avx2;
+	#endif
+} batchAlgorithm;
+
+static void md5serial(uint32_t* h, const byte* blocks, size_t nblocks)
+{
+	md5Param mp;
+
+	memcpy(mp.h, h, sizeof(mp.h));
+	while (nblocks--)
+	{
+		memcpy(mp.data, blocks, 64);
+		md5Process(&mp);
+		blocks += 64;
+	}
+	memcpy(h, mp.h, sizeof(mp.h));
+}
+
+static void sha1serial(uint32_t* h, const byte* blocks, size_t nblocks)
+{
+	sha1Param sp;
+
+	if (shaniSha1Blocks(h, blocks, nblocks) == 0)
+		return;
+
+	memcpy(sp.h, h, sizeof(sp.h));
+	while (nblocks--)
+	{
+		memcpy(sp.data, blocks, 64);
+		sha1Process(&sp);
+		blocks += 64;
+	}
+	memcpy(h, sp.h, sizeof(sp.h));
+}
+
+static void sha256serial(uint32_t* h, const byte* blocks, size_t nblocks)
+{
+	sha256Param sp;
+
+	if (shaniSha256Blocks(h, blocks, nblocks) == 0)
+		return;
+
+	memcpy(sp.h, h, sizeof(sp.h));
+	while (nblocks--)
+	{
+		memcpy(sp.data, blocks, 64);
+		sha256Process(&sp);
+		blocks += 64;
+	}
+	memcpy(h, sp.h, sizeof(sp.h));
+}
+
+#if BATCH_AVAILABLE
+#define VROTL(x, s) (((x) << (s)) | ((x) >> (32 - (s))))
+#define VROTR(x, s) (((x) >> (s)) | ((x) << (32 - (s))))
+
+/*
+ * batchword
+ *  reads a word in the byte order of the hash
+ */
+static inline __attribute__((always_inline)) uint32_t batchword(const byte* b, int bigendian)
+{
+	if (bigendian)
+		return ((uint32_t) b[0] << 24) | ((uint32_t) b[1] << 16) | ((uint32_t) b[2] << 8) | b[3];
+	else
+		return ((uint32_t) b[3] << 24) | ((uint32_t) b[2] << 16) | ((uint32_t) b[1] << 8) | b[0];
+}
+
+/*
+ * batchload
+ *  gathers the words of the blocks, so that m[i] holds word i of every lane
+ */
+static inline __attribute__((always_inline)) void batchload(batchvec* m, const byte** blocks, int bigendian)
+{
+	register unsigned int i, l;
+
+	for (l = 0; l < BATCH_LANES; l++)
+		for (i = 0; i < 16; i++)
+			m[i][l] = batchword(blocks[l] + 4 * i, bigendian);
+}
+
+#define MD5FF(a, b, c, d, w, s, t)	\
+	a = VROTL(((b&(c^d))^d) + a + w + t, s) + b;
+
+#define MD5GG(a, b, c, d, w, s, t)	\
+	a = VROTL(((d&(b^c))^c) + a + w + t, s) + b;
+
+#define MD5HH(a, b, c, d, w, s, t)	\
+	a = VROTL((b^c^d) + a + w + t, s) + b;
+
+#define MD5II(a, b, c, d, w, s, t)	\
+	a = VROTL((c^(b|~d)) + a + w + t, s) + b;
+
+static inline __attribute__((always_inline)) void md5lanes(batchvec* st, batchvec* w)
+{
+	batchvec a, b, c, d;
+
+	a = st[0]; b = st[1]; c = st[2]; d = st[3];
+
+	MD5FF(a, b, c, d, w[ 0],  7, 0xd76aa478U);
+	MD5FF(d, a, b, c, w[ 1], 12, 0xe8c7b756U);
+	MD5FF(c, d, a, b, w[ 2], 17, 0x242070dbU);
+	MD5FF(b, c, d, a, w[ 3], 22, 0xc1bdceeeU);
+	MD5FF(a, b, c, d, w[ 4],  7, 0xf57c0fafU);
+	MD5FF(d, a, b, c, w[ 5], 12, 0x4787c62aU);
+	MD5FF(c, d, a, b, w[ 6], 17, 0xa8304613U);
+	MD5FF(b, c, d, a, w[ 7], 22, 0xfd469501U);
+	MD5FF(a, b, c, d, w[ 8],  7, 0x698098d8U);
+	MD5FF(d, a, b, c, w[ 9], 12, 0x8b44f7afU);
+	MD5FF(c, d, a, b, w[10], 17, 0xffff5bb1U);
+	MD5FF(b, c, d, a, w[11], 22, 0x895cd7beU);
+	MD5FF(a, b, c, d, w[12],  7, 0x6b901122U);
+	MD5FF(d, a, b, c, w[13], 12, 0xfd987193U);
+	MD5FF(c, d, a, b, w[14], 17, 0xa679438eU);
+	MD5FF(b, c, d, a, w[15], 22, 0x49b40821U);
+
+	MD5GG(a, b, c, d, w[ 1],  5, 0xf61e2562U);
+	MD5GG(d, a, b, c, w[ 6],  9, 0xc040b340U);
+	MD5GG(c, d, a, b, w[11], 14, 0x265e5a51U);
+	MD5GG(b, c, d, a, w[ 0], 20, 0xe9b6c7aaU);
+	MD5GG(a, b, c, d, w[ 5],  5, 0xd62f105dU);
+	MD5GG(d, a, b, c, w[10],  9, 0x02441453U);
+	MD5GG(c, d, a, b, w[15], 14, 0xd8a1e681U);
+	MD5GG(b, c, d, a, w[ 4], 20, 0xe7d3fbc8U);
+	MD5GG(a, b, c, d, w[ 9],  5, 0x21e1cde6U);
+	MD5GG(d, a, b, c, w[14],  9, 0xc33707d6U);
+	MD5GG(c, d, a, b, w[ 3], 14, 0xf4d50d87U);
+	MD5GG(b, c, d, a, w[ 8], 20, 0x455a14edU);
+	MD5GG(a, b, c, d, w[13],  5, 0xa9e3e905U);
+	MD5GG(d, a, b, c, w[ 2],  9, 0xfcefa3f8U);
+	MD5GG(c, d, a, b, w[ 7], 14, 0x676f02d9U);
+	MD5GG(b, c, d, a, w[12], 20, 0x8d2a4c8aU);
+
+	MD5HH(a, b, c, d, w[ 5],  4, 0xfffa3942U);
+	MD5HH(d, a, b, c, w[ 8], 11, 0x8771f681U);
+	MD5HH(c, d, a, b, w[11], 16, 0x6d9d6122U);
+	MD5HH(b, c, d, a, w[14], 23, 0xfde5380cU);
+	MD5HH(a, b, c, d, w[ 1],  4, 0xa4beea44U);
+	MD5HH(d, a, b, c, w[ 4], 11, 0x4bdecfa9U);
+	MD5HH(c, d, a, b, w[ 7], 16, 0xf6bb4b60U);
+	MD5HH(b, c, d, a, w[10], 23, 0xbebfbc70U);
+	MD5HH(a, b, c, d, w[13],  4, 0x289b7ec6U);
+	MD5HH(d, a, b, c, w[ 0], 11, 0xeaa127faU);
+	MD5HH(c, d, a, b, w[ 3], 16, 0xd4ef3085U);
+	MD5HH(b, c, d, a, w[ 6], 23, 0x04881d05U);
+	MD5HH(a, b, c, d, w[ 9],  4, 0xd9d4d039U);
+	MD5HH(d, a, b, c, w[12], 11, 0xe6db99e5U);
+	MD5HH(c, d, a, b, w[15], 16, 0x1fa27cf8U);
+	MD5HH(b, c, d, a, w[ 2], 23, 0xc4ac5665U);
+
+	MD5II(a, b, c, d, w[ 0],  6, 0xf4292244U);
+	MD5II(d, a, b, c, w[ 7], 10, 0x432aff97U);
+	MD5II(c, d, a, b, w[14], 15, 0xab9423a7U);
+	MD5II(b, c, d, a, w[ 5], 21, 0xfc93a039U);
+	MD5II(a, b, c, d, w[12],  6, 0x655b59c3U);
+	MD5II(d, a, b, c, w[ 3], 10, 0x8f0ccc92U);
+	MD5II(c, d, a, b, w[10], 15, 0xffeff47dU);
+	MD5II(b, c, d, a, w[ 1], 21, 0x85845dd1U);
+	MD5II(a, b, c, d, w[ 8],  6, 0x6fa87e4fU);
+	MD5II(d, a, b, c, w[15], 10, 0xfe2ce6e0U);
+	MD5II(c, d, a, b, w[ 6], 15, 0xa3014314U);
+	MD5II(b, c, d, a, w[13], 21, 0x4e0811a1U);
+	MD5II(a, b, c, d, w[ 4],  6, 0xf7537e82U);
+	MD5II(d, a, b, c, w[11], 10, 0xbd3af235U);
+	MD5II(c, d, a, b, w[ 2], 15, 0x2ad7d2bbU);
+	MD5II(b, c, d, a, w[ 9], 21, 0xeb86d391U);
+
+	st[0] += a; st[1] += b; st[2] += c; st[3] += d;
+}
+
+/* the message schedule of SHA-1, in a ring of sixteen words */
+#define SHA1W(i) \
+	(w[(i)&15] = VROTL(w[((i)-3)&15] ^ w[((i)-8)&15] ^ w[((i)-14)&15] ^ w[(i)&15], 1))
+
+#define SHA1ROUND(a, b, c, d, e, f, k, w) \
+	e += VROTL(a, 5) + (f) + (w) + k; \
+	b = VROTL(b, 30)
+
+#define SHA1F1(b, c, d)	((b&(c^d))^d)
+#define SHA1F2(b, c, d)	(b^c^d)
+#define SHA1F3(b, c, d)	(((b|c)&d)|(b&c))
+
+#define SHA1FIVE(i, F, k, W) \
+	SHA1ROUND(a, b, c, d, e, F(b, c, d), k, W(i  )); \
+	SHA1ROUND(e, a, b, c, d, F(a, b, c), k, W(i+1)); \
+	SHA1ROUND(d, e, a, b, c, F(e, a, b), k, W(i+2)); \
+	SHA1ROUND(c, d, e, a, b, F(d, e, a), k, W(i+3)); \
+	SHA1ROUND(b, c, d, e, a, F(c, d, e), k, W(i+4))
+
+#define SHA1M(i)	w[i]
+
+static inline __attribute__((always_inline)) void sha1lanes(batchvec* st, batchvec* w)
+{
+	batchvec a, b, c, d, e;
+	register int i;
+
+	a = st[0]; b = st[1]; c = st[2]; d = st[3]; e = st[4];
+
+	SHA1FIVE( 0, SHA1F1, 0x5a827999U, SHA1M);
+	SHA1FIVE( 5, SHA1F1, 0x5a827999U, SHA1M);
+	SHA1FIVE(10, SHA1F1, 0x5a827999U, SHA1M);
+	SHA1ROUND(a, b, c, d, e, SHA1F1(b, c, d), 0x5a827999U, w[15]);
+	SHA1ROUND(e, a, b, c, d, SHA1F1(a, b, c), 0x5a827999U, SHA1W(16));
+	SHA1ROUND(d, e, a, b, c, SHA1F1(e, a, b), 0x5a827999U, SHA1W(17));
+	SHA1ROUND(c, d, e, a, b, SHA1F1(d, e, a), 0x5a827999U, SHA1W(18));
+	SHA1ROUND(b, c, d, e, a, SHA1F1(c, d, e), 0x5a827999U, SHA1W(19));
+
+	for (i = 20; i < 40; i += 5)
+	{
+		SHA1FIVE(i, SHA1F2, 0x6ed9eba1U, SHA1W);
+	}
+	for (i = 40; i < 60; i += 5)
+	{
+		SHA1FIVE(i, SHA1F3, 0x8f1bbcdcU, SHA1W);
+	}
+	for (i = 60; i < 80; i += 5)
+	{
+		SHA1FIVE(i, SHA1F2, 0xca62c1d6U, SHA1W);
+	}
+
+	st[0] += a; st[1] += b; st[2] += c; st[3] += d; st[4] += e;
+}
+
+/* the message schedule of SHA-256, in a ring of sixteen words */
+#define SHA256W(i) \
+	(w[(i)&15] += (VROTR(w[((i)-2)&15], 17) ^ VROTR(w[((i)-2)&15], 19) ^ (w[((i)-2)&15] >> 10)) + w[((i)-7)&15] + \
+		(VROTR(w[((i)-15)&15], 7) ^ VROTR(w[((i)-15)&15], 18) ^ (w[((i)-15)&15] >> 3)))
+
+#define SHA256ROUND(a, b, c, d, e, f, g, h, i, W) \
+	{ \
+		batchvec t = h + (VROTR(e, 6) ^ VROTR(e, 11) ^ VROTR(e, 25)) + (((f^g)&e)^g) + SHA2_32BIT_K[i] + W(i); \
+		d += t; \
+		h = t + (VROTR(a, 2) ^ VROTR(a, 13) ^ VROTR(a, 22)) + (((a|b)&c)|(a&b)); \
+	}
+
+#define SHA256EIGHT(i, W) \
+	SHA256ROUND(a, b, c, d, e, f, g, h, i  , W); \
+	SHA256ROUND(h, a, b, c, d, e, f, g, i+1, W); \
+	SHA256ROUND(g, h, a, b, c, d, e, f, i+2, W); \
+	SHA256ROUND(f, g, h, a, b, c, d, e, i+3, W); \
+	SHA256ROUND(e, f, g, h, a, b, c, d, i+4, W); \
+	SHA256ROUND(d, e, f, g, h, a, b, c, i+5, W); \
+	SHA256ROUND(c, d, e, f, g, h, a, b, i+6, W); \
+	SHA256ROUND(b, c, d, e, f, g, h, a, i+7, W)
+
+#define SHA256M(i)	w[i]
+
+static inline __attribute__((always_inline)) void sha256lanes(batchvec* st, batchvec* w)
+{
+	batchvec a, b, c, d, e, f, g, h;
+	register int i;
+
+	a = st[0]; b = st[1]; c = st[2]; d = st[3];
+	e = st[4]; f = st[5]; g = st[6]; h = st[7];
+
+	SHA256EIGHT(0, SHA256M);
+	SHA256EIGHT(8, SHA256M);
+
+	for (i = 16; i < 64; i += 8)
+	{
+		SHA256EIGHT(i, SHA256W);
+	}
+
+	st[0] += a; st[1] += b; st[2] += c; st[3] += d;
+	st[4] += e; st[5] += f; st[6] += g; st[7] += h;
+}
+
+/* the same code, compiled for each instruction set */
+BATCH_AVX512_TARGET static void md5lanesavx512(batchvec* st, batchvec* w) { md5lanes(st, w); }
+BATCH_AVX512_TARGET static void sha1lanesavx512(batchvec* st, batchvec* w) { sha1lanes(st, w); }
+BATCH_AVX512_TARGET static void sha256lanesavx512(batchvec* st, batchvec* w) { sha256lanes(st, w); }
+BATCH_AVX2_TARGET static void md5lanesavx2(batchvec* st, batchvec* w) { md5lanes(st, w); }
+BATCH_AVX2_TARGET static void sha1lanesavx2(batchvec* st, batchvec* w) { sha1lanes(st, w); }
+BATCH_AVX2_TARGET static void sha256lanesavx2(batchvec* st, batchvec* w) { sha256lanes(st, w); }
+
+# define BATCH_KERNELS(name)	, name##lanesavx512, name##lanesavx2
+#else
+# define BATCH_KERNELS(name)
+#endif
+
+static const batchAlgorithm batchAlgorithms[] = {
+	{ &md5,    4, 0, md5serial    BATCH_KERNELS(md5)    },
+	{ &sha1,   5, 1, sha1serial   BATCH_KERNELS(sha1)   },
+	{ &sha224, 8, 1, sha256serial BATCH_KERNELS(sha256) },
+	{ &sha256, 8, 1, sha256serial BATCH_KERNELS(sha256) }
+};
+
+#define BATCH_ALGORITHMS	(sizeof(batchAlgorithms) / sizeof(batchAlgorithm))
+
+/*
+ * batchfind
+ *  looks up the algorithm for a hash function, if there is one
+ */
+static const batchAlgorithm* batchfind(const hashFunction* hash)
+{
+	register size_t i;
+
+	for (i = 0; i < BATCH_ALGORITHMS; i++)
+		if (batchAlgorithms[i].hash == hash)
+			return batchAlgorithms+i;
+
+	return (const batchAlgorithm*) 0;
+}
+
+/*
+ * batchLane
+ *  the message which a lane is working on
+ */
+typedef struct
+{
+	hashFunctionBatchItem* item;
+	const byte* data;
+	size_t full;
+	unsigned int tailpos;
+	unsigned int ntail;
+	byte tail[128];
+} batchLane;
+
+/*
+ * batchstart
+ *  gets the initial state from the hash function, and pads the message
+ */
+static void batchstart(const batchAlgorithm* ba, batchLane* lane, hashFunctionBatchItem* item, uint32_t* h)
+{
+	const hashFunction* hash = ba->hash;
+	size_t rem = item->size & 63;
+	uint64_t bits = ((uint64_t) item->size) << 3;
+	register unsigned int i;
+	union
+	{
+		md5Param md5;
+		sha1Param sha1;
+		sha224Param sha224;
+		sha256Param sha256;
+	} param;
+
+	hash->reset(&param);
+	memcpy(h, &param, ba->words * sizeof(uint32_t));
+
+	lane->item = item;
+	lane->data = item->data;
+	lane->full = item->size >> 6;
+	lane->tailpos = 0;
+	lane->ntail = (rem < 56) ? 1 : 2;
+
+	if (rem)
+		memcpy(lane->tail, item->data + (item->size - rem), rem);
+	lane->tail[rem] = 0x80;
+	memset(lane->tail + rem + 1, 0, 64 * lane->ntail - rem - 1);
+
+	for (i = 0; i < 8; i++)
+	{
+		if (ba->bigendian)
+			lane->tail[64 * lane->ntail - 1 - i] = (byte) (bits >> (8 * i));
+		else
+			lane->tail[64 * lane->ntail - 8 + i] = (byte) (bits >> (8 * i));
+	}
+}
+
+/*
+ * batchstore
+ *  writes the digest held in the chaining words
+ */
+static void batchstore(const batchAlgorithm* ba, byte* digest, const uint32_t* h)
+{
+	register size_t i;
+
+	for (i = 0; i < ba->hash->digestsize; i++)
+	{
+		if (ba->bigendian)
+			digest[i] = (byte) (h[i >> 2] >> (24 - 8 * (i & 3)));
+		else
+			digest[i] = (byte) (h[i >> 2] >> (8 * (i & 3)));
+	}
+}
+
+/*
+ * batchfinish
+ *  writes the digest of a finished message
+ */
+static void batchfinish(const batchAlgorithm* ba, batchLane* lane, const uint32_t* h)
+{
+	batchstore(ba, lane->item->digest, h);
+}
+
+/*
+ * batchserial
+ *  hashes the rest of a message on its own
+ */
+static void batchserial(const batchAlgorithm* ba, batchLane* lane, uint32_t* h)
+{
+	ba->serial(h, lane->data, lane->full);
+	ba->serial(h, lane->tail + 64 * lane->tailpos, lane->ntail - lane->tailpos);
+	batchfinish(ba, lane, h);
+}
+
+#if BATCH_AVAILABLE
+/*
+ * batchkernel
+ *  picks the lane kernel for this processor, and the number of lanes which
+ *  must be busy for it to beat hashing one message at a time
+ */
+static batchLanes batchkernel(const batchAlgorithm* ba, unsigned int* minlanes)
+{
+	/* the SHA extensions beat AVX2, and AVX-512 when less than half the lanes are busy */
+	int serialfast = (ba->hash != &md5) && (cpuFeatures() & CPUF_X86_SHA);
+
+	if (cpuFeatures() & CPUF_X86_AVX512F)
+	{
+		*minlanes = serialfast ? (BATCH_LANES / 2) : 2;
+		return ba->avx512;
+	}
+	if ((cpuFeatures() & CPUF_X86_AVX2) && !serialfast)
+	{
+		*minlanes = BATCH_LANES / 4;
+		return ba->avx2;
+	}
+
+	return (batchLanes) 0;
+}
+
+/*
+ * batchlanes
+ *  hashes messages in the lanes until fewer than minlanes remain busy;
+ *  returns the number of messages started
+ */
+static size_t batchlanes(const batchAlgorithm* ba, batchLanes kernel, unsigned int minlanes, hashFunctionBatchItem* items, size_t count)
+{
+	static const byte zero[64] = { 0 };
+
+	batchLane lane[BATCH_LANES];
+	batchvec st[8], w[16];
+	const byte* blocks[BATCH_LANES];
+	uint32_t h[8];
+	unsigned int active = 0;
+	size_t next = 0;
+	register unsigned int i, l;
+
+	memset(st, 0, sizeof(st));
+
+	for (l = 0; l < BATCH_LANES; l++)
+	{
+		if (next < count)
+		{
+			batchstart(ba, lane+l, items + next++, h);
+			for (i = 0; i < ba->words; i++)
+				st[i][l] = h[i];
+			active++;
+		}
+		else
+			lane[l].item = (hashFunctionBatchItem*) 0;
+	}
+
+	while (active >= minlanes)
+	{
+		for (l = 0; l < BATCH_LANES; l++)
+		{
+			if (lane[l].item == (hashFunctionBatchItem*) 0)
+				blocks[l] = zero;
+			else if (lane[l].full)
+				blocks[l] = lane[l].data;
+			else
+				blocks[l] = lane[l].tail + 64 * lane[l].tailpos;
+		}
+
+		batchload(w, blocks, ba->bigendian);
+		kernel(st, w);
+
+		for (l = 0; l < BATCH_LANES; l++)
+		{
+			if (lane[l].item == (hashFunctionBatchItem*) 0)
+				continue;
+
+			if (lane[l].full)
+			{
+				lane[l].data += 64;
+				lane[l].full--;
+			}
+			else if (++lane[l].tailpos == lane[l].ntail)
+			{
+				for (i = 0; i < ba->words; i++)
+					h[i] = st[i][l];
+				batchfinish(ba, lane+l, h);
+
+				if (next < count)
+				{
+					batchstart(ba, lane+l, items + next++, h);
+					for (i = 0; i < ba->words; i++)
+						st[i][l] = h[i];
+				}
+				else
+				{
+					lane[l].item = (hashFunctionBatchItem*) 0;
+					active--;
+				}
+			}
+		}
+	}
+
+	/* too few messages left to keep the lanes busy */
+	for (l = 0; l < BATCH_LANES; l++)
+	{
+		if (lane[l].item)
+		{
+			for (i = 0; i < ba->words; i++)
+				h[i] = st[i][l];
+			batchserial(ba, lane+l, h);
+		}
+	}
+
+	return next;
+}
+#endif
+
+int hashFunctionBatchDigest(const hashFunction* hash, hashFunctionBatchItem* items, size_t count)
+{
+	const batchAlgorithm* ba;
+	hashFunctionContext ctxt;
+	register size_t i;
+
+	if (hash == (const hashFunction*) 0)
+		return -1;
+
+	ba = batchfind(hash);
+
+	#if BATCH_AVAILABLE
+	if (ba)
+	{
+		unsigned int minlanes;
+		batchLanes kernel = batchkernel(ba, &minlanes);
+
+		if (kernel && count >= minlanes)
+		{
+			i = batchlanes(ba, kernel, minlanes, items, count);
+			items += i;
+			count -= i;
+		}
+	}
+	#endif
+
+	if (count == 0)
+		return 0;
+
+	/* one by one */
+	if (hashFunctionContextInit(&ctxt, hash))
+		return -1;
+
+	for (i = 0; i < count; i++)
+	{
+		if (hashFunctionContextUpdate(&ctxt, items[i].data, items[i].size) || hashFunctionContextDigest(&ctxt, items[i].digest))
+		{
+			hashFunctionContextFree(&ctxt);
+			return -1;
+		}
+	}
+
+	return hashFunctionContextFree(&ctxt);
+}
+
+/*
+ * iterpad
+ *  fills a block holding one digest with the padding of the hash; prefix is
+ *  the number of bytes hashed before this block
+ */
+static void iterpad(const batchAlgorithm* ba, byte* block, size_t prefix)
+{
+	size_t size = ba->hash->digestsize;
+	uint64_t bits = ((uint64_t) (prefix + size)) << 3;
+	register unsigned int i;
+
+	block[size] = 0x80;
+	memset(block + size + 1, 0, 64 - size - 1);
+
+	for (i = 0; i < 8; i++)
+	{
+		if (ba->bigendian)
+			block[63 - i] = (byte) (bits >> (8 * i));
+		else
+			block[56 + i] = (byte) (bits >> (8 * i));
+	}
+}
+
+/*
+ * iterserial
+ *  iterates one chain on its own: U = H(U) starting from state ih, or if oh
+ *  isn't null, U = HMAC(U) and T ^= U with the inner and outer states
+ */
+static void iterserial(const batchAlgorithm* ba, const uint32_t* ih, const uint32_t* oh, byte* u, byte* t, size_t iterations)
+{
+	uint32_t h[8];
+	byte block[64];
+	register size_t i;
+
+	memcpy(block, u, ba->hash->digestsize);
+	iterpad(ba, block, oh ? 64 : 0);
+
+	while (iterations--)
+	{
+		memcpy(h, ih, ba->words * sizeof(uint32_t));
+		ba->serial(h, block, 1);
+		batchstore(ba, block, h);
+
+		if (oh)
+		{
+			memcpy(h, oh, ba->words * sizeof(uint32_t));
+			ba->serial(h, block, 1);
+			batchstore(ba, block, h);
+
+			for (i = 0; i < ba->hash->digestsize; i++)
+				t[i] ^= block[i];
+		}
+	}
+
+	memcpy(u, block, ba->hash->digestsize);
+	memset(block, 0, sizeof(block));
+	memset(h, 0, sizeof(h));
+}
+
+#if BATCH_AVAILABLE
+/*
+ * iterlanes
+ *  iterates sixteen chains at once, like iterserial; u and t hold the words
+ *  of U and T in each lane
+ */
+static inline __attribute__((always_inline)) void iterlanes(const batchAlgorithm* ba, batchLanes kernel, const uint32_t* ih, const uint32_t* oh, const uint32_t* pad, batchvec* u, batchvec* t, size_t iterations)
+{
+	const batchvec zero = { 0 };
+	batchvec st[8], w[16];
+	unsigned int dw = ba->hash->digestsize >> 2;
+	register unsigned int i;
+
+	while (iterations--)
+	{
+		for (i = 0; i < 16; i++)
+			w[i] = (i < dw) ? u[i] : zero + pad[i];
+		for (i = 0; i < ba->words; i++)
+			st[i] = zero + ih[i];
+		kernel(st, w);
+
+		if (oh)
+		{
+			for (i = 0; i < 16; i++)
+				w[i] = (i < dw) ? st[i] : zero + pad[i];
+			for (i = 0; i < ba->words; i++)
+				st[i] = zero + oh[i];
+			kernel(st, w);
+
+			for (i = 0; i < dw; i++)
+				t[i] ^= st[i];
+		}
+
+		for (i = 0; i < dw; i++)
+			u[i] = st[i];
+	}
+
+	memset(st, 0, sizeof(st));
+	memset(w, 0, sizeof(w));
+}
+
+BATCH_AVX512_TARGET static void iterlanesavx512(const batchAlgorithm* ba, const uint32_t* ih, const uint32_t* oh, const uint32_t* pad, batchvec* u, batchvec* t, size_t iterations) { iterlanes(ba, ba->avx512, ih, oh, pad, u, t, iterations); }
+BATCH_AVX2_TARGET static void iterlanesavx2(const batchAlgorithm* ba, const uint32_t* ih, const uint32_t* oh, const uint32_t* pad, batchvec* u, batchvec* t, size_t iterations) { iterlanes(ba, ba->avx2, ih, oh, pad, u, t, iterations); }
+#endif
+
+/*
+ * batchiterate
+ *  iterates count chains, in the lanes if there are enough of them; for
+ *  plain hashing t is null
+ */
+static void batchiterate(const batchAlgorithm* ba, const uint32_t* ih, const uint32_t* oh, byte* u, byte* t, size_t count, size_t iterations)
+{
+	size_t size = ba->hash->digestsize;
+	register size_t i;
+
+	#if BATCH_AVAILABLE
+	unsigned int minlanes;
+	batchLanes kernel = batchkernel(ba, &minlanes);
+
+	if (kernel && count >= minlanes)
+	{
+		batchvec uv[8], tv[8];
+		uint32_t h[8], pad[16];
+		byte block[64];
+		unsigned int l, n;
+
+		/* the padding words of the blocks, the same in all lanes */
+		iterpad(ba, block, oh ? 64 : 0);
+		for (i = 0; i < 16; i++)
+			pad[i] = batchword(block + 4 * i, ba->bigendian);
+
+		while (count >= minlanes)
+		{
+			n = (count > BATCH_LANES) ? BATCH_LANES : (unsigned int) count;
+
+			memset(uv, 0, sizeof(uv));
+			memset(tv, 0, sizeof(tv));
+
+			for (l = 0; l < n; l++)
+			{
+				for (i = 0; i < (size >> 2); i++)
+				{
+					uv[i][l] = batchword(u + l * size + 4 * i, ba->bigendian);
+					if (t)
+						tv[i][l] = batchword(t + l * size + 4 * i, ba->bigendian);
+				}
+			}
+
+			if (kernel == ba->avx512)
+				iterlanesavx512(ba, ih, oh, pad, uv, tv, iterations);
+			else
+				iterlanesavx2(ba, ih, oh, pad, uv, tv, iterations);
+
+			for (l = 0; l < n; l++)
+			{
+				for (i = 0; i < (size >> 2); i++)
+					h[i] = uv[i][l];
+				batchstore(ba, u + l * size, h);
+				if (t)
+				{
+					for (i = 0; i < (size >> 2); i++)
+						h[i] = tv[i][l];
+					batchstore(ba, t + l * size, h);
+				}
+			}
+
+			u += n * size;
+			if (t)
+				t += n * size;
+			count -= n;
+		}
+
+		memset(uv, 0, sizeof(uv));
+		memset(tv, 0, sizeof(tv));
+		memset(h, 0, sizeof(h));
+	}
+	#endif
+
+	for (i = 0; i < count; i++)
+		iterserial(ba, ih, oh, u + i * size, t ? t + i * size : t, iterations);
+}
+
+int hashFunctionBatchIterate(const hashFunction* hash, byte* digests, size_t count, size_t iterations)
+{
+	const batchAlgorithm* ba;
+	hashFunctionContext ctxt;
+	register size_t i, j;
+
+	if (hash == (const hashFunction*) 0)
+		return -1;
+
+	if ((ba = batchfind(hash)))
+	{
+		uint32_t ih[8];
+		union
+		{
+			md5Param md5;
+			sha1Param sha1;
+			sha224Param sha224;
+			sha256Param sha256;
+		} param;
+
+		hash->reset(&param);
+		memcpy(ih, &param, ba->words * sizeof(uint32_t));
+
+		batchiterate(ba, ih, (const uint32_t*) 0, digests, (byte*) 0, count, iterations);
+
+		return 0;
+	}
+
+	/* one by one */
+	if (hashFunctionContextInit(&ctxt, hash))
+		return -1;
+
+	for (i = 0; i < count; i++)
+	{
+		byte* digest = digests + i * hash->digestsize;
+
+		for (j = 0; j < iterations; j++)
+		{
+			if (hashFunctionContextUpdate(&ctxt, digest, hash->digestsize) || hashFunctionContextDigest(&ctxt, digest))
+			{
+				hashFunctionContextFree(&ctxt);
+				return -1;
+			}
+		}
+	}
+
+	return hashFunctionContextFree(&ctxt);
+}
+
+int hmacBatchIterate(const hashFunction* hash, const hashFunctionParam* istate, const hashFunctionParam* ostate, byte* u, byte* t, size_t count, size_t iterations)
+{
+	const batchAlgorithm* ba;
+	uint32_t ih[8], oh[8];
+
+	if (hash == (const hashFunction*) 0)
+		return -1;
+
+	if ((ba = batchfind(hash)) == (const batchAlgorithm*) 0)
+		return -1;
+
+	/* the states start with the chaining words, like batchstart expects */
+	memcpy(ih, istate, ba->words * sizeof(uint32_t));
+	memcpy(oh, ostate, ba->words * sizeof(uint32_t));
+
+	batchiterate(ba, ih, oh, u, t, count, iterations);
+
+	memset(ih, 0, sizeof(ih));
+	memset(oh, 0, sizeof(oh));
+
+	return 0;
+}
+
+/*!\}
+ */
@@ -42,12 +42,27 @@
 #define HMAC_IPAD	0x36
 #define HMAC_OPAD	0x5c
 
-int hmacSetup(byte* kxi, byte* kxo, const hashFunction* hash, hashFunctionParam* param, const byte* key, size_t keybits)
+/*
+ * The inner and outer pads each fill exactly one block; instead of absorbing
+ * them again for every message, hmacSetup saves the hash states right after
+ * absorbing them, and hmacReset and hmacDigest merely copy these states.
+ */
+
+#define HMAC_MAXBLOCKSIZE	128
+
+int hmacSetup(hashFunctionParam* istate, hashFunctionParam* ostate, const hashFunction* hash, hashFunctionParam* param, const byte* key, size_t keybits)
 {
 	register unsigned int i;
+	int rc = -1;
+
+	byte kxi[HMAC_MAXBLOCKSIZE];
+	byte kxo[HMAC_MAXBLOCKSIZE];
 
 	size_t keybytes = keybits >> 3;
 
+	if (hash->blocksize > HMAC_MAXBLOCKSIZE)
+		return -1;
+
 	/* if the key is too large, hash it first */
 	if (keybytes > hash->blocksize)
 	{
@@ -71,8 +86,7 @@ int hmacSetup(byte* kxi, byte* kxo, const hashFunction* hash, hashFunctionParam*
 		memcpy(kxi, key, keybytes);
 		memcpy(kxo, key, keybytes);
 	}
-	else
-		return -1;
+	/* an empty key is allowed, and padded with zeroes like any short key */
 
 	for (i = 0; i < keybytes; i++)
 	{
@@ -86,15 +100,20 @@ int hmacSetup(byte* kxi, byte* kxo, const hashFunction* hash, hashFunctionParam*
 		kxo[i] = HMAC_OPAD;
 	}
 
-	return hmacReset(kxi, hash, param);
+	if (hash->reset(istate) == 0 && hash->update(istate, kxi, hash->blocksize) == 0 &&
+		hash->reset(ostate) == 0 && hash->update(ostate, kxo, hash->blocksize) == 0)
+		rc = hmacReset(istate, hash, param);
+
+	/* the pads are as secret as the key */
+	memset(kxi, 0, sizeof(kxi));
+	memset(kxo, 0, sizeof(kxo));
+
+	return rc;
 }
 
-int hmacReset(const byte* kxi, const hashFunction* hash, hashFunctionParam* param)
+int hmacReset(const hashFunctionParam* istate, const hashFunction* hash, hashFunctionParam* param)
 {
-	if (hash->reset(param))
-		return -1;
-	if (hash->update(param, kxi, hash->blocksize))
-		return -1;
+	memcpy(param, istate, hash->paramsize);
 
 	return 0;
 }
@@ -104,12 +123,13 @@ int hmacUpdate(const hashFunction* hash, hashFunctionParam* param, const byte* d
 	return hash->update(param, data, size);
 }
 
-int hmacDigest(const byte* kxo, const hashFunction* hash, hashFunctionParam* param, byte* data)
+int hmacDigest(const hashFunctionParam* ostate, const hashFunction* hash, hashFunctionParam* param, byte* data)
 {
 	if (hash->digest(param, data))
 		return -1;
-	if (hash->update(param, kxo, hash->blocksize))
-		return -1;
+
+	memcpy(param, ostate, hash->paramsize);
+
 	if (hash->update(param, data, hash->digestsize))
 		return -1;
 	if (hash->digest(param, data))
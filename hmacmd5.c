@@ -55,12 +55,12 @@ const keyedHashFunction hmacmd5 = {
 
 int hmacmd5Setup (hmacmd5Param* sp, const byte* key, size_t keybits)
 {
-	return hmacSetup(sp->kxi, sp->kxo, &md5, &sp->mparam, key, keybits);
+	return hmacSetup(&sp->istate, &sp->ostate, &md5, &sp->mparam, key, keybits);
 }
 
 int hmacmd5Reset (hmacmd5Param* sp)
 {
-	return hmacReset(sp->kxi, &md5, &sp->mparam);
+	return hmacReset(&sp->istate, &md5, &sp->mparam);
 }
 
 int hmacmd5Update(hmacmd5Param* sp, const byte* data, size_t size)
@@ -70,7 +70,10 @@ int hmacmd5Update(hmacmd5Param* sp, const byte* data, size_t size)
 
 int hmacmd5Digest(hmacmd5Param* sp, byte* data)
 {
-	return hmacDigest(sp->kxo, &md5, &sp->mparam, data);
+	if (hmacDigest(&sp->ostate, &md5, &sp->mparam, data))
+		return -1;
+
+	return hmacReset(&sp->istate, &md5, &sp->mparam);
 }
 
 /*!\}
@@ -51,12 +51,12 @@ const keyedHashFunction hmacsha384 = {
 
 int hmacsha384Setup (hmacsha384Param* sp, const byte* key, size_t keybits)
 {
-	return hmacSetup(sp->kxi, sp->kxo, &sha384, &sp->sparam, key, keybits);
+	return hmacSetup(&sp->istate, &sp->ostate, &sha384, &sp->sparam, key, keybits);
 }
 
 int hmacsha384Reset (hmacsha384Param* sp)
 {
-	return hmacReset(sp->kxi, &sha384, &sp->sparam);
+	return hmacReset(&sp->istate, &sha384, &sp->sparam);
 }
 
 int hmacsha384Update(hmacsha384Param* sp, const byte* data, size_t size)
@@ -66,7 +66,10 @@ int hmacsha384Update(hmacsha384Param* sp, const byte* data, size_t size)
 
 int hmacsha384Digest(hmacsha384Param* sp, byte* data)
 {
-	return hmacDigest(sp->kxo, &sha384, &sp->sparam, data);
+	if (hmacDigest(&sp->ostate, &sha384, &sp->sparam, data))
+		return -1;
+
+	return hmacReset(&sp->istate, &sha384, &sp->sparam);
 }
 
 /*!\}
@@ -51,12 +51,12 @@ const keyedHashFunction hmacsha512 = {
 
 int hmacsha512Setup (hmacsha512Param* sp, const byte* key, size_t keybits)
 {
-	return hmacSetup(sp->kxi, sp->kxo, &sha512, &sp->sparam, key, keybits);
+	return hmacSetup(&sp->istate, &sp->ostate, &sha512, &sp->sparam, key, keybits);
 }
 
 int hmacsha512Reset (hmacsha512Param* sp)
 {
-	return hmacReset(sp->kxi, &sha512, &sp->sparam);
+	return hmacReset(&sp->istate, &sha512, &sp->sparam);
 }
 
 int hmacsha512Update(hmacsha512Param* sp, const byte* data, size_t size)
@@ -66,7 +66,10 @@ int hmacsha512Update(hmacsha512Param* sp, const byte* data, size_t size)
 
 int hmacsha512Digest(hmacsha512Param* sp, byte* data)
 {
-	return hmacDigest(sp->kxo, &sha512, &sp->sparam, data);
+	if (hmacDigest(&sp->ostate, &sha512, &sp->sparam, data))
+		return -1;
+
+	return hmacReset(&sp->istate, &sha512, &sp->sparam);
 }
 
 /*!\}
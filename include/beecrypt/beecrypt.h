@@ -404,6 +404,75 @@ int hashFunctionContextDigestMatch(hashFunctionContext*, const mpnumber*);
 }
 #endif
 
+/*!\brief One message for hashFunctionBatchDigest.
+ * \ingroup HASH_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI hashFunctionBatchItem
+#else
+struct _hashFunctionBatchItem
+#endif
+{
+	/*!\var data
+	 * \brief The message.
+	 */
+	const byte* data;
+	/*!\var size
+	 * \brief The size of the message in bytes.
+	 */
+	size_t size;
+	/*!\var digest
+	 * \brief Where to store the digest; must have room for 'digestsize' bytes.
+	 */
+	byte* digest;
+};
+
+#ifndef __cplusplus
+typedef struct _hashFunctionBatchItem hashFunctionBatchItem;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn int hashFunctionBatchDigest(const hashFunction* hash, hashFunctionBatchItem* items, size_t count)
+ * \brief This function computes the digests of a number of independent
+ *  messages.
+ *
+ * For MD5, SHA-1, SHA-224 and SHA-256 the messages are hashed side by side
+ * in SIMD registers when the processor supports AVX2 or AVX-512 and there
+ * are enough of them; other hash functions process them one by one.
+ *
+ * \param hash The hash function.
+ * \param items The messages and the places to store their digests.
+ * \param count The number of messages.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int hashFunctionBatchDigest(const hashFunction* hash, hashFunctionBatchItem* items, size_t count);
+
+/*!\fn int hashFunctionBatchIterate(const hashFunction* hash, byte* digests, size_t count, size_t iterations)
+ * \brief This function iterates a number of independent hash chains,
+ *  replacing each digest by the digest of itself, \a iterations times.
+ *
+ * For MD5, SHA-1, SHA-224 and SHA-256 the chains run side by side like in
+ * hashFunctionBatchDigest, without the overhead of buffering the data.
+ *
+ * \param hash The hash function.
+ * \param digests The digests, one after another.
+ * \param count The number of digests.
+ * \param iterations The number of iterations.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int hashFunctionBatchIterate(const hashFunction* hash, byte* digests, size_t count, size_t iterations);
+
+#ifdef __cplusplus
+}
+#endif
+
 /*
  * Keyed Hash Functions, a.k.a. Message Authentication Codes
  */
@@ -626,6 +695,21 @@ typedef struct
 {
 	const blockCipherRawcrypt encrypt;
 	const blockCipherRawcrypt decrypt;
+	/*!\var encryptn
+	 * \brief Optional function which encrypts a number of independent
+	 *  blocks at once, so that the cipher can process several of them in
+	 *  parallel; null if the cipher doesn't have one.
+	 *
+	 * The generic CTR mode hands it the counter blocks.
+	 */
+	const blockCipherModcrypt encryptn;
+	/*!\var decryptn
+	 * \brief Optional function which decrypts a number of independent
+	 *  blocks at once; null if the cipher doesn't have one.
+	 *
+	 * The generic CBC decryption hands it the ciphertext blocks.
+	 */
+	const blockCipherModcrypt decryptn;
 } blockCipherRaw;
 
 typedef struct
@@ -87,6 +87,9 @@ namespace beecrypt {
 			int update(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset = 0) throw (IllegalStateException, ShortBufferException);
 //			int update(ByteBuffer& input, ByteBuffer& output) throw (IllegalStateException, ShortBufferException);
 
+			void updateAAD(const bytearray& input) throw (IllegalStateException, UnsupportedOperationException);
+			void updateAAD(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, UnsupportedOperationException);
+
 			const String& getAlgorithm() const throw ();
 			const Provider& getProvider() const throw ();
 		};
@@ -37,6 +37,8 @@ using beecrypt::crypto::IllegalBlockSizeException;
 using beecrypt::crypto::NoSuchPaddingException;
 #include "beecrypt/c++/lang/IllegalStateException.h"
 using beecrypt::lang::IllegalStateException;
+#include "beecrypt/c++/lang/UnsupportedOperationException.h"
+using beecrypt::lang::UnsupportedOperationException;
 #include "beecrypt/c++/lang/Object.h"
 using beecrypt::lang::Object;
 #include "beecrypt/c++/security/AlgorithmParameters.h"
@@ -61,8 +63,8 @@ namespace beecrypt {
 			friend class Cipher;
 
 		protected:
-			virtual bytearray* engineDoFinal(const byte* input, int inputOffset, int inputLength) throw (IllegalBlockSizeException, BadPaddingException) = 0;
-			virtual int engineDoFinal(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (ShortBufferException, IllegalBlockSizeException, BadPaddingException) = 0;
+			virtual bytearray* engineDoFinal(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, IllegalBlockSizeException, BadPaddingException) = 0;
+			virtual int engineDoFinal(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (IllegalStateException, ShortBufferException, IllegalBlockSizeException, BadPaddingException) = 0;
 //			virtual int engineDoFinal(ByteBuffer& input, ByteBuffer& output) throw (ShortBufferException, IllegalBlockSizeException, BadPaddingException) = 0;
 
 			virtual int engineGetBlockSize() const throw () = 0;
@@ -81,9 +83,14 @@ namespace beecrypt {
 //			virtual Key* engineUnwrap(const bytearray& wrappedKey, const String& wrappedKeyAlgorithm, int wrappedKeyType) throw (InvalidKeyException, NoSuchAlgorithmException) = 0;
 
 			virtual bytearray* engineUpdate(const byte* input, int inputOffset, int inputLength) = 0;
-			virtual int engineUpdate(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (ShortBufferException) = 0;
+			virtual int engineUpdate(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (IllegalStateException, ShortBufferException) = 0;
 //			virtual int engineUpdate(ByteBuffer& input, ByteBuffer& output) throw (ShortBufferException) = 0;
 
+			/*!\brief Adds additional authenticated data; only modes which
+			 *  authenticate, such as GCM, support this.
+			 */
+			virtual void engineUpdateAAD(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, UnsupportedOperationException);
+
 //			virtual bytearray* engineWrap(const Key& key) throw (IllegalBlockSizeException, InvalidKeyException) = 0;
 
 		public:
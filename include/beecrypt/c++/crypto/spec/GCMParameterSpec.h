@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*!\file GCMParameterSpec.h
+ * \ingroup CXX_CRYPTO_SPEC_m
+ */
+
+#ifndef _CLASS_BEE_CRYPTO_SPEC_GCMPARAMETERSPEC_H
+#define _CLASS_BEE_CRYPTO_SPEC_GCMPARAMETERSPEC_H
+
+#ifdef __cplusplus
+
+#include "beecrypt/c++/array.h"
+using beecrypt::bytearray;
+#include "beecrypt/c++/lang/Object.h"
+using beecrypt::lang::Object;
+#include "beecrypt/c++/security/spec/AlgorithmParameterSpec.h"
+using beecrypt::security::spec::AlgorithmParameterSpec;
+
+namespace beecrypt {
+	namespace crypto {
+		namespace spec {
+			/*!\brief The parameters for Galois/Counter Mode: the IV and the tag
+			 *  length in bits.
+			 * \ingroup CXX_CRYPTO_SPEC_m
+			 */
+			class BEECRYPTCXXAPI GCMParameterSpec : public Object, public virtual AlgorithmParameterSpec
+			{
+			private:
+				int _tlen;
+				bytearray _iv;
+
+			public:
+				GCMParameterSpec(int tLen, const byte* iv, size_t offset, size_t length);
+				GCMParameterSpec(int tLen, const bytearray& iv);
+				virtual ~GCMParameterSpec() {}
+
+				int getTLen() const throw ();
+				const bytearray& getIV() const throw ();
+				bytearray* getIV();
+			};
+		}
+	}
+}
+
+#endif
+
+#endif
@@ -92,6 +92,12 @@ namespace beecrypt {
 		//	BigInteger modPow(const BigInteger& exponent, const BigInteger& m) const throw (ArithmeticException);
 			BigInteger negate() const;
 
+			/*!\brief Tests whether the magnitude of this BigInteger is
+			 *  probably prime, using the Baillie-PSW test.
+			 * \param certainty If not positive, the result is always true.
+			 */
+			bool isProbablePrime(jint certainty) const;
+
 			bytearray* toByteArray() const;
 			void toByteArray(bytearray& b) const;
 			String toString(jint radix) const;
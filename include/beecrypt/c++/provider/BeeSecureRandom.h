@@ -33,12 +33,18 @@ using beecrypt::security::SecureRandomSpi;
 namespace beecrypt {
 	namespace provider {
 		/*!\ingroup CXX_PROVIDER_m
+		 *
+		 * When the property securerandom.pool is set to true, instances
+		 * take their bytes from the process-wide pool of the poolprng
+		 * generator, which hands out small requests without locking.
 		 */
 		class BeeSecureRandom : public SecureRandomSpi
 		{
 		private:
 			randomGeneratorContext _rngc;
 
+			static const randomGenerator* defaultGenerator();
+
 		protected:
 			BeeSecureRandom(const randomGenerator*);
 
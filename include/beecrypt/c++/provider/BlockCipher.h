@@ -24,6 +24,7 @@
 #define _CLASS_BLOCKCIPHER_H
 
 #include "beecrypt/beecrypt.h"
+#include "beecrypt/gcm.h"
 
 #ifdef __cplusplus
 
@@ -38,6 +39,7 @@ namespace beecrypt {
 			static const int MODE_ECB;
 			static const int MODE_CBC;
 			static const int MODE_CTR;
+			static const int MODE_GCM;
 
 			static const int PADDING_NONE;
 			static const int PADDING_PKCS5;
@@ -53,13 +55,22 @@ namespace beecrypt {
 			int _bufcnt;
 			int _buflwm;
 			bytearray _iv;
-
-			int process(const byte* input, int inputLength, byte* output, int outputLength) throw (ShortBufferException);
+			gcmContext _gcm;
+			int _taglen;
+			bytearray _gcmbuf;
+			bool _gcmspent;
+			bytearray _gcmkey;
+			bytearray _gcmiv;
+
+			int process(const byte* input, int inputLength, byte* output, int outputLength) throw (IllegalStateException, ShortBufferException);
+			int processGCM(const byte* input, int inputLength, byte* output, int outputLength);
+			int finishGCM(byte* output, int outputLength) throw (ShortBufferException);
+			void initKey(int opmode, const Key& key) throw (InvalidKeyException);
 			void engineReset();
 
 		protected:
-			virtual bytearray* engineDoFinal(const byte* input, int inputOffset, int inputLength) throw (IllegalBlockSizeException, BadPaddingException);
-			virtual int engineDoFinal(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (ShortBufferException, IllegalBlockSizeException, BadPaddingException);
+			virtual bytearray* engineDoFinal(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, IllegalBlockSizeException, BadPaddingException);
+			virtual int engineDoFinal(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (IllegalStateException, ShortBufferException, IllegalBlockSizeException, BadPaddingException);
 
 			virtual int engineGetBlockSize() const throw ();
 			virtual bytearray* engineGetIV();
@@ -72,7 +83,9 @@ namespace beecrypt {
 			virtual void engineInit(int opmode, const Key& key, const AlgorithmParameterSpec& params, SecureRandom* random) throw (InvalidKeyException, InvalidAlgorithmParameterException);
 
 			virtual bytearray* engineUpdate(const byte* input, int inputOffset, int inputLength);
-			virtual int engineUpdate(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (ShortBufferException);
+			virtual int engineUpdate(const byte* input, int inputOffset, int inputLength, bytearray& output, int outputOffset) throw (IllegalStateException, ShortBufferException);
+
+			virtual void engineUpdateAAD(const byte* input, int inputOffset, int inputLength) throw (IllegalStateException, UnsupportedOperationException);
 
             virtual void engineSetMode(const String& mode) throw (NoSuchAlgorithmException);
             virtual void engineSetPadding(const String& padding) throw (NoSuchPaddingException);
@@ -38,6 +38,7 @@ namespace beecrypt {
 			int _size;
 			DHParameterSpec* _spec;
 			SecureRandom* _srng;
+			int _threads;
 
 			KeyPair* genpair(randomGeneratorContext*);
 
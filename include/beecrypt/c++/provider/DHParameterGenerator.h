@@ -40,6 +40,7 @@ namespace beecrypt {
 			int _size;
 			DHParameterSpec* _spec;
 			SecureRandom* _srng;
+			int _threads;
 
 		protected:
 			virtual AlgorithmParameters* engineGenerateParameters();
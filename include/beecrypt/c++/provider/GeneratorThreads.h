@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file GeneratorThreads.h
+ * \ingroup CXX_PROVIDER_m
+ */
+
+#ifndef _BEECRYPT_PROVIDER_GENERATORTHREADS_H
+#define _BEECRYPT_PROVIDER_GENERATORTHREADS_H
+
+#ifdef __cplusplus
+
+#include "beecrypt/c++/security/ProviderException.h"
+using beecrypt::security::ProviderException;
+
+namespace beecrypt {
+	namespace provider {
+		/*!\brief Returns the number of threads configured in beecrypt.conf
+		 *  under the given property; 0 means one per processor.
+		 * \return The configured value, or 1 if the property isn't set.
+		 * \throw ProviderException if the value isn't a number, or is
+		 *  negative.
+		 */
+		int generatorThreads(const char* property) throw (ProviderException);
+	}
+}
+
+#endif
+
+#endif
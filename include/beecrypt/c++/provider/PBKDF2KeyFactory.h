@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*!\file PBKDF2KeyFactory.h
+ * \ingroup CXX_PROVIDER_m
+ */
+
+#ifndef _CLASS_PBKDF2KEYFACTORY_H
+#define _CLASS_PBKDF2KEYFACTORY_H
+
+#include "beecrypt/beecrypt.h"
+
+#ifdef __cplusplus
+
+#include "beecrypt/c++/crypto/SecretKeyFactorySpi.h"
+using beecrypt::crypto::SecretKeyFactorySpi;
+
+namespace beecrypt {
+	namespace provider {
+		/*!\brief Derives secret keys from a PBEKeySpec with PBKDF2.
+		 *
+		 * The password is encoded in UTF-8; the key length of the
+		 * PBEKeySpec is in bits.
+		 */
+		class PBKDF2KeyFactory : public SecretKeyFactorySpi
+		{
+		private:
+			const hashFunction* _hf;
+			String _algo;
+
+		protected:
+			virtual SecretKey* engineGenerateSecret(const KeySpec&) throw (InvalidKeySpecException);
+			virtual KeySpec* engineGetKeySpec(const SecretKey&, const type_info&) throw (InvalidKeySpecException);
+			virtual SecretKey* engineTranslateKey(const SecretKey&) throw (InvalidKeyException);
+
+		public:
+			PBKDF2KeyFactory(const hashFunction&, const String&);
+			virtual ~PBKDF2KeyFactory() {}
+		};
+	}
+}
+
+#endif
+
+#endif
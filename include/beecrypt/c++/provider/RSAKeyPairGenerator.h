@@ -44,6 +44,7 @@ namespace beecrypt {
 			int _size;
 			BigInteger _e;
 			SecureRandom* _srng;
+			int _threads;
 
 			KeyPair* genpair(randomGeneratorContext*);
 
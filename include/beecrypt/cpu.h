@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file cpu.h
+ * \brief Runtime detection of processor features, headers.
+ *
+ * Optimized code paths which depend on instruction set extensions are
+ * selected at runtime, so that one binary still runs on older processors.
+ */
+
+#ifndef _CPU_H
+#define _CPU_H
+
+#include "beecrypt/api.h"
+
+/*
+ * x86 and x86_64 features; the values are also used by the assembler
+ * routines, so they must not change
+ */
+#define CPUF_X86_SSE2		0x00000001U
+#define CPUF_X86_SSSE3		0x00000002U
+#define CPUF_X86_SSE41		0x00000004U
+#define CPUF_X86_AESNI		0x00000008U
+#define CPUF_X86_PCLMUL		0x00000010U
+#define CPUF_X86_AVX		0x00000020U
+#define CPUF_X86_AVX2		0x00000040U
+#define CPUF_X86_BMI2		0x00000080U
+#define CPUF_X86_ADX		0x00000100U
+#define CPUF_X86_SHA		0x00000200U
+#define CPUF_X86_AVX512F	0x00000400U
+#define CPUF_X86_AVX512VL	0x00000800U
+#define CPUF_X86_AVX512IFMA	0x00001000U
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn unsigned int cpuFeatures(void)
+ * \brief This function returns the processor features which the library
+ *  may use, as a combination of CPUF_* flags.
+ */
+BEECRYPTAPI
+unsigned int cpuFeatures(void);
+
+/*!\fn unsigned int cpuFeaturesMask(unsigned int mask)
+ * \brief This function restricts the processor features which the library
+ *  may use to those which are both detected and present in \a mask.
+ *
+ * Passing ~0U re-enables all detected features. This is mainly useful for
+ * testing and benchmarking the generic code paths on capable hardware; it
+ * should not be called while other threads are using the library.
+ *
+ * \param mask The allowed features.
+ * \return The features which remain enabled.
+ */
+BEECRYPTAPI
+unsigned int cpuFeaturesMask(unsigned int mask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file ctrdrbg.h
+ * \brief CTR_DRBG pseudo-random number generator with AES-256, headers.
+ * \ingroup PRNG_m PRNG_ctrdrbg_m
+ */
+
+#ifndef _CTRDRBG_H
+#define _CTRDRBG_H
+
+#include "beecrypt/beecrypt.h"
+
+#ifdef _REENTRANT
+# if WIN32
+#  include <windows.h>
+#  include <winbase.h>
+# endif
+#endif
+
+#include "beecrypt/aes.h"
+
+/*!\brief The length of the seed material, i.e. an AES-256 key and a block.
+ * \ingroup PRNG_ctrdrbg_m
+ */
+#define CTRDRBG_SEEDLEN				48
+
+/*!\brief The number of requests after which the generator reseeds itself
+ *  from the entropy sources; SP 800-90A allows up to 2^48.
+ * \ingroup PRNG_ctrdrbg_m
+ */
+#define CTRDRBG_RESEED_INTERVAL		((uint64_t) 1 << 24)
+
+/*!\brief The largest number of bytes produced by a single request; longer
+ *  outputs are split into several requests.
+ * \ingroup PRNG_ctrdrbg_m
+ */
+#define CTRDRBG_MAX_REQUEST			65536
+
+/*!\ingroup PRNG_ctrdrbg_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI ctrdrbgParam
+#else
+struct _ctrdrbgParam
+#endif
+{
+	#ifdef _REENTRANT
+	bc_mutex_t	lock;
+	#endif
+	/*!\var aes
+	 * \brief Holds the expanded key.
+	 */
+	aesParam	aes;
+	/*!\var v
+	 * \brief The value V, a big-endian counter.
+	 */
+	byte		v[16];
+	/*!\var reseed
+	 * \brief Counts the requests since the last (re)seeding.
+	 */
+	uint64_t	reseed;
+};
+
+#ifndef __cplusplus
+typedef struct _ctrdrbgParam ctrdrbgParam;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\var ctrdrbg
+ * \brief The NIST SP 800-90A CTR_DRBG, with AES-256 and the derivation
+ *  function, and without prediction resistance.
+ *
+ * Setup instantiates the generator with 48 bytes from the entropy sources;
+ * seeding reseeds it with the given data as entropy input.
+ *
+ * \ingroup PRNG_ctrdrbg_m
+ */
+extern BEECRYPTAPI const randomGenerator ctrdrbg;
+
+BEECRYPTAPI
+int ctrdrbgSetup  (ctrdrbgParam*);
+BEECRYPTAPI
+int ctrdrbgSeed   (ctrdrbgParam*, const byte*, size_t);
+BEECRYPTAPI
+int ctrdrbgNext   (ctrdrbgParam*, byte*, size_t);
+BEECRYPTAPI
+int ctrdrbgCleanup(ctrdrbgParam*);
+
+/*!\fn int ctrdrbgInstantiate(ctrdrbgParam* dp, const byte* seed, size_t size)
+ * \brief Instantiates the generator from the given seed material, which is
+ *  the concatenation of the entropy input, the nonce and the
+ *  personalization string.
+ * \param dp The generator's parameters; ctrdrbgSetup must have been called.
+ * \param seed The seed material.
+ * \param size The length of the seed material.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int ctrdrbgInstantiate(ctrdrbgParam* dp, const byte* seed, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,7 @@
 #define _DLDP_H
 
 #include "beecrypt/mpbarrett.h"
+#include "beecrypt/mpmont.h"
 
 /*
  * Discrete Logarithm Domain Parameters - Prime
@@ -84,6 +85,14 @@ struct _dldp_p
 	 * \f$n=p-1=qr\f$
 	 */
 	mpbarrett n;
+	/*!\var gcomb
+	 * \brief Optional precomputed powers of \f$g\f$.
+	 *
+	 * Built by dldp_pgCombMake; when present, the key generation functions
+	 * use it to compute \f$g^x\ \textrm{mod}\ p\f$ with fewer squarings.
+	 * It is ignored if \f$p\f$ or \f$g\f$ no longer match.
+	 */
+	mpmontcomb* gcomb;
 #ifdef __cplusplus
 	dldp_p();
 	dldp_p(const dldp_p&);
@@ -110,6 +119,17 @@ int dldp_pFree(dldp_p*);
 BEECRYPTAPI
 int dldp_pCopy(dldp_p*, const dldp_p*);
 
+/*
+ * Functions for the fixed-base precomputation of g
+ */
+
+BEECRYPTAPI
+int dldp_pgCombMake(dldp_p*, size_t);
+BEECRYPTAPI
+int dldp_pgCombFree(dldp_p*);
+BEECRYPTAPI
+int dldp_pgPowMod(const dldp_p*, const mpnumber*, mpnumber*);
+
 /*
  * Functions for generating keys
  */
@@ -141,6 +161,8 @@ int dldp_pgoqMake     (dldp_p*, randomGeneratorContext*, size_t, size_t, int);
 BEECRYPTAPI
 int dldp_pgoqMakeSafe (dldp_p*, randomGeneratorContext*, size_t);
 BEECRYPTAPI
+int dldp_pgoqMakeSafeThreads(dldp_p*, randomGeneratorContext*, size_t, int);
+BEECRYPTAPI
 int dldp_pgoqGenerator(dldp_p*, randomGeneratorContext*);
 BEECRYPTAPI
 int  dldp_pgoqValidate (const dldp_p*, randomGeneratorContext*, int);
@@ -154,6 +176,8 @@ int dldp_pgonMake     (dldp_p*, randomGeneratorContext*, size_t, size_t);
 BEECRYPTAPI
 int dldp_pgonMakeSafe (dldp_p*, randomGeneratorContext*, size_t);
 BEECRYPTAPI
+int dldp_pgonMakeSafeThreads(dldp_p*, randomGeneratorContext*, size_t, int);
+BEECRYPTAPI
 int dldp_pgonGenerator(dldp_p*, randomGeneratorContext*);
 BEECRYPTAPI
 int dldp_pgonValidate (const dldp_p*, randomGeneratorContext*);
@@ -38,6 +38,13 @@ typedef dldp_p dsaparam;
 typedef dlpk_p dsapub;
 typedef dlkp_p dsakp;
 
+/*!\brief The number of words of workspace dsasign_w needs for \a p of \a psize and \a q of \a qsize words.
+ */
+#define DSASIGN_WKSP(psize, qsize)	(5*(psize)+9*(qsize)+8)
+/*!\brief The number of words of workspace dsavrfy_w needs for \a p of \a psize and \a q of \a qsize words.
+ */
+#define DSAVRFY_WKSP(psize, qsize)	(6*(psize)+8*(qsize)+8)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -64,6 +71,26 @@ extern "C" {
 BEECRYPTAPI
 int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
 
+/*!\fn int dsasign_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+ * \brief This function performs a raw DSA signature, in workspace supplied
+ *  by the caller.
+ * \see dsasign
+ * \param wksp Workspace of DSASIGN_WKSP(p->size, q->size) words.
+ */
+BEECRYPTAPI
+int dsasign_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp);
+
+/*!\fn int dsasign_dp(const dsaparam* dp, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+ * \brief This function performs a raw DSA signature with the parameters in
+ *  \a dp, using its precomputed powers of \e g if dldp_pgCombMake was
+ *  called on it.
+ * \see dsasign
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int dsasign_dp(const dsaparam* dp, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
+
 /*!\fn int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
  * \brief This function performs a raw DSA verification.
  *
@@ -88,6 +115,15 @@ int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGen
 BEECRYPTAPI
 int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s);
 
+/*!\fn int dsavrfy_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
+ * \brief This function performs a raw DSA verification, in workspace
+ *  supplied by the caller.
+ * \see dsavrfy
+ * \param wksp Workspace of DSAVRFY_WKSP(p->size, q->size) words.
+ */
+BEECRYPTAPI
+int dsavrfy_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp);
+
 /*!\fn int dsaparamMake(dsaparam* dp, randomGeneratorContext* rgc, size_t psize)
  * \brief This function generates a set of DSA parameters.
  *
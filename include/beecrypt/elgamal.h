@@ -28,9 +28,6 @@
  *
  * \todo Implement ElGamal encryption and decryption.
  *
- * \todo Explore the possibility of using simultaneous multiple exponentiation,
- *       as described in HAC, 14.87 (iii).
- *
  * \author Bob Deblier <bob.deblier@telenet.be>
  * \ingroup DL_m DL_elgamal_m
  */
@@ -39,6 +36,7 @@
 #define _ELGAMAL_H
 
 #include "beecrypt/mpbarrett.h"
+#include "beecrypt/dldp.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -134,6 +132,25 @@ int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 BEECRYPTAPI
 int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s);
 
+/*!\fn int elgv1sign_dp(const dldp_p* dp, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+ * \brief This function performs raw ElGamal signing, variant 1, with the
+ *  parameters in \a dp.
+ *
+ * Since \e k is chosen modulo \f$(p-1)\f$, the precomputed powers of \e g
+ * are only used if dldp_pgCombMake was called with the full size of \e p.
+ * \see elgv1sign
+ */
+BEECRYPTAPI
+int elgv1sign_dp(const dldp_p* dp, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
+
+/*!\fn int elgv3sign_dp(const dldp_p* dp, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+ * \brief This function performs raw ElGamal signing, variant 3, with the
+ *  parameters in \a dp.
+ * \see elgv1sign_dp
+ */
+BEECRYPTAPI
+int elgv3sign_dp(const dldp_p* dp, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
+
 #ifdef __cplusplus
 }
 #endif
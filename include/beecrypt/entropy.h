@@ -20,7 +20,7 @@
 /*!\file entropy.h
  * \brief Entropy sources, headers.
  * \author Bob Deblier <bob.deblier@telenet.be>
- * \ingroup ES_m ES_audio_m ES_dsp_m ES_random_m ES_urandom_m ES_tty_m
+ * \ingroup ES_m ES_audio_m ES_dsp_m ES_getrandom_m ES_random_m ES_urandom_m ES_tty_m
  */
 
 #ifndef _ENTROPY_H
@@ -64,6 +64,14 @@ int entropy_dev_urandom(byte*, size_t);
 #if HAVE_DEV_TTY
 int entropy_dev_tty    (byte*, size_t);
 #endif
+#if HAVE_SYS_GETRANDOM
+/*!\fn int entropy_getrandom(byte* data, size_t size)
+ * \brief Gathers entropy with the Linux getrandom(2) system call; where
+ *  the running kernel doesn't implement it, it falls back to /dev/urandom.
+ * \ingroup ES_getrandom_m
+ */
+int entropy_getrandom  (byte*, size_t);
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file entropysys.h
+ * \brief Detection of the system's entropy interfaces, used internally.
+ *
+ * This header must be included after config.h and before entropy.h, so
+ * that the entropy sources and their declarations agree on what the
+ * system provides.
+ *
+ * \ingroup ES_m
+ */
+
+#ifndef _ENTROPYSYS_H
+#define _ENTROPYSYS_H
+
+#if defined(__linux__)
+# include <sys/syscall.h>
+# if defined(SYS_getrandom) && HAVE_ERRNO_H
+#  define HAVE_SYS_GETRANDOM 1
+# endif
+#endif
+
+#endif
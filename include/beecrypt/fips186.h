@@ -79,6 +79,11 @@ BEECRYPTAPI
 int fips186Seed   (fips186Param*, const byte*, size_t);
 BEECRYPTAPI
 int fips186Next   (fips186Param*, byte*, size_t);
+/* the unlocked variants are for generators which only one thread uses */
+BEECRYPTAPI
+int fips186SeedUnlocked(fips186Param*, const byte*, size_t);
+BEECRYPTAPI
+int fips186NextUnlocked(fips186Param*, byte*, size_t);
 BEECRYPTAPI
 int fips186Cleanup(fips186Param*);
 
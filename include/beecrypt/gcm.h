@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file gcm.h
+ * \brief Galois/Counter Mode, as specified by NIST SP 800-38D, headers.
+ *
+ * GCM works on top of a blockCipherContext with a block size of 128 bits,
+ * which must be set up for encryption, also when decrypting.
+ *
+ * Usage: gcmContextInit, gcmContextSetIV, any number of calls to
+ * gcmContextUpdateAAD, any number of calls to either gcmContextEncrypt or
+ * gcmContextDecrypt, and finally gcmContextDigest or gcmContextVerify.
+ * Calling gcmContextSetIV again starts a new message with the same key;
+ * until it's called, all other operations fail. An IV must never be used
+ * twice for encryption under the same key.
+ *
+ * \ingroup BC_m
+ */
+
+#ifndef _GCM_H
+#define _GCM_H
+
+#include "beecrypt/beecrypt.h"
+
+/*!\brief The number of blocks which GCM encrypts at once.
+ */
+#define GCM_BLOCKS	8
+
+/*!\brief Holds the state of a GCM encryption or decryption.
+ * \ingroup BC_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI gcmContext
+#else
+struct _gcmContext
+#endif
+{
+	/*!\var cipher
+	 * \brief The underlying block cipher; not owned by the gcmContext.
+	 */
+	blockCipherContext* cipher;
+	/*!\var htable
+	 * \brief The products of the hash subkey H with all 4-bit values, for
+	 *  the generic GHASH code; each entry holds the most significant half
+	 *  first.
+	 */
+	uint64_t htable[16][2];
+	/*!\var h
+	 * \brief The hash subkey H.
+	 */
+	uint64_t h[2];
+	/*!\var x
+	 * \brief The GHASH accumulator.
+	 */
+	uint64_t x[2];
+	/*!\var ej0
+	 * \brief The encrypted pre-counter block, which masks the tag.
+	 */
+	uint32_t ej0[4];
+	/*!\var ctr
+	 * \brief The next counter block.
+	 */
+	uint32_t ctr[4];
+	/*!\var ks
+	 * \brief Keystream and counter buffer.
+	 */
+	uint32_t ks[4*GCM_BLOCKS];
+	/*!\var partial
+	 * \brief The incomplete last block of AAD or ciphertext, to be hashed.
+	 */
+	byte partial[16];
+	/*!\var aadlength
+	 * \brief The number of AAD bytes processed.
+	 */
+	uint64_t aadlength;
+	/*!\var textlength
+	 * \brief The number of text bytes processed.
+	 */
+	uint64_t textlength;
+	/*!\var started
+	 * \brief Set by gcmContextSetIV, and cleared when the message is
+	 *  finished.
+	 */
+	int started;
+};
+
+#ifndef __cplusplus
+typedef struct _gcmContext gcmContext;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn int gcmContextInit(gcmContext* ctxt, blockCipherContext* cipher)
+ * \brief This function initializes a GCM context on top of a block cipher
+ *  context, which must already have been set up for encryption; the
+ *  first message is started with gcmContextSetIV.
+ * \param ctxt The GCM context.
+ * \param cipher The block cipher context.
+ * \retval 0 on success.
+ * \retval -1 if the block size isn't 128 bits, or the cipher isn't set up for encryption.
+ */
+BEECRYPTAPI
+int gcmContextInit(gcmContext* ctxt, blockCipherContext* cipher);
+
+/*!\fn int gcmContextFree(gcmContext* ctxt)
+ * \brief This function wipes a GCM context; the block cipher context is
+ *  left alone.
+ * \param ctxt The GCM context.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int gcmContextFree(gcmContext* ctxt);
+
+/*!\fn int gcmContextSetIV(gcmContext* ctxt, const byte* iv, size_t ivlen)
+ * \brief This function starts a new message with the given IV.
+ * \param ctxt The GCM context.
+ * \param iv The IV; 96 bits is recommended.
+ * \param ivlen The length of the IV in bytes; must be at least one.
+ * \retval 0 on success.
+ * \retval -1 if iv is null or ivlen is zero; the context is left as it was.
+ */
+BEECRYPTAPI
+int gcmContextSetIV(gcmContext* ctxt, const byte* iv, size_t ivlen);
+
+/*!\fn int gcmContextUpdateAAD(gcmContext* ctxt, const byte* data, size_t size)
+ * \brief This function adds additional authenticated data to the message.
+ * \param ctxt The GCM context.
+ * \param data The data.
+ * \param size The size of the data in bytes.
+ * \retval 0 on success.
+ * \retval -1 if no message was started, or encryption or decryption has
+ *  already started.
+ */
+BEECRYPTAPI
+int gcmContextUpdateAAD(gcmContext* ctxt, const byte* data, size_t size);
+
+/*!\fn int gcmContextEncrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size)
+ * \brief This function encrypts the next part of the message.
+ * \param ctxt The GCM context.
+ * \param dst The ciphertext; may be equal to src.
+ * \param src The cleartext.
+ * \param size The size in bytes; needn't be a multiple of the block size.
+ * \retval 0 on success.
+ * \retval -1 if no message was started, or the message becomes too long.
+ */
+BEECRYPTAPI
+int gcmContextEncrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size);
+
+/*!\fn int gcmContextDecrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size)
+ * \brief This function decrypts the next part of the message.
+ * \warning The cleartext mustn't be trusted until gcmContextVerify has
+ *  succeeded.
+ * \param ctxt The GCM context.
+ * \param dst The cleartext; may be equal to src.
+ * \param src The ciphertext.
+ * \param size The size in bytes; needn't be a multiple of the block size.
+ * \retval 0 on success.
+ * \retval -1 if no message was started, or the message becomes too long.
+ */
+BEECRYPTAPI
+int gcmContextDecrypt(gcmContext* ctxt, byte* dst, const byte* src, size_t size);
+
+/*!\fn int gcmContextDigest(gcmContext* ctxt, byte* tag, size_t taglen)
+ * \brief This function finishes the message and computes its tag; the
+ *  next message needs a call to gcmContextSetIV.
+ * \param ctxt The GCM context.
+ * \param tag The tag.
+ * \param taglen The length of the tag in bytes: 4, 8, or 12 to 16, as
+ *  NIST SP 800-38D allows.
+ * \retval 0 on success.
+ * \retval -1 on failure, also if the tag length isn't allowed; the
+ *  message is then left unfinished.
+ */
+BEECRYPTAPI
+int gcmContextDigest(gcmContext* ctxt, byte* tag, size_t taglen);
+
+/*!\fn int gcmContextVerify(gcmContext* ctxt, const byte* tag, size_t taglen)
+ * \brief This function finishes the message and checks its tag, in
+ *  constant time.
+ * \param ctxt The GCM context.
+ * \param tag The expected tag.
+ * \param taglen The length of the tag in bytes: 4, 8, or 12 to 16, as
+ *  NIST SP 800-38D allows.
+ * \retval 1 if the tag matches.
+ * \retval 0 otherwise, also if no message was started or the tag length
+ *  isn't allowed.
+ */
+BEECRYPTAPI
+int gcmContextVerify(gcmContext* ctxt, const byte* tag, size_t taglen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
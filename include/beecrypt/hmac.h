@@ -37,14 +37,25 @@ extern "C" {
 
 /* not used directly as keyed hash function, but instead used as generic methods */
 
+/* the first two arguments of hmacSetup receive the hash states after absorbing
+ * the inner and outer pads; hmacReset and hmacDigest start from these states */
+
+BEECRYPTAPI
+int hmacSetup (      hashFunctionParam*,       hashFunctionParam*, const hashFunction*, hashFunctionParam*, const byte*, size_t);
 BEECRYPTAPI
-int hmacSetup (      byte*,       byte*, const hashFunction*, hashFunctionParam*, const byte*, size_t);
+int hmacReset (const hashFunctionParam*,                           const hashFunction*, hashFunctionParam*);
 BEECRYPTAPI
-int hmacReset (const byte*,              const hashFunction*, hashFunctionParam*);
+int hmacUpdate(                                                    const hashFunction*, hashFunctionParam*, const byte*, size_t);
 BEECRYPTAPI
-int hmacUpdate(                          const hashFunction*, hashFunctionParam*, const byte*, size_t);
+int hmacDigest(                          const hashFunctionParam*, const hashFunction*, hashFunctionParam*, byte*);
+
+/* hmacBatchIterate runs count independent chains of U = HMAC(U), T ^= U, as
+ * in PBKDF2, using the states from hmacSetup; U and T each hold count digests
+ * one after another; MD5, SHA-1, SHA-224 and SHA-256 are supported, other hash
+ * functions make it return -1 */
+
 BEECRYPTAPI
-int hmacDigest(             const byte*, const hashFunction*, hashFunctionParam*, byte*);
+int hmacBatchIterate(const hashFunction*, const hashFunctionParam*, const hashFunctionParam*, byte*, byte*, size_t, size_t);
 
 #ifdef __cplusplus
 }
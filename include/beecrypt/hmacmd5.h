@@ -34,8 +34,8 @@
 typedef struct
 {
 	md5Param mparam;
-	byte kxi[64];
-	byte kxo[64];
+	md5Param istate;
+	md5Param ostate;
 } hmacmd5Param;
 
 #ifdef __cplusplus
@@ -34,8 +34,8 @@
 typedef struct
 {
 	sha1Param sparam;
-	byte kxi[64];
-	byte kxo[64];
+	sha1Param istate;
+	sha1Param ostate;
 } hmacsha1Param;
 
 #ifdef __cplusplus
@@ -34,8 +34,8 @@
 typedef struct
 {
 	sha224Param sparam;
-	byte kxi[64];
-	byte kxo[64];
+	sha224Param istate;
+	sha224Param ostate;
 } hmacsha224Param;
 
 #ifdef __cplusplus
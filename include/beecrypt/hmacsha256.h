@@ -34,8 +34,8 @@
 typedef struct
 {
 	sha256Param sparam;
-	byte kxi[64];
-	byte kxo[64];
+	sha256Param istate;
+	sha256Param ostate;
 } hmacsha256Param;
 
 #ifdef __cplusplus
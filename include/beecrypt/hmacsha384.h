@@ -34,8 +34,8 @@
 typedef struct
 {
 	sha384Param sparam;
-	byte kxi[128];
-	byte kxo[128];
+	sha384Param istate;
+	sha384Param ostate;
 } hmacsha384Param;
 
 #ifdef __cplusplus
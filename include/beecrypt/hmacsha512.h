@@ -34,8 +34,8 @@
 typedef struct
 {
 	sha512Param sparam;
-	byte kxi[128];
-	byte kxo[128];
+	sha512Param istate;
+	sha512Param ostate;
 } hmacsha512Param;
 
 #ifdef __cplusplus
@@ -70,6 +70,21 @@
 #define MP_LSBMASK	 ((mpw) 0x1)
 #define MP_ALLMASK	~((mpw) 0x0)
 
+/*!\brief The operand size in words from which mpmul switches to Karatsuba multiplication.
+ *
+ * Below this size the schoolbook method is faster; the default can be
+ * overridden at configure time, e.g. with CPPFLAGS=-DMP_KARATSUBA_MUL_THRESHOLD=n.
+ */
+#ifndef MP_KARATSUBA_MUL_THRESHOLD
+# define MP_KARATSUBA_MUL_THRESHOLD	24
+#endif
+
+/*!\brief The operand size in words from which mpsqr switches to Karatsuba squaring.
+ */
+#ifndef MP_KARATSUBA_SQR_THRESHOLD
+# define MP_KARATSUBA_SQR_THRESHOLD	32
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -674,6 +689,44 @@ void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw*
 BEECRYPTAPI
 void mpsqr(mpw* result, size_t size, const mpw* data);
 
+/*!\fn size_t mpkmulwksp(size_t size)
+ * \brief This function returns the number of workspace words needed by
+ *  mpkmul_w for operands of the given size.
+ */
+BEECRYPTAPI
+size_t mpkmulwksp(size_t size);
+
+/*!\fn size_t mpksqrwksp(size_t size)
+ * \brief This function returns the number of workspace words needed by
+ *  mpksqr_w for an operand of the given size.
+ */
+BEECRYPTAPI
+size_t mpksqrwksp(size_t size);
+
+/*!\fn void mpkmul_w(mpw* result, size_t size, const mpw* xdata, const mpw* ydata, mpw* wksp)
+ * \brief This function computes a full multi-precision product of two
+ *  equally sized integers, using Karatsuba's method above
+ *  MP_KARATSUBA_MUL_THRESHOLD words.
+ * \param result The place where the (2*size) word product will be stored.
+ * \param size The size of the multi-precision integers.
+ * \param xdata The first multi-precision integer.
+ * \param ydata The second multi-precision integer.
+ * \param wksp The workspace; needs mpkmulwksp(size) words.
+ */
+BEECRYPTAPI
+void mpkmul_w(mpw* result, size_t size, const mpw* xdata, const mpw* ydata, mpw* wksp);
+
+/*!\fn void mpksqr_w(mpw* result, size_t size, const mpw* xdata, mpw* wksp)
+ * \brief This function computes a full multi-precision square, using
+ *  Karatsuba's method above MP_KARATSUBA_SQR_THRESHOLD words.
+ * \param result The place where the (2*size) word square will be stored.
+ * \param size The size of the multi-precision integer.
+ * \param xdata The multi-precision integer.
+ * \param wksp The workspace; needs mpksqrwksp(size) words.
+ */
+BEECRYPTAPI
+void mpksqr_w(mpw* result, size_t size, const mpw* xdata, mpw* wksp);
+
 BEECRYPTAPI
 void mpgcd_w(size_t size, const mpw* xdata, const mpw* ydata, mpw* result, mpw* wksp);
 
@@ -119,12 +119,13 @@ void mpbpowmodsld_w(const mpbarrett*, const mpw*, size_t, const mpw*, mpw*, mpw*
 BEECRYPTAPI
 void mpbtwopowmod_w(const mpbarrett*, size_t, const mpw*, mpw*, mpw*);
 
+BEECRYPTAPI
+void mpbpowmod2_w(const mpbarrett*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+
 /* To be added:
- * simultaneous multiple exponentiation, for use in dsa and elgamal signature verification
+ * simultaneous multiple exponentiation with three bases
  */
 BEECRYPTAPI
-void mpbsm2powmod(const mpbarrett*, const mpw*, const mpw*, const mpw*, const mpw*);
-BEECRYPTAPI
 void mpbsm3powmod(const mpbarrett*, const mpw*, const mpw*, const mpw*, const mpw*, const mpw*, const mpw*);
 
 BEECRYPTAPI
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpmont.h
+ * \brief Multi-precision integer routines using Montgomery modular reduction, headers.
+ * \ingroup MP_m
+ */
+
+#ifndef _MPMONT_H
+#define _MPMONT_H
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpnumber.h"
+#include "beecrypt/mpbarrett.h"
+
+/*!\def MP_IFMA_POWMOD_THRESHOLD
+ * \brief The modulus size in words from which mpmontpowmod_w uses the
+ *  AVX-512 IFMA code, if the processor supports it.
+ *
+ * Below this size the cost of converting the operands outweighs the gain.
+ */
+#ifndef MP_IFMA_POWMOD_THRESHOLD
+# define MP_IFMA_POWMOD_THRESHOLD	10
+#endif
+
+/*!\brief Montgomery reduction context for an odd modulus.
+ *
+ * With \f$R=2^{size \cdot MP\_WBITS}\f$, numbers in Montgomery form are
+ * represented as \f$xR\ \textrm{mod}\ n\f$.
+ *
+ * \ingroup MP_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI mpmont
+#else
+struct _mpmont
+#endif
+{
+	size_t	size;
+	mpw*	modl;	/* (size) words */
+	mpw*	rsqr;	/* (size) words; R^2 mod n */
+	mpw		ninv;	/* -inv(n) mod 2^MP_WBITS */
+};
+
+#ifndef __cplusplus
+typedef struct _mpmont mpmont;
+#endif
+
+/*!\brief Fixed-base comb table for Montgomery exponentiation.
+ *
+ * Holds precomputed powers of a fixed base g, which speed up the
+ * computation of \f$g^p\ \textrm{mod}\ n\f$ for exponents of up to
+ * \a bits bits; see mpmontcombset.
+ *
+ * \ingroup MP_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI mpmontcomb
+#else
+struct _mpmontcomb
+#endif
+{
+	mpmont	m;
+	size_t	bits;	/* maximum exponent size */
+	size_t	teeth;
+	size_t	span;	/* (bits+teeth-1)/teeth */
+	mpw*	base;	/* (size) words; the base g */
+	mpw*	table;	/* (2^teeth-1)*(size) words, in Montgomery form */
+};
+
+#ifndef __cplusplus
+typedef struct _mpmontcomb mpmontcomb;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BEECRYPTAPI
+void mpmontzero(mpmont*);
+BEECRYPTAPI
+void mpmontfree(mpmont*);
+BEECRYPTAPI
+int  mpmontset(mpmont*, size_t, const mpw*);
+BEECRYPTAPI
+int  mpmontsetb(mpmont*, const mpbarrett*);
+
+BEECRYPTAPI
+void mpmontredc_w(const mpmont*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontenter_w(const mpmont*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontleave_w(const mpmont*, const mpw*, mpw*, mpw*);
+
+BEECRYPTAPI
+void mpmontmulmod_w(const mpmont*, const mpw*, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontsqrmod_w(const mpmont*, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontpowmod_w(const mpmont*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontpowmod2_w(const mpmont*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+
+/*!\fn int mpmontifmapowmod(const mpmont* m, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result)
+ * \brief This function computes x^p mod n with AVX-512 IFMA instructions.
+ *
+ * The operands are converted to and from 52-bit digits at entry and exit.
+ * mpmontpowmod_w calls this function for moduli of at least
+ * MP_IFMA_POWMOD_THRESHOLD words, and falls back to the generic code if it
+ * fails.
+ *
+ * \param m The Montgomery modulus.
+ * \param xsize The size of x; must be <= m->size.
+ * \param xdata The base.
+ * \param psize The size of p.
+ * \param pdata The exponent.
+ * \param result The result, of m->size words.
+ * \retval 0 on success.
+ * \retval -1 if the processor or compiler doesn't support IFMA, if the
+ *  modulus is too large, or on memory allocation failure.
+ */
+BEECRYPTAPI
+int  mpmontifmapowmod(const mpmont*, size_t, const mpw*, size_t, const mpw*, mpw*);
+
+/* the next routines take mpnumbers as parameters */
+
+BEECRYPTAPI
+void mpmontnpowmod(const mpmont*, const mpnumber*, const mpnumber*, mpnumber*);
+
+/* the next routines take a Barrett modulus, and use Montgomery reduction if it is odd */
+
+BEECRYPTAPI
+void mpmontbpowmod_w(const mpbarrett*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontbpowmod2_w(const mpbarrett*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontbnpowmod(const mpbarrett*, const mpnumber*, const mpnumber*, mpnumber*);
+
+/* the next routines handle fixed-base comb tables */
+
+BEECRYPTAPI
+void mpmontcombzero(mpmontcomb*);
+BEECRYPTAPI
+void mpmontcombfree(mpmontcomb*);
+BEECRYPTAPI
+int  mpmontcombset(mpmontcomb*, const mpbarrett*, size_t, const mpw*, size_t);
+BEECRYPTAPI
+int  mpmontcombcopy(mpmontcomb*, const mpmontcomb*);
+BEECRYPTAPI
+int  mpmontcombmatch(const mpmontcomb*, const mpbarrett*, size_t, const mpw*);
+
+BEECRYPTAPI
+int  mpmontcombpowmod_w(const mpmontcomb*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontcombbpowmod_w(const mpmontcomb*, const mpbarrett*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontcombbnpowmod(const mpmontcomb*, const mpbarrett*, const mpnumber*, const mpnumber*, mpnumber*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,6 +32,11 @@
 
 extern mpw* mpspprod[SMALL_PRIMES_PRODUCT_MAX];
 
+/*!\brief Passed instead of a number of Miller-Rabin trials, selects the
+ *  Baillie-PSW test in the prime generation and testing functions.
+ */
+#define MPP_BPSW	(-1)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,14 +45,24 @@ BEECRYPTAPI
 int  mpptrials     (size_t);
 BEECRYPTAPI
 int  mppmilrab_w   (const mpbarrett*, randomGeneratorContext*, int, mpw*);
+BEECRYPTAPI
+int  mppbpsw_w     (const mpbarrett*, mpw*);
+BEECRYPTAPI
+int  mpptest_w     (const mpbarrett*, randomGeneratorContext*, int, mpw*);
 
 BEECRYPTAPI
 int  mpprnd_w      (mpbarrett*, randomGeneratorContext*, size_t, int, const mpnumber*, mpw*);
 BEECRYPTAPI
 int  mpprndr_w     (mpbarrett*, randomGeneratorContext*, size_t, int, const mpnumber*, const mpnumber*, const mpnumber*, mpw*);
 BEECRYPTAPI
+int  mpprndrstop_w (mpbarrett*, randomGeneratorContext*, size_t, int, const mpnumber*, const mpnumber*, const mpnumber*, const volatile int*, mpw*);
+BEECRYPTAPI
 void mpprndsafe_w  (mpbarrett*, randomGeneratorContext*, size_t, int, mpw*);
 BEECRYPTAPI
+int  mpprndsafestop_w(mpbarrett*, randomGeneratorContext*, size_t, int, const volatile int*, mpw*);
+BEECRYPTAPI
+int  mpprndsafethreads(mpbarrett*, randomGeneratorContext*, size_t, int, int);
+BEECRYPTAPI
 void mpprndcon_w   (mpbarrett*, randomGeneratorContext*, size_t, int, const mpnumber*, const mpnumber*, const mpnumber*, mpnumber*, mpw*);
 BEECRYPTAPI
 void mpprndconone_w(mpbarrett*, randomGeneratorContext*, size_t, int, const mpbarrett*, const mpnumber*, mpnumber*, int, mpw*);
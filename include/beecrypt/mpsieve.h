@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpsieve.h
+ * \brief Multi-precision prime candidate sieve, used internally.
+ * \ingroup MP_m
+ */
+
+#ifndef _MPSIEVE_H
+#define _MPSIEVE_H
+
+#include "beecrypt/mpbarrett.h"
+#include "beecrypt/mpnumber.h"
+
+/*
+ * The incremental search for primes sieves with the first MPP_SIEVE_PRIMES
+ * odd primes; each is less than 2^15, so that the product of two fits in
+ * 30 bits.
+ */
+#define MPP_SIEVE_PRIMES	2048
+/*
+ * The number of odd candidates in each window of the sieve
+ */
+#define MPP_SIEVE_WINDOW	4096
+/*
+ * Candidates of fewer bits could equal one of the sieving primes
+ */
+#define MPP_SIEVE_MINBITS	16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\var mppsieveprimes
+ * \brief The odd primes the sieve divides by, in increasing order.
+ */
+extern const uint16_t mppsieveprimes[MPP_SIEVE_PRIMES];
+
+/*!\fn void mppsieveres(size_t size, const mpw* xdata, uint16_t* res)
+ * \brief This function computes the residues of x modulo the sieving primes.
+ * \param size The size of x.
+ * \param xdata The data of x.
+ * \param res Receives MPP_SIEVE_PRIMES residues.
+ */
+void mppsieveres(size_t size, const mpw* xdata, uint16_t* res);
+
+/*!\fn void mppsieve(const uint16_t* res, byte* sieve, int safe)
+ * \brief This function marks the candidates x + 2k of a window which a
+ *  sieving prime divides.
+ * \param res The residues of x.
+ * \param sieve Receives MPP_SIEVE_WINDOW flags; sieve[k] is set if a
+ *  sieving prime divides x + 2k.
+ * \param safe If set, also marks the k for which a sieving prime divides
+ *  2(x + 2k) + 1.
+ */
+void mppsieve(const uint16_t* res, byte* sieve, int safe);
+
+/*!\fn void mppsievenext(uint16_t* res)
+ * \brief This function moves the residues of x on to those of
+ *  x + 2 * MPP_SIEVE_WINDOW, the start of the next window.
+ * \param res The residues.
+ */
+void mppsievenext(uint16_t* res);
+
+/*!\fn int mppinrange(const mpbarrett* p, size_t bits, const mpnumber* max, int carry)
+ * \brief This function checks that a candidate, after moving it upwards,
+ *  hasn't passed max or outgrown the requested number of bits.
+ * \param p The candidate.
+ * \param bits The number of bits the candidate may have, if max is null.
+ * \param max The largest allowed candidate, or null.
+ * \param carry The carry out of the addition which moved the candidate.
+ * \retval 1 if the candidate is in range, 0 if not.
+ */
+int mppinrange(const mpbarrett* p, size_t bits, const mpnumber* max, int carry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpslide.h
+ * \brief Multi-precision sliding window recoding, used internally.
+ * \ingroup MP_m
+ */
+
+#ifndef _MPSLIDE_H
+#define _MPSLIDE_H
+
+#include "beecrypt/mp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn void mpslidedigits(size_t psize, const mpw* pdata, size_t bits, byte* digits)
+ * \brief This function recodes the lower \a bits bits of an exponent into
+ *  sliding windows of up to four bits, for the simultaneous exponentiations
+ *  of mpbpowmod2_w and mpmontpowmod2_w.
+ * \param psize The exponent size.
+ * \param pdata The exponent data.
+ * \param bits The number of bits to recode.
+ * \param digits Receives \a bits values; digits[k] holds the odd window
+ *  value ending at bit k, or zero.
+ */
+void mpslidedigits(size_t psize, const mpw* pdata, size_t bits, byte* digits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpwksp.h
+ * \brief Multi-precision workspace cache, headers.
+ * \ingroup MP_m
+ */
+
+#ifndef _MPWKSP_H
+#define _MPWKSP_H
+
+#include "beecrypt/mp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn mpw* mpwkspget(size_t size)
+ * \brief This function returns scratch space of \a size words.
+ *
+ * The space comes from a cache kept by the calling thread, which grows to
+ * the largest size asked for and is released when the thread exits; this
+ * saves the public key primitives a malloc and free per call.
+ *
+ * Scratch space must be returned with mpwkspput in the reverse order in
+ * which it was obtained, and never with free. When the cache is in use and
+ * too small, or the request is very large, the space comes from malloc
+ * instead.
+ *
+ * \param size The number of words needed.
+ * \return The scratch space, or a null pointer if no memory is available.
+ */
+BEECRYPTAPI
+mpw* mpwkspget(size_t size);
+
+/*!\fn void mpwkspput(mpw* wksp)
+ * \brief This function wipes and returns scratch space obtained from
+ *  mpwkspget.
+ * \param wksp The scratch space.
+ */
+BEECRYPTAPI
+void mpwkspput(mpw* wksp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
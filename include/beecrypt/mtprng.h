@@ -82,6 +82,15 @@ int mtprngSeed   (mtprngParam* mp, const byte* data, size_t size);
 BEECRYPTAPI
 int mtprngNext   (mtprngParam* mp, byte* data, size_t size);
 
+/*
+ * The unlocked variants don't take the generator's lock; they are meant for
+ * generators which only one thread ever uses.
+ */
+BEECRYPTAPI
+int mtprngSeedUnlocked(mtprngParam* mp, const byte* data, size_t size);
+BEECRYPTAPI
+int mtprngNextUnlocked(mtprngParam* mp, byte* data, size_t size);
+
 /*
  */
 BEECRYPTAPI
@@ -39,6 +39,11 @@ extern "C" {
 BEECRYPTAPI
 int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize);
 
+/* derives the keys for count diversifiers at once; the hash chains run in
+ * parallel, and the data is only prepared once */
+BEECRYPTAPI
+int pkcs12_derive_keys(const hashFunction* h, const byte* ids, size_t count, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* const* ndata, const size_t* nsize);
+
 #ifdef __cplusplus
 }
 #endif
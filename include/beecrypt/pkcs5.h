@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file pkcs5.h
+ * \brief PKCS#5 password-based key derivation, headers.
+ * \ingroup PKCS5_m
+ */
+
+#ifndef _PKCS5_H
+#define _PKCS5_H
+
+#include "beecrypt/beecrypt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn int pkcs5_pbkdf2(const hashFunction* h, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+ * \brief Derives a key from a password with PBKDF2, using HMAC with hash
+ *  function \a h as the pseudo-random function.
+ * \param h The hash function.
+ * \param pdata The password.
+ * \param psize The size of the password in bytes.
+ * \param sdata The salt.
+ * \param ssize The size of the salt in bytes.
+ * \param iterationcount The iteration count.
+ * \param ndata The buffer which receives the key.
+ * \param nsize The size of the key in bytes.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int pkcs5_pbkdf2(const hashFunction* h, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file poolprng.h
+ * \brief Pools of pre-generated random bytes, headers.
+ * \ingroup PRNG_m PRNG_pool_m
+ */
+
+#ifndef _POOLPRNG_H
+#define _POOLPRNG_H
+
+#include "beecrypt/beecrypt.h"
+
+/*!\brief The default size of each of a thread's two buffers.
+ * \ingroup PRNG_pool_m
+ */
+#define POOLPRNG_BUFSIZE	4096
+
+/*!\brief The default number of bytes after which a pool reseeds its
+ *  generator from the entropy sources.
+ * \ingroup PRNG_pool_m
+ */
+#define POOLPRNG_RESEED		((size_t) 1 << 20)
+
+#ifdef __cplusplus
+struct randomPool;
+#else
+typedef struct _randomPool randomPool;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\var poolprng
+ * \brief A generator which takes its output from a process-wide pool.
+ *
+ * The pool is created when the first context is set up; it draws from the
+ * generator named by the environment variable BEECRYPT_RANDOM_POOL, or from
+ * the AES-256 CTR_DRBG if that isn't set, and uses the default sizes.
+ *
+ * \ingroup PRNG_pool_m
+ */
+extern BEECRYPTAPI const randomGenerator poolprng;
+
+/*!\fn randomPool* randomPoolAlloc(const randomGenerator* rng, size_t bufsize, size_t reseed)
+ * \brief Creates a pool of random bytes drawn from the given generator.
+ *
+ * Every thread which uses the pool gets two buffers of bufsize bytes. It
+ * copies its output from one, while a background thread refills the
+ * other; only when both are used up does a thread take the pool's lock.
+ *
+ * \param rng The generator which produces the bytes.
+ * \param bufsize The size of each buffer, or 0 for POOLPRNG_BUFSIZE.
+ * \param reseed The number of bytes after which the generator gets
+ *  reseeded from the entropy sources, or 0 to never reseed.
+ * \retval The new pool, or NULL on failure.
+ */
+BEECRYPTAPI
+randomPool* randomPoolAlloc(const randomGenerator* rng, size_t bufsize, size_t reseed);
+
+/*!\fn int randomPoolNext(randomPool* rp, byte* data, size_t size)
+ * \brief Takes random bytes from the pool.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int randomPoolNext(randomPool* rp, byte* data, size_t size);
+
+/*!\fn int randomPoolSeed(randomPool* rp, const byte* data, size_t size)
+ * \brief Seeds the pool's generator, and discards the buffers which
+ *  aren't in use.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int randomPoolSeed(randomPool* rp, const byte* data, size_t size);
+
+/*!\fn void randomPoolFree(randomPool* rp)
+ * \brief Stops the pool's background thread, and wipes and frees the pool.
+ */
+BEECRYPTAPI
+void randomPoolFree(randomPool* rp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
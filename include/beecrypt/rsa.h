@@ -28,6 +28,90 @@
 
 #include "beecrypt/rsakp.h"
 
+/*!\brief The number of words of workspace rsapub_w needs for a modulus of \a size words.
+ */
+#define RSAPUB_WKSP(size)			(4*(size)+2)
+/*!\brief The number of words of workspace rsapri_w needs for a modulus of \a size words.
+ */
+#define RSAPRI_WKSP(size)			(4*(size)+2)
+/*!\brief The number of words of workspace rsapricrt_w needs for primes of \a psize and \a qsize words.
+ */
+#define RSAPRICRT_WKSP(psize, qsize)	(6*(psize)+6*(qsize)+4)
+/*!\brief The number of words of workspace rsavrfy_w needs for a modulus of \a size words.
+ */
+#define RSAVRFY_WKSP(size)			(5*(size)+2)
+
+/*!\brief The smallest modulus, in bits, for which rsapricrt splits its
+ *  work under RSACRT_AUTO, unless the policy says otherwise.
+ */
+#define RSACRT_MINBITS				4096
+
+/*!\brief The ways in which rsapricrt can run its two exponentiations.
+ * \ingroup IF_rsa_m
+ */
+typedef enum
+{
+	/*!\brief Run both in the calling thread, unless the modulus has at
+	 *  least \a minbits bits and the callers, the busy workers of the
+	 *  library's pool and the queued jobs together are fewer than the
+	 *  online processors; the exponentiation modulo q then goes to an idle
+	 *  worker, or to a newly started one if the pool has fewer than
+	 *  \a threads workers. If neither is possible, both run in the
+	 *  calling thread after all.
+	 */
+	RSACRT_AUTO = 0,
+	/*!\brief Always run both in the calling thread. */
+	RSACRT_SERIAL,
+	/*!\brief Always hand the exponentiation modulo q to the library's
+	 *  pool; if no worker has taken it by the time the calling thread is
+	 *  done with its own half, the calling thread runs it as well.
+	 */
+	RSACRT_POOL,
+	/*!\brief Run both with the executor set by the caller. */
+	RSACRT_EXECUTOR
+} rsacrtmode;
+
+/*!\brief A task given to an rsacrtexecutor.
+ */
+typedef void (*rsacrttask)(void* arg);
+
+/*!\brief An executor supplied by the caller.
+ *
+ * It must call \a task once for each of the \a count arguments, in any
+ * order and on any threads, and return 0 when all of these calls have
+ * returned. If it can't do so, it must return non-zero without having
+ * called \a task at all; rsapricrt then runs the tasks itself.
+ */
+typedef int (*rsacrtexecutor)(void* param, rsacrttask task, void* args[], size_t count);
+
+/*!\brief The execution policy of rsapricrt.
+ * \ingroup IF_rsa_m
+ */
+typedef struct
+{
+	/*!\var mode
+	 * \brief How the exponentiations are run.
+	 */
+	rsacrtmode		mode;
+	/*!\var minbits
+	 * \brief The smallest modulus RSACRT_AUTO splits, or 0 for RSACRT_MINBITS.
+	 */
+	size_t			minbits;
+	/*!\var threads
+	 * \brief The number of threads in the pool, or 0 for one less than
+	 *  the number of online processors.
+	 */
+	int				threads;
+	/*!\var executor
+	 * \brief The executor for RSACRT_EXECUTOR.
+	 */
+	rsacrtexecutor	executor;
+	/*!\var param
+	 * \brief The first argument passed to the executor.
+	 */
+	void*			param;
+} rsacrtpolicy;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -51,6 +135,16 @@ BEECRYPTAPI
 int rsapub(const mpbarrett* n, const mpnumber* e,
            const mpnumber* m, mpnumber* c);
 
+/*!\fn int rsapub_w(const mpbarrett* n, const mpnumber* e, const mpnumber* m, mpnumber* c, mpw* wksp)
+ * \brief This function performs a raw RSA public key operation, in
+ *  workspace supplied by the caller.
+ * \see rsapub
+ * \param wksp Workspace of RSAPUB_WKSP(n->size) words.
+ */
+BEECRYPTAPI
+int rsapub_w(const mpbarrett* n, const mpnumber* e,
+             const mpnumber* m, mpnumber* c, mpw* wksp);
+
 /*!\fn int rsapri(const mpbarrett* n, const mpnumber* d, const mpnumber* c, mpnumber* m)
  * \brief This function performs a raw RSA private key operation.
  *
@@ -70,6 +164,16 @@ BEECRYPTAPI
 int rsapri(const mpbarrett* n, const mpnumber* d,
            const mpnumber* c, mpnumber* m);
 
+/*!\fn int rsapri_w(const mpbarrett* n, const mpnumber* d, const mpnumber* c, mpnumber* m, mpw* wksp)
+ * \brief This function performs a raw RSA private key operation, in
+ *  workspace supplied by the caller.
+ * \see rsapri
+ * \param wksp Workspace of RSAPRI_WKSP(n->size) words.
+ */
+BEECRYPTAPI
+int rsapri_w(const mpbarrett* n, const mpnumber* d,
+             const mpnumber* c, mpnumber* m, mpw* wksp);
+
 /*!\fn int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q, const mpnumber* dp, const mpnumber* dq, const mpnumber* qi, const mpnumber* c, mpnumber* m)
  *
  * \brief This function performs a raw RSA private key operation, with
@@ -81,6 +185,8 @@ int rsapri(const mpbarrett* n, const mpnumber* d,
  * \li \f$h=qi \cdot (j_1-j_2)\ \textrm{mod}\ p\f$
  * \li \f$m=j_2+hq\f$
  *
+ * The first two steps may run on separate threads; see rsacrtSetPolicy.
+ *
  * \param n The modulus.
  * \param p The first prime factor.
  * \param q The second prime factor.
@@ -97,6 +203,18 @@ int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
               const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
               const mpnumber* c, mpnumber* m);
 
+/*!\fn int rsapricrt_w(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q, const mpnumber* dp, const mpnumber* dq, const mpnumber* qi, const mpnumber* c, mpnumber* m, mpw* wksp)
+ * \brief This function performs a raw RSA private key operation, with
+ *  application of the Chinese Remainder Theorem, in workspace supplied by
+ *  the caller.
+ * \see rsapricrt
+ * \param wksp Workspace of RSAPRICRT_WKSP(p->size, q->size) words.
+ */
+BEECRYPTAPI
+int rsapricrt_w(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
+                const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
+                const mpnumber* c, mpnumber* m, mpw* wksp);
+
 /*!\fn int rsavrfy(const mpbarrett* n, const mpnumber* e, const mpnumber* m, const mpnumber* c)
  * \brief This function performs a raw RSA verification.
  *
@@ -114,6 +232,44 @@ BEECRYPTAPI
 int rsavrfy(const mpbarrett* n, const mpnumber* e,
             const mpnumber* m, const mpnumber* c);
 
+/*!\fn int rsavrfy_w(const mpbarrett* n, const mpnumber* e, const mpnumber* m, const mpnumber* c, mpw* wksp)
+ * \brief This function performs a raw RSA verification, in workspace
+ *  supplied by the caller.
+ * \see rsavrfy
+ * \param wksp Workspace of RSAVRFY_WKSP(n->size) words.
+ */
+BEECRYPTAPI
+int rsavrfy_w(const mpbarrett* n, const mpnumber* e,
+              const mpnumber* m, const mpnumber* c, mpw* wksp);
+
+/*!\fn int rsacrtGetPolicy(rsacrtpolicy* policy)
+ * \brief This function retrieves the execution policy of rsapricrt.
+ * \param policy The policy.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int rsacrtGetPolicy(rsacrtpolicy* policy);
+
+/*!\fn int rsacrtSetPolicy(const rsacrtpolicy* policy)
+ * \brief This function sets the execution policy of rsapricrt, for all
+ *  threads of the process.
+ *
+ * The default policy is RSACRT_AUTO, with the default number of threads
+ * and RSACRT_MINBITS. The pool's threads are only started once a private
+ * key operation needs them; lowering the number of threads lets the
+ * surplus ones exit.
+ *
+ * Without thread support, RSACRT_AUTO and RSACRT_POOL are the same as
+ * RSACRT_SERIAL.
+ *
+ * \param policy The policy.
+ * \retval 0 on success.
+ * \retval -1 if the policy is invalid.
+ */
+BEECRYPTAPI
+int rsacrtSetPolicy(const rsacrtpolicy* policy);
+
 #ifdef __cplusplus
 }
 #endif
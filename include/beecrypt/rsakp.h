@@ -91,6 +91,31 @@ extern "C" {
 
 BEECRYPTAPI
 int rsakpMake(rsakp*, randomGeneratorContext*, size_t);
+/*!\fn int rsakpMakeThreads(rsakp* kp, randomGeneratorContext* rgc, size_t bits, int threads)
+ * \brief Generates an RSA keypair, searching for the primes on several
+ *  threads.
+ *
+ * Half of the threads start on p and the other half on q; when one of the
+ * primes is found, the searches for it are stopped and their threads move
+ * over to the other prime. Both primes are at least \f$\sqrt{2}\cdot2^{k-1}\f$,
+ * where k is their number of bits, so that the two searches don't depend
+ * on each other.
+ *
+ * The random generator is used by all threads at the same time; all of
+ * BeeCrypt's generators are safe to use in that way.
+ *
+ * Without thread support, or with fewer than two threads, this function
+ * is the same as rsakpMake.
+ *
+ * \param kp The keypair; e may be preset, otherwise it will be 65537.
+ * \param rgc The random generator context.
+ * \param bits The size of the modulus.
+ * \param threads The number of threads, or 0 for one per online processor.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int rsakpMakeThreads(rsakp* kp, randomGeneratorContext* rgc, size_t bits, int threads);
 BEECRYPTAPI
 int rsakpInit(rsakp*);
 BEECRYPTAPI
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file sfmt.h
+ * \brief SIMD-oriented Fast Mersenne Twister pseudo-random number generator,
+ *  headers.
+ * \ingroup PRNG_m PRNG_mt_m
+ */
+
+#ifndef _SFMT_H
+#define _SFMT_H
+
+#include "beecrypt/beecrypt.h"
+
+#ifdef _REENTRANT
+# if WIN32
+#  include <windows.h>
+#  include <winbase.h>
+# endif
+#endif
+
+/*!\brief The number of 128-bit words in the state of SFMT19937.
+ * \ingroup PRNG_mt_m
+ */
+#define SFMT_N		156
+
+/*!\brief The number of 32-bit words in the state of SFMT19937.
+ * \ingroup PRNG_mt_m
+ */
+#define SFMT_N32	(SFMT_N * 4)
+
+/*!\ingroup PRNG_mt_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI sfmtParam
+#else
+struct _sfmtParam
+#endif
+{
+	/*!\var state
+	 * \brief The most recently generated block of 128-bit words.
+	 */
+	uint32_t	state[SFMT_N32];
+	/*!\var idx
+	 * \brief The index of the next 32-bit word of state to hand out.
+	 */
+	uint32_t	idx;
+	#ifdef _REENTRANT
+	bc_mutex_t	lock;
+	#endif
+};
+
+#ifndef __cplusplus
+typedef struct _sfmtParam sfmtParam;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\var sfmtprng
+ * \brief The SFMT19937 generator of Saito and Matsumoto.
+ *
+ * Seeding initializes the state from the data, taken as 32-bit words in
+ * host byte order, in the same way as the reference implementation's
+ * init_by_array; the same seed always gives the same output.
+ *
+ * \warning Like the Mersenne Twister, this generator is not suitable for
+ *  cryptography.
+ * \ingroup PRNG_mt_m
+ */
+extern BEECRYPTAPI const randomGenerator sfmtprng;
+
+BEECRYPTAPI
+int sfmtSetup  (sfmtParam* sp);
+BEECRYPTAPI
+int sfmtSeed   (sfmtParam* sp, const byte* data, size_t size);
+BEECRYPTAPI
+int sfmtNext   (sfmtParam* sp, byte* data, size_t size);
+BEECRYPTAPI
+int sfmtCleanup(sfmtParam* sp);
+
+/*
+ * The unlocked variants don't take the generator's lock; they are meant for
+ * generators which only one thread ever uses.
+ */
+BEECRYPTAPI
+int sfmtSeedUnlocked(sfmtParam* sp, const byte* data, size_t size);
+BEECRYPTAPI
+int sfmtNextUnlocked(sfmtParam* sp, byte* data, size_t size);
+
+/*!\fn int sfmtJump(sfmtParam* sp, uint64_t steps)
+ * \brief Advances the generator as if it had produced steps 128-bit words,
+ *  i.e. 16 * steps bytes.
+ *
+ * Independent streams for several threads come from generators seeded
+ * alike, of which the i-th is jumped i times by the same distance; with a
+ * distance of 2^63 steps or so, the streams provably won't overlap for any
+ * feasible amount of output. Each thread can then use its stream with
+ * sfmtNextUnlocked.
+ *
+ * A jump computes x^steps modulo the characteristic polynomial of the
+ * generator, and applies it to the state; it takes up to a tenth of a
+ * second or so, depending on the distance.
+ *
+ * \param sp The generator's parameters.
+ * \param steps The number of 128-bit words to skip.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int sfmtJump(sfmtParam* sp, uint64_t steps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file shani.h
+ * \brief SHA-1 and SHA-256 compression with the x86 SHA extensions, headers.
+ * \ingroup HASH_sha1_m HASH_sha256_m HASH_sha224_m
+ */
+
+#ifndef _SHANI_H
+#define _SHANI_H
+
+#include "beecrypt/beecrypt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn int shaniSha1Blocks(uint32_t* h, const byte* data, size_t nblocks)
+ * \brief This function runs the SHA-1 compression function over whole
+ *  64-byte blocks, with the SHA extensions.
+ * \param h The five state words.
+ * \param data The message blocks, in their original byte order.
+ * \param nblocks The number of blocks.
+ * \retval 0 on success.
+ * \retval -1 if the processor doesn't have the SHA extensions.
+ */
+BEECRYPTAPI
+int shaniSha1Blocks(uint32_t* h, const byte* data, size_t nblocks);
+
+/*!\fn int shaniSha256Blocks(uint32_t* h, const byte* data, size_t nblocks)
+ * \brief This function runs the SHA-256 compression function over whole
+ *  64-byte blocks, with the SHA extensions; SHA-224 uses it too.
+ * \param h The eight state words.
+ * \param data The message blocks, in their original byte order.
+ * \param nblocks The number of blocks.
+ * \retval 0 on success.
+ * \retval -1 if the processor doesn't have the SHA extensions.
+ */
+BEECRYPTAPI
+int shaniSha256Blocks(uint32_t* h, const byte* data, size_t nblocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file threadprng.h
+ * \brief Per-thread pseudo-random number generators, headers.
+ * \ingroup PRNG_m
+ */
+
+#ifndef _THREADPRNG_H
+#define _THREADPRNG_H
+
+#include "beecrypt/beecrypt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\var fips186threadprng
+ * \brief A FIPS 186 generator with a separate state in every thread.
+ *
+ * Each thread gets its own generator state the first time it asks for
+ * random data; the state is seeded from a shared FIPS 186 generator, after
+ * which the thread never takes a lock to produce output. Seeding a context
+ * only affects the state of the calling thread.
+ *
+ * The contexts don't carry any parameters, so any number of them can be
+ * used by any number of threads.
+ */
+extern BEECRYPTAPI const randomGenerator fips186threadprng;
+
+/*!\var mtthreadprng
+ * \brief A Mersenne Twister generator with a separate state in every thread.
+ *
+ * Works like fips186threadprng.
+ */
+extern BEECRYPTAPI const randomGenerator mtthreadprng;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
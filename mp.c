@@ -31,6 +31,7 @@
 
 #include "beecrypt/mp.h"
 #include "beecrypt/mpopt.h"
+#include "beecrypt/mpwksp.h"
 
 #ifndef ASM_MPZERO
 void mpzero(size_t size, mpw* data)
@@ -753,8 +754,11 @@ mpw mpaddmul(size_t size, mpw* result, const mpw* data, mpw y)
 }
 #endif
 
-#ifndef ASM_MPMUL
-void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
+/*
+ * mpbasemul
+ *  schoolbook multiplication; the base case of the Karatsuba recursion
+ */
+static void mpbasemul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
 {
 	/* preferred passing of parameters is x the larger of the two numbers */
 	if (xsize >= ysize)
@@ -790,7 +794,6 @@ void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw*
 		}
 	}
 }
-#endif
 
 #ifndef ASM_MPADDSQRTRC
 void mpaddsqrtrc(size_t size, mpw* result, const mpw* data)
@@ -854,8 +857,11 @@ void mpaddsqrtrc(size_t size, mpw* result, const mpw* data)
 }
 #endif
 
-#ifndef ASM_MPSQR
-void mpsqr(mpw* result, size_t size, const mpw* data)
+/*
+ * mpbasesqr
+ *  schoolbook squaring; the base case of the Karatsuba recursion
+ */
+static void mpbasesqr(mpw* result, size_t size, const mpw* data)
 {
 	register mpw rc;
 	register size_t n = size-1;
@@ -880,6 +886,181 @@ void mpsqr(mpw* result, size_t size, const mpw* data)
 
 	mpaddsqrtrc(size, result, data);
 }
+
+/*
+ * mpkdiff
+ *  computes |xh - xl| of the two halves of a number, and returns 1 if the difference was negative
+ */
+static int mpkdiff(size_t hsize, const mpw* hdata, size_t lsize, const mpw* ldata, mpw* result)
+{
+	mpcopy(hsize, result, hdata);
+	if (mpsubx(hsize, result, lsize, ldata))
+	{
+		mpneg(hsize, result);
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * mpkmid
+ *  adds the Karatsuba middle term z2 + z0 -/+ dm, where dm is in wksp, at word offset lsize of the result
+ */
+static void mpkmid(mpw* result, size_t size, size_t lsize, size_t hsize, mpw* wksp, int add)
+{
+	register size_t dsize = hsize << 1;
+	register int carry;
+
+	if (add)
+		carry = (int) mpadd(dsize, wksp, result);
+	else
+	{
+		/* wksp = z2 - dm; the borrow from negating a non-zero dm is compensated below */
+		carry = mpz(dsize, wksp) ? 0 : -1;
+		mpneg(dsize, wksp);
+		carry += (int) mpadd(dsize, wksp, result);
+	}
+	carry += (int) mpaddx(dsize, wksp, lsize << 1, result + dsize);
+
+	if (mpaddx((size << 1) - lsize, result, dsize, wksp))
+		carry++;
+	if (carry)
+		mpaddw(lsize, result, (mpw) carry);
+}
+
+size_t mpkmulwksp(size_t size)
+{
+	register size_t wsize = 0;
+
+	while (size >= MP_KARATSUBA_MUL_THRESHOLD)
+	{
+		size -= (size >> 1);
+		wsize += (size << 1);
+	}
+	return wsize;
+}
+
+size_t mpksqrwksp(size_t size)
+{
+	register size_t wsize = 0;
+
+	while (size >= MP_KARATSUBA_SQR_THRESHOLD)
+	{
+		size -= (size >> 1);
+		wsize += (size << 1);
+	}
+	return wsize;
+}
+
+void mpkmul_w(mpw* result, size_t size, const mpw* xdata, const mpw* ydata, mpw* wksp)
+{
+	if (size < MP_KARATSUBA_MUL_THRESHOLD)
+		mpbasemul(result, size, xdata, size, ydata);
+	else
+	{
+		/* x = xh * W^lsize + xl; the high half holds the extra word if size is odd */
+		register size_t lsize = size >> 1;
+		register size_t hsize = size - lsize;
+		register int neg;
+
+		/* dm = (xh - xl) * (yh - yl); the differences are parked in the result */
+		neg  = mpkdiff(hsize, xdata, lsize, xdata+hsize, result);
+		neg ^= mpkdiff(hsize, ydata, lsize, ydata+hsize, result+hsize);
+		mpkmul_w(wksp, hsize, result, result+hsize, wksp+2*hsize);
+
+		mpkmul_w(result, hsize, xdata, ydata, wksp+2*hsize);                    /* z2 = xh * yh */
+		mpkmul_w(result+2*hsize, lsize, xdata+hsize, ydata+hsize, wksp+2*hsize); /* z0 = xl * yl */
+
+		/* middle term is z2 + z0 - dm */
+		mpkmid(result, size, lsize, hsize, wksp, neg);
+	}
+}
+
+void mpksqr_w(mpw* result, size_t size, const mpw* xdata, mpw* wksp)
+{
+	if (size < MP_KARATSUBA_SQR_THRESHOLD)
+		mpbasesqr(result, size, xdata);
+	else
+	{
+		register size_t lsize = size >> 1;
+		register size_t hsize = size - lsize;
+
+		/* dm = (xh - xl)^2 */
+		mpkdiff(hsize, xdata, lsize, xdata+hsize, result);
+		mpksqr_w(wksp, hsize, result, wksp+2*hsize);
+
+		mpksqr_w(result, hsize, xdata, wksp+2*hsize);                 /* z2 = xh^2 */
+		mpksqr_w(result+2*hsize, lsize, xdata+hsize, wksp+2*hsize);   /* z0 = xl^2 */
+
+		mpkmid(result, size, lsize, hsize, wksp, 0);
+	}
+}
+
+/*
+ * mpkmulx_w
+ *  multiplies an xsize-word number with a smaller ysize-word number by splitting x in ysize-word chunks
+ *  needs a workspace of (2*ysize + mpkmulwksp(ysize)) words
+ */
+static void mpkmulx_w(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata, mpw* wksp)
+{
+	register size_t offset = xsize;
+
+	mpzero(xsize+ysize, result);
+
+	while (offset >= ysize)
+	{
+		offset -= ysize;
+		mpkmul_w(wksp, ysize, xdata+offset, ydata, wksp+2*ysize);
+		mpaddx(offset+2*ysize, result, 2*ysize, wksp);
+	}
+	if (offset)
+	{
+		mpbasemul(wksp, ysize, ydata, offset, xdata);
+		mpaddx(offset+ysize, result, offset+ysize, wksp);
+	}
+}
+
+#ifndef ASM_MPMUL
+void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
+{
+	if (xsize >= MP_KARATSUBA_MUL_THRESHOLD && ysize >= MP_KARATSUBA_MUL_THRESHOLD)
+	{
+		register size_t msize = (xsize < ysize) ? xsize : ysize;
+		register mpw* wksp = mpwkspget(2*msize + mpkmulwksp(msize));
+
+		if (wksp)
+		{
+			if (xsize == ysize)
+				mpkmul_w(result, xsize, xdata, ydata, wksp);
+			else if (xsize > ysize)
+				mpkmulx_w(result, xsize, xdata, ysize, ydata, wksp);
+			else
+				mpkmulx_w(result, ysize, ydata, xsize, xdata, wksp);
+
+			mpwkspput(wksp);
+			return;
+		}
+	}
+	mpbasemul(result, xsize, xdata, ysize, ydata);
+}
+#endif
+
+#ifndef ASM_MPSQR
+void mpsqr(mpw* result, size_t size, const mpw* data)
+{
+	if (size >= MP_KARATSUBA_SQR_THRESHOLD)
+	{
+		register mpw* wksp = mpwkspget(mpksqrwksp(size));
+
+		if (wksp)
+		{
+			mpksqr_w(result, size, data, wksp);
+			mpwkspput(wksp);
+			return;
+		}
+	}
+	mpbasesqr(result, size, data);
+}
 #endif
 
 #ifndef ASM_MPSIZE
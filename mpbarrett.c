@@ -37,6 +37,8 @@
 #include "beecrypt/mpprime.h"
 #include "beecrypt/mpnumber.h"
 #include "beecrypt/mpbarrett.h"
+#include "beecrypt/mpslide.h"
+#include "beecrypt/mpwksp.h"
 
 /*
  * mpbzero
@@ -447,7 +449,11 @@ void mpbmulmod_w(const mpbarrett* b, size_t xsize, const mpw* xdata, size_t ysiz
 	if (fill)
 		mpzero(fill, temp);
 
-	mpmul(temp+fill, xsize, xdata, ysize, ydata);
+	/* the low part of the workspace is free until the reduction */
+	if (xsize == ysize && mpkmulwksp(xsize) <= size*2+2)
+		mpkmul_w(temp+fill, xsize, xdata, ydata, wksp);
+	else
+		mpmul(temp+fill, xsize, xdata, ysize, ydata);
 	mpbmod_w(b, temp, result, wksp);
 }
 
@@ -466,7 +472,10 @@ void mpbsqrmod_w(const mpbarrett* b, size_t xsize, const mpw* xdata, mpw* result
 	if (fill)
 		mpzero(fill, temp);
 
-	mpsqr(temp+fill, xsize, xdata);
+	if (mpksqrwksp(xsize) <= size*2+2)
+		mpksqr_w(temp+fill, xsize, xdata, wksp);
+	else
+		mpsqr(temp+fill, xsize, xdata);
 	mpbmod_w(b, temp, result, wksp);
 }
 
@@ -557,13 +566,13 @@ void mpbpowmod_w(const mpbarrett* b, size_t xsize, const mpw* xdata, size_t psiz
 	/* if temp is still zero, then we're trying to raise x to power zero, and result stays one */
 	if (temp)
 	{
-		mpw* slide = (mpw*) malloc((8*size)*sizeof(mpw));
+		mpw* slide = mpwkspget(8*size);
 
 		mpbslide_w(b, xsize, xdata, slide, wksp);
 
 		mpbpowmodsld_w(b, slide, psize, pdata-1, result, wksp);
 
-		free(slide);
+		mpwkspput(slide);
 	}
 }
 
@@ -663,6 +672,116 @@ void mpbpowmodsld_w(const mpbarrett* b, const mpw* slide, size_t psize, const mp
 	}
 }
 
+/*
+ * mpslidedigits
+ *  recodes the lower 'bits' bits of p into sliding windows of up to four bits:
+ *  digits[k] holds the odd window value ending at bit k, or zero; also
+ *  used by mpmontpowmod2_w
+ */
+void mpslidedigits(size_t psize, const mpw* pdata, size_t bits, byte* digits)
+{
+	register size_t k = bits;
+
+	#define mpslidebit(k)	((k) < MP_WORDS_TO_BITS(psize) ? (byte) ((pdata[psize-1-(k)/MP_WBITS] >> ((k) % MP_WBITS)) & 1) : (byte) 0)
+
+	while (k)
+		digits[--k] = 0;
+
+	k = bits;
+	while (k--)
+	{
+		if (mpslidebit(k))
+		{
+			register size_t low = (k >= 3) ? k-3 : 0;
+			register size_t i;
+			register byte n = 0;
+
+			while (!mpslidebit(low))
+				low++;
+
+			for (i = k+1; i-- > low; )
+				n = (n << 1) | mpslidebit(i);
+
+			digits[low] = n;
+			k = low;
+		}
+	}
+
+	#undef mpslidebit
+}
+
+/*
+ * mpbpowmod2_w
+ *  computes x1^p1 * x2^p2 mod b, sharing the squarings between the two exponents
+ *  needs workspace of (4*size+2) words
+ */
+void mpbpowmod2_w(const mpbarrett* b, size_t x1size, const mpw* x1data, size_t p1size, const mpw* p1data, size_t x2size, const mpw* x2data, size_t p2size, const mpw* p2data, mpw* result, mpw* wksp)
+{
+	/*
+	 * Simultaneous multiple exponentiation (Straus), with interleaved sliding windows;
+	 * see "Handbook of Applied Cryptography", Algorithm 14.88
+	 *
+	 * Needs extra storage for two sliding window tables and the recoded exponents
+	 */
+
+	register size_t size = b->size;
+	register size_t bits1 = mpbits(p1size, p1data);
+	register size_t bits2 = mpbits(p2size, p2data);
+	register size_t bits = (bits1 > bits2) ? bits1 : bits2;
+
+	mpw* slide;
+	byte* digits1;
+	byte* digits2;
+
+	if (bits == 0)
+	{
+		mpsetw(size, result, 1);
+		return;
+	}
+
+	slide = mpwkspget(16*size + MP_BYTES_TO_WORDS(2*bits + MP_WBYTES - 1));
+	if (slide)
+	{
+		register int one = 1;
+
+		digits1 = (byte*) (slide+16*size);
+		digits2 = digits1+bits;
+
+		mpbslide_w(b, x1size, x1data, slide, wksp);
+		mpbslide_w(b, x2size, x2data, slide+8*size, wksp);
+
+		mpslidedigits(p1size, p1data, bits, digits1);
+		mpslidedigits(p2size, p2data, bits, digits2);
+
+		while (bits--)
+		{
+			register byte n1 = digits1[bits], n2 = digits2[bits];
+
+			if (!one)
+				mpbsqrmod_w(b, size, result, result, wksp);
+
+			if (n1)
+			{
+				if (one)
+					mpcopy(size, result, slide+(n1 >> 1)*size);
+				else
+					mpbmulmod_w(b, size, result, size, slide+(n1 >> 1)*size, result, wksp);
+				one = 0;
+			}
+			if (n2)
+			{
+				if (one)
+					mpcopy(size, result, slide+(8+(n2 >> 1))*size);
+				else
+					mpbmulmod_w(b, size, result, size, slide+(8+(n2 >> 1))*size, result, wksp);
+				one = 0;
+			}
+		}
+
+		mpwkspput(slide);
+	}
+}
+
 /*
  * mpbtwopowmod_w
  *  needs workspace of (4*size+2) words
@@ -770,7 +889,7 @@ int mpbpprime_w(const mpbarrett* b, randomGeneratorContext* r, int t, mpw* wksp)
 
 		if (mpisone(size, wksp))
 		{
-			return mppmilrab_w(b, r, t, wksp);
+			return mpptest_w(b, r, t, wksp);
 		}
 	}
 
@@ -780,19 +899,19 @@ int mpbpprime_w(const mpbarrett* b, randomGeneratorContext* r, int t, mpw* wksp)
 void mpbnrnd(const mpbarrett* b, randomGeneratorContext* rc, mpnumber* result)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc(size * sizeof(mpw));
+	register mpw* temp = mpwkspget(size);
 
 	mpnfree(result);
 	mpnsize(result, size);
 	mpbrnd_w(b, rc, result->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnmulmod(const mpbarrett* b, const mpnumber* x, const mpnumber* y, mpnumber* result)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
 	/* xsize and ysize must be <= b->size */
 	register size_t  fill = 2*size-x->size-y->size;
@@ -807,13 +926,13 @@ void mpbnmulmod(const mpbarrett* b, const mpnumber* x, const mpnumber* y, mpnumb
 	mpmul(opnd+fill, x->size, x->data, y->size, y->data);
 	mpbmod_w(b, opnd, result->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnsqrmod(const mpbarrett* b, const mpnumber* x, mpnumber* result)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc(size * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
 	/* xsize must be <= b->size */
 	register size_t  fill = 2*(size-x->size);
@@ -826,33 +945,33 @@ void mpbnsqrmod(const mpbarrett* b, const mpnumber* x, mpnumber* result)
 	mpnsize(result, size);
 	mpbmod_w(b, opnd, result->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnpowmod(const mpbarrett* b, const mpnumber* x, const mpnumber* pow, mpnumber* y)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
 	mpnfree(y);
 	mpnsize(y, size);
 
 	mpbpowmod_w(b, x->size, x->data, pow->size, pow->data, y->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnpowmodsld(const mpbarrett* b, const mpw* slide, const mpnumber* pow, mpnumber* y)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
 	mpnfree(y);
 	mpnsize(y, size);
 
 	mpbpowmodsld_w(b, slide, pow->size, pow->data, y->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 size_t mpbbits(const mpbarrett* b)
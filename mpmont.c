@@ -0,0 +1,815 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpmont.c
+ * \brief Multi-precision integer routines using Montgomery modular reduction.
+ *        For more information on this algorithm, see:
+ *        "Handbook of Applied Cryptography", Chapter 14.3.2
+ *        Menezes, van Oorschot, Vanstone
+ *        CRC Press
+ * \ingroup MP__m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpnumber.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/mpslide.h"
+#include "beecrypt/mpwksp.h"
+
+/*
+ * mpmontninv
+ *  computes -inv(n) mod 2^MP_WBITS by Newton iteration; n must be odd
+ */
+static mpw mpmontninv(mpw n)
+{
+	/* for odd n, n*n == 1 mod 8, hence the initial value is correct to 3 bits */
+	register mpw inv = n;
+	register int bits;
+
+	/* each iteration doubles the number of correct bits */
+	for (bits = 3; bits < MP_WBITS; bits <<= 1)
+		inv *= 2 - n * inv;
+
+	return (mpw) 0 - inv;
+}
+
+/*
+ * mpmontrsqr_w
+ *  computes R^2 mod n, where R = 2^(size*MP_WBITS)
+ *  needs workspace of (6*size+3) words
+ */
+static void mpmontrsqr_w(size_t size, const mpw* modl, mpw* rsqr, mpw* wksp)
+{
+	register mpw* dividend = wksp;
+	register mpw* remainder = dividend+(2*size+1);
+
+	*dividend = 1;
+	mpzero(2*size, dividend+1);
+	mpmod(remainder, 2*size+1, dividend, size, modl, remainder+(2*size+1));
+	mpcopy(size, rsqr, remainder+size+1);
+}
+
+/*
+ * mpmontaddc
+ *  adds y to the word at data, and propagates the carry into the preceding word
+ */
+static void mpmontaddc(mpw* data, mpw y)
+{
+	register mpw temp = *data + y;
+
+	*data = temp;
+	if (temp < y)
+		data[-1]++;
+}
+
+/*
+ * mpmontzero
+ */
+void mpmontzero(mpmont* m)
+{
+	m->size = 0;
+	m->modl = m->rsqr = (mpw*) 0;
+	m->ninv = 0;
+}
+
+/*
+ * mpmontfree
+ */
+void mpmontfree(mpmont* m)
+{
+	if (m->modl != (mpw*) 0)
+	{
+		free(m->modl);
+		m->modl = m->rsqr = (mpw*) 0;
+	}
+	m->size = 0;
+	m->ninv = 0;
+}
+
+/*
+ * mpmontset
+ *  sets up a Montgomery context for an odd modulus
+ *  will allocate 2*size words
+ */
+int mpmontset(mpmont* m, size_t size, const mpw* data)
+{
+	register mpw* temp;
+
+	if (size == 0 || mpeven(size, data))
+		return -1;
+
+	if (m->modl)
+	{
+		if (m->size != size)
+			m->modl = (mpw*) realloc(m->modl, (2*size) * sizeof(mpw));
+	}
+	else
+		m->modl = (mpw*) malloc((2*size) * sizeof(mpw));
+
+	if (m->modl == (mpw*) 0)
+	{
+		mpmontzero(m);
+		return -1;
+	}
+
+	temp = (mpw*) malloc((6*size+3) * sizeof(mpw));
+	if (temp == (mpw*) 0)
+	{
+		mpmontfree(m);
+		return -1;
+	}
+
+	m->size = size;
+	m->rsqr = m->modl+size;
+	mpcopy(size, m->modl, data);
+	m->ninv = mpmontninv(data[size-1]);
+	mpmontrsqr_w(size, m->modl, m->rsqr, temp);
+
+	free(temp);
+
+	return 0;
+}
+
+/*
+ * mpmontsetb
+ *  sets up a Montgomery context for the modulus of a Barrett context
+ */
+int mpmontsetb(mpmont* m, const mpbarrett* b)
+{
+	return mpmontset(m, b->size, b->modl);
+}
+
+/*
+ * mpmontredc_w
+ *  computes the Montgomery reduction x*inv(R) mod n of x, which has twice the size of n
+ *  the contents of x are destroyed; needs no workspace
+ */
+void mpmontredc_w(const mpmont* m, mpw* data, mpw* result)
+{
+	register size_t size = m->size;
+	register mpw* dst = data+size;
+	register mpw temp, carry = 0;
+
+	while (dst > data)
+	{
+		/* add a multiple of n which clears the least significant word */
+		register mpw rc = mpaddmul(size, dst, m->modl, dst[size-1] * m->ninv);
+
+		temp = *(--dst) + carry;
+		carry = (temp < carry);
+		temp += rc;
+		carry += (temp < rc);
+		*dst = temp;
+	}
+
+	if (carry || mpge(size, data, m->modl))
+		mpsub(size, data, m->modl);
+
+	mpcopy(size, result, data);
+}
+
+/*
+ * mpmontenter_w
+ *  converts x to Montgomery form, i.e. computes x*R mod n
+ *  xsize must be <= m->size; needs workspace of (3*size+1) words
+ */
+void mpmontenter_w(const mpmont* m, size_t xsize, const mpw* xdata, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+	register mpw* temp = wksp+2*size+1;
+
+	mpsetx(size, temp, xsize, xdata);
+	mpmontmulmod_w(m, temp, m->rsqr, result, wksp);
+}
+
+/*
+ * mpmontleave_w
+ *  converts x from Montgomery form, i.e. computes x*inv(R) mod n
+ *  needs workspace of (2*size) words
+ */
+void mpmontleave_w(const mpmont* m, const mpw* xdata, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+
+	mpzero(size, wksp);
+	mpcopy(size, wksp+size, xdata);
+	mpmontredc_w(m, wksp, result);
+}
+
+/*
+ * mpmontmulmod_w
+ *  computes the Montgomery product x*y*inv(R) mod n
+ *  the reduction is interleaved with the multiplication, one word of y at a time
+ *  x and y must be (size) words; result may overlap with x or y
+ *  needs workspace of (2*size+1) words
+ */
+void mpmontmulmod_w(const mpmont* m, const mpw* xdata, const mpw* ydata, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+	register const mpw* src = ydata+size;
+	register mpw* dst = wksp+size+1;
+
+	mpzero(2*size+1, wksp);
+
+	while (src > ydata)
+	{
+		register mpw rc;
+
+		if ((rc = *(--src)))
+			mpmontaddc(dst-1, mpaddmul(size, dst, xdata, rc));
+
+		/* add a multiple of n which clears the least significant word */
+		rc = mpaddmul(size, dst, m->modl, dst[size-1] * m->ninv);
+		mpmontaddc(dst-1, rc);
+
+		/* and divide by 2^MP_WBITS by moving the accumulator up one word */
+		dst--;
+	}
+
+	/* the accumulator now holds (size+1) words, with a value less than 2n */
+	if (*wksp || mpge(size, wksp+1, m->modl))
+		mpsub(size, wksp+1, m->modl);
+
+	mpcopy(size, result, wksp+1);
+}
+
+/*
+ * mpmontsqrmod_w
+ *  computes the Montgomery square x*x*inv(R) mod n
+ *  x must be (size) words; needs workspace of (4*size+2) words
+ */
+void mpmontsqrmod_w(const mpmont* m, const mpw* xdata, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+
+	if (mpksqrwksp(size) <= 2*size+2)
+		mpksqr_w(wksp, size, xdata, wksp+2*size);
+	else
+		mpsqr(wksp, size, xdata);
+	mpmontredc_w(m, wksp, result);
+}
+
+/*
+ * Sliding window exponentiation, in Montgomery form; this uses the same
+ * tables and window size (K=4) as the Barrett version in mpbarrett.c
+ */
+
+static byte mpmontslide_presq[16] =
+{ 0, 1, 1, 2, 1, 3, 2, 3, 1, 4, 3, 4, 2, 4, 3, 4 };
+
+static byte mpmontslide_mulg[16] =
+{ 0, 0, 0, 1, 0, 2, 1, 3, 0, 4, 2, 5, 1, 6, 3, 7 };
+
+static byte mpmontslide_postsq[16] =
+{ 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+/*
+ * mpmontslide_w
+ *  precomputes the sliding window table with the odd powers of x, in Montgomery form
+ *  needs workspace of (4*size+2) words
+ */
+static void mpmontslide_w(const mpmont* m, size_t xsize, const mpw* xdata, mpw* slide, mpw* wksp)
+{
+	register size_t size = m->size;
+	register mpw* temp = wksp+2*size+1;
+	register int i;
+
+	mpmontenter_w(m, xsize, xdata, slide, wksp);    /* x^1 */
+	mpmontsqrmod_w(m, slide, temp, wksp);           /* x^2, temp */
+
+	for (i = 1; i < 8; i++)                         /* x^3 .. x^15 */
+		mpmontmulmod_w(m, slide+(i-1)*size, temp, slide+i*size, wksp);
+}
+
+/*
+ * mpmontslidemul_w
+ *  processes one window: squarings, a multiplication by an odd power of x, and more squarings
+ *  as long as *one is set, result is the Montgomery form of 1, so squarings are skipped and
+ *  the multiplication becomes a copy
+ */
+static void mpmontslidemul_w(const mpmont* m, const mpw* slide, short n, int* one, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+	register byte s = mpmontslide_presq[n];
+
+	if (*one)
+	{
+		mpcopy(size, result, slide+mpmontslide_mulg[n]*size);
+		*one = 0;
+	}
+	else
+	{
+		while (s--)
+			mpmontsqrmod_w(m, result, result, wksp);
+
+		mpmontmulmod_w(m, result, slide+mpmontslide_mulg[n]*size, result, wksp);
+	}
+
+	s = mpmontslide_postsq[n];
+
+	while (s--)
+		mpmontsqrmod_w(m, result, result, wksp);
+}
+
+/*
+ * mpmontpowmod_w
+ *  computes x^p mod n
+ *  xsize must be <= m->size; needs workspace of (4*size+2) words
+ */
+void mpmontpowmod_w(const mpmont* m, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	size_t size = m->size;
+	mpw temp = 0;
+
+	while (psize)
+	{
+		if ((temp = *(pdata++))) /* break when first non-zero word found */
+			break;
+		psize--;
+	}
+
+	/* if temp is still zero, then we're trying to raise x to power zero, and result is one */
+	if (temp)
+	{
+		mpw* slide;
+		short l = 0, n = 0, count = MP_WBITS;
+		int one = 1;
+
+		if (size >= MP_IFMA_POWMOD_THRESHOLD && mpmontifmapowmod(m, xsize, xdata, psize, pdata-1, result) == 0)
+			return;
+
+		slide = mpwkspget(8*size);
+
+		mpmontslide_w(m, xsize, xdata, slide, wksp);
+
+		/* first skip bits until we reach a one */
+		while (count)
+		{
+			if (temp & MP_MSBMASK)
+				break;
+			temp <<= 1;
+			count--;
+		}
+
+		while (psize)
+		{
+			while (count)
+			{
+				byte bit = (temp & MP_MSBMASK) ? 1 : 0;
+
+				n <<= 1;
+				n += bit;
+
+				if (n)
+				{
+					if (l)
+						l++;
+					else if (bit)
+						l = 1;
+
+					if (l == 4)
+					{
+						mpmontslidemul_w(m, slide, n, &one, result, wksp);
+
+						l = n = 0;
+					}
+				}
+				else if (!one)
+					mpmontsqrmod_w(m, result, result, wksp);
+
+				temp <<= 1;
+				count--;
+			}
+			if (--psize)
+			{
+				count = MP_WBITS;
+				temp = *(pdata++);
+			}
+		}
+
+		if (n)
+			mpmontslidemul_w(m, slide, n, &one, result, wksp);
+
+		mpmontleave_w(m, result, result, wksp);
+
+		mpwkspput(slide);
+	}
+	else
+		mpsetw(size, result, 1);
+}
+
+/*
+ * mpmontpowmod2_w
+ *  computes x1^p1 * x2^p2 mod n, sharing the squarings between the two exponents
+ *  x1size and x2size must be <= m->size; needs workspace of (4*size+2) words
+ */
+void mpmontpowmod2_w(const mpmont* m, size_t x1size, const mpw* x1data, size_t p1size, const mpw* p1data, size_t x2size, const mpw* x2data, size_t p2size, const mpw* p2data, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+	register size_t bits1 = mpbits(p1size, p1data);
+	register size_t bits2 = mpbits(p2size, p2data);
+	register size_t bits = (bits1 > bits2) ? bits1 : bits2;
+
+	mpw* slide;
+	byte* digits1;
+	byte* digits2;
+
+	if (bits == 0)
+	{
+		mpsetw(size, result, 1);
+		return;
+	}
+
+	slide = mpwkspget(16*size + MP_BYTES_TO_WORDS(2*bits + MP_WBYTES - 1));
+	if (slide)
+	{
+		register int one = 1;
+
+		digits1 = (byte*) (slide+16*size);
+		digits2 = digits1+bits;
+
+		mpmontslide_w(m, x1size, x1data, slide, wksp);
+		mpmontslide_w(m, x2size, x2data, slide+8*size, wksp);
+
+		mpslidedigits(p1size, p1data, bits, digits1);
+		mpslidedigits(p2size, p2data, bits, digits2);
+
+		while (bits--)
+		{
+			register byte n1 = digits1[bits], n2 = digits2[bits];
+
+			if (!one)
+				mpmontsqrmod_w(m, result, result, wksp);
+
+			if (n1)
+			{
+				if (one)
+					mpcopy(size, result, slide+(n1 >> 1)*size);
+				else
+					mpmontmulmod_w(m, result, slide+(n1 >> 1)*size, result, wksp);
+				one = 0;
+			}
+			if (n2)
+			{
+				if (one)
+					mpcopy(size, result, slide+(8+(n2 >> 1))*size);
+				else
+					mpmontmulmod_w(m, result, slide+(8+(n2 >> 1))*size, result, wksp);
+				one = 0;
+			}
+		}
+
+		mpmontleave_w(m, result, result, wksp);
+
+		mpwkspput(slide);
+	}
+}
+
+void mpmontnpowmod(const mpmont* m, const mpnumber* x, const mpnumber* pow, mpnumber* y)
+{
+	register size_t  size = m->size;
+	register mpw* temp = mpwkspget(4*size+2);
+
+	mpnfree(y);
+	mpnsize(y, size);
+
+	mpmontpowmod_w(m, x->size, x->data, pow->size, pow->data, y->data, temp);
+
+	mpwkspput(temp);
+}
+
+/*
+ * mpmontbpowmod_w
+ *  computes x^p mod b; if b is odd, this is done with a temporary Montgomery context,
+ *  otherwise it falls back to mpbpowmod_w
+ *  needs workspace of (4*size+2) words, like mpbpowmod_w
+ */
+void mpmontbpowmod_w(const mpbarrett* b, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	register size_t size = b->size;
+
+	if (size && mpodd(size, b->modl))
+	{
+		register mpw* temp = mpwkspget(7*size+3);
+
+		if (temp)
+		{
+			mpmont m;
+
+			m.size = size;
+			m.modl = b->modl;
+			m.rsqr = temp;
+			m.ninv = mpmontninv(b->modl[size-1]);
+
+			mpmontrsqr_w(size, m.modl, m.rsqr, temp+size);
+			mpmontpowmod_w(&m, xsize, xdata, psize, pdata, result, wksp);
+
+			mpwkspput(temp);
+
+			return;
+		}
+	}
+
+	mpbpowmod_w(b, xsize, xdata, psize, pdata, result, wksp);
+}
+
+/*
+ * mpmontbpowmod2_w
+ *  computes x1^p1 * x2^p2 mod b; with Montgomery reduction if b is odd, otherwise with mpbpowmod2_w
+ *  needs workspace of (4*size+2) words
+ */
+void mpmontbpowmod2_w(const mpbarrett* b, size_t x1size, const mpw* x1data, size_t p1size, const mpw* p1data, size_t x2size, const mpw* x2data, size_t p2size, const mpw* p2data, mpw* result, mpw* wksp)
+{
+	register size_t size = b->size;
+
+	if (size && mpodd(size, b->modl))
+	{
+		register mpw* temp = mpwkspget(7*size+3);
+
+		if (temp)
+		{
+			mpmont m;
+
+			m.size = size;
+			m.modl = b->modl;
+			m.rsqr = temp;
+			m.ninv = mpmontninv(b->modl[size-1]);
+
+			mpmontrsqr_w(size, m.modl, m.rsqr, temp+size);
+			mpmontpowmod2_w(&m, x1size, x1data, p1size, p1data, x2size, x2data, p2size, p2data, result, wksp);
+
+			mpwkspput(temp);
+
+			return;
+		}
+	}
+
+	mpbpowmod2_w(b, x1size, x1data, p1size, p1data, x2size, x2data, p2size, p2data, result, wksp);
+}
+
+void mpmontbnpowmod(const mpbarrett* b, const mpnumber* x, const mpnumber* pow, mpnumber* y)
+{
+	register size_t  size = b->size;
+	register mpw* temp = mpwkspget(4*size+2);
+
+	mpnfree(y);
+	mpnsize(y, size);
+
+	mpmontbpowmod_w(b, x->size, x->data, pow->size, pow->data, y->data, temp);
+
+	mpwkspput(temp);
+}
+
+/*
+ * Fixed-base comb exponentiation (Lim-Lee):
+ *
+ * The exponent bits are arranged in a matrix of 'teeth' rows and 'span' columns; row i holds the
+ * bits i*span .. (i+1)*span-1. The table holds, for every non-zero column pattern j, the product of
+ * g^(2^(i*span)) over the bits i set in j, so that g^p needs only span squarings and at most span
+ * multiplications, instead of one squaring per exponent bit.
+ */
+
+void mpmontcombzero(mpmontcomb* c)
+{
+	mpmontzero(&c->m);
+	c->bits = c->teeth = c->span = 0;
+	c->base = c->table = (mpw*) 0;
+}
+
+void mpmontcombfree(mpmontcomb* c)
+{
+	if (c->base)
+	{
+		free(c->base);
+		c->base = c->table = (mpw*) 0;
+	}
+	mpmontfree(&c->m);
+	c->bits = c->teeth = c->span = 0;
+}
+
+/*
+ * mpmontcombset
+ *  builds the comb table for powers of g mod b, for exponents of up to 'bits' bits
+ *  will allocate (2^teeth)*size words for the table, plus the Montgomery context
+ */
+int mpmontcombset(mpmontcomb* c, const mpbarrett* b, size_t gsize, const mpw* gdata, size_t bits)
+{
+	register size_t size = b->size;
+	register size_t teeth, span, i, j, entries;
+	register mpw* wksp;
+
+	mpmontcombfree(c);
+
+	if (bits == 0 || gsize > size)
+		return -1;
+
+	if (mpmontsetb(&c->m, b))
+		return -1;
+
+	teeth = (bits >= 512) ? 8 : (bits >= 160) ? 6 : 4;
+	if (teeth > bits)
+		teeth = bits;
+	span = (bits + teeth - 1) / teeth;
+	entries = ((size_t) 1 << teeth) - 1;
+
+	/* a copy of the base followed by the table, which starts with index 1 */
+	c->base = (mpw*) malloc((size + entries*size) * sizeof(mpw));
+	if (c->base == (mpw*) 0)
+	{
+		mpmontcombfree(c);
+		return -1;
+	}
+
+	wksp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	if (wksp == (mpw*) 0)
+	{
+		mpmontcombfree(c);
+		return -1;
+	}
+
+	c->table = c->base + size;
+	c->bits = bits;
+	c->teeth = teeth;
+	c->span = span;
+
+	mpsetx(size, c->base, gsize, gdata);
+
+	/* the single teeth: g^(2^(i*span)) */
+	mpmontenter_w(&c->m, gsize, gdata, c->table, wksp);
+	for (i = 1; i < teeth; i++)
+	{
+		register mpw* dst = c->table + (((size_t) 1 << i) - 1)*size;
+
+		mpcopy(size, dst, c->table + (((size_t) 1 << (i-1)) - 1)*size);
+		for (j = 0; j < span; j++)
+			mpmontsqrmod_w(&c->m, dst, dst, wksp);
+	}
+
+	/* the combinations: entry j = entry (j without its lowest bit) * entry (lowest bit of j) */
+	for (j = 3; j <= entries; j++)
+	{
+		register size_t low = j & (~j + 1);
+
+		if (low != j)
+			mpmontmulmod_w(&c->m, c->table + ((j^low)-1)*size, c->table + (low-1)*size, c->table + (j-1)*size, wksp);
+	}
+
+	free(wksp);
+
+	return 0;
+}
+
+int mpmontcombcopy(mpmontcomb* c, const mpmontcomb* copy)
+{
+	if (c == copy)
+		return 0;
+
+	if (copy->base)
+	{
+		register size_t size = copy->m.size;
+		register size_t words = size + (((size_t) 1 << copy->teeth) - 1)*size;
+
+		mpmontcombfree(c);
+
+		if (mpmontset(&c->m, size, copy->m.modl))
+			return -1;
+
+		c->base = (mpw*) malloc(words * sizeof(mpw));
+		if (c->base == (mpw*) 0)
+		{
+			mpmontcombfree(c);
+			return -1;
+		}
+		mpcopy(words, c->base, copy->base);
+
+		c->table = c->base + size;
+		c->bits = copy->bits;
+		c->teeth = copy->teeth;
+		c->span = copy->span;
+	}
+	else
+		mpmontcombfree(c);
+
+	return 0;
+}
+
+/*
+ * mpmontcombmatch
+ *  returns 1 if the table was built for base g and modulus b
+ */
+int mpmontcombmatch(const mpmontcomb* c, const mpbarrett* b, size_t gsize, const mpw* gdata)
+{
+	if (c->base == (mpw*) 0 || c->m.size != b->size)
+		return 0;
+
+	return mpeq(b->size, c->m.modl, b->modl) && mpeqx(c->m.size, c->base, gsize, gdata);
+}
+
+/*
+ * mpmontcombbit
+ *  returns bit k of p, counting from the least significant bit
+ */
+static int mpmontcombbit(size_t psize, const mpw* pdata, size_t k)
+{
+	register size_t w = k / MP_WBITS;
+
+	if (w >= psize)
+		return 0;
+
+	return (int) ((pdata[psize-1-w] >> (k % MP_WBITS)) & 1);
+}
+
+/*
+ * mpmontcombpowmod_w
+ *  computes g^p mod n with the comb table
+ *  returns -1 if p has more bits than the table was built for
+ *  needs workspace of (4*size+2) words
+ */
+int mpmontcombpowmod_w(const mpmontcomb* c, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	register size_t size = c->m.size;
+	register size_t t, i;
+	int one = 1;
+
+	if (c->base == (mpw*) 0 || mpbits(psize, pdata) > c->bits)
+		return -1;
+
+	for (t = c->span; t-- > 0; )
+	{
+		register size_t j = 0;
+
+		if (!one)
+			mpmontsqrmod_w(&c->m, result, result, wksp);
+
+		for (i = c->teeth; i-- > 0; )
+			j = (j << 1) | mpmontcombbit(psize, pdata, i*c->span + t);
+
+		if (j)
+		{
+			if (one)
+			{
+				mpcopy(size, result, c->table + (j-1)*size);
+				one = 0;
+			}
+			else
+				mpmontmulmod_w(&c->m, result, c->table + (j-1)*size, result, wksp);
+		}
+	}
+
+	if (one)
+		mpsetw(size, result, 1);
+	else
+		mpmontleave_w(&c->m, result, result, wksp);
+
+	return 0;
+}
+
+/*
+ * mpmontcombbpowmod_w
+ *  computes g^p mod b with the comb table if c is not NULL and was built for g and b, and
+ *  falls back to mpmontbpowmod_w otherwise
+ *  needs workspace of (4*size+2) words
+ */
+void mpmontcombbpowmod_w(const mpmontcomb* c, const mpbarrett* b, size_t gsize, const mpw* gdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	if (c && mpmontcombmatch(c, b, gsize, gdata))
+		if (mpmontcombpowmod_w(c, psize, pdata, result, wksp) == 0)
+			return;
+
+	mpmontbpowmod_w(b, gsize, gdata, psize, pdata, result, wksp);
+}
+
+void mpmontcombbnpowmod(const mpmontcomb* c, const mpbarrett* b, const mpnumber* g, const mpnumber* pow, mpnumber* y)
+{
+	register size_t  size = b->size;
+	register mpw* temp = mpwkspget(4*size+2);
+
+	mpnfree(y);
+	mpnsize(y, size);
+
+	mpmontcombbpowmod_w(c, b, g->size, g->data, pow->size, pow->data, y->data, temp);
+
+	mpwkspput(temp);
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpmontifma.c
+ * \brief Montgomery modular exponentiation with AVX-512 IFMA.
+ *
+ * The operands are converted to 52-bit digits on entry, so that eight
+ * digit products can be accumulated per vpmadd52luq/vpmadd52huq
+ * instruction; the result is converted back before returning.
+ *
+ * \ingroup MP_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/mpmont.h"
+#include "beecrypt/cpu.h"
+#include "beecrypt/mpwksp.h"
+
+#if (MP_WBITS == 64) && defined(__x86_64__) && ((defined(__GNUC__) && (__GNUC__ >= 8)) || defined(__clang__))
+# include <immintrin.h>
+# define MPIFMA_AVAILABLE 1
+# define MPIFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+#endif
+
+#if MPIFMA_AVAILABLE
+
+#define MP52_BITS	52
+#define MP52_MASK	((uint64_t) 0xfffffffffffffULL)
+
+/* the largest supported modulus, in vectors of eight digits (13312 bits) */
+#define MP52_MAXVECS	32
+
+typedef struct
+{
+	size_t digits;	/* number of 52-bit digits; a multiple of eight */
+	uint64_t ninv;	/* -1/n mod 2^52 */
+	uint64_t* modl;	/* the modulus in 52-bit digits */
+} mp52mont;
+
+/*
+ * mp52from
+ *  converts size words, most significant first, into 52-bit digits, least significant first
+ */
+static void mp52from(size_t size, const mpw* data, size_t digits, uint64_t* result)
+{
+	register size_t i, bit;
+
+	for (i = 0, bit = 0; i < digits; i++, bit += MP52_BITS)
+	{
+		register size_t w = bit / MP_WBITS, s = bit % MP_WBITS;
+		register uint64_t temp = 0;
+
+		if (w < size)
+		{
+			temp = data[size-1-w] >> s;
+			if ((s > (MP_WBITS - MP52_BITS)) && (w+1 < size))
+				temp |= data[size-2-w] << (MP_WBITS - s);
+		}
+		result[i] = temp & MP52_MASK;
+	}
+}
+
+/*
+ * mp52to
+ *  converts normalized 52-bit digits back into size words
+ */
+static void mp52to(size_t digits, const uint64_t* data, size_t size, mpw* result)
+{
+	register size_t i, bit;
+
+	mpzero(size, result);
+
+	for (i = 0, bit = 0; i < digits; i++, bit += MP52_BITS)
+	{
+		register size_t w = bit / MP_WBITS, s = bit % MP_WBITS;
+
+		if (w < size)
+		{
+			result[size-1-w] |= data[i] << s;
+			if ((s > (MP_WBITS - MP52_BITS)) && (w+1 < size))
+				result[size-2-w] |= data[i] >> (MP_WBITS - s);
+		}
+	}
+}
+
+/*
+ * mp52mulmod_n
+ *  computes x*y/R mod n, where R = 2^(52*digits), with a result smaller than 2n,
+ *  provided that x and y are smaller than 2n, and 4n < R
+ *
+ * One digit of y is processed per iteration; the partial sums are kept in
+ * the vector lanes without carry propagation, except for the lowest digit,
+ * which must be exact to compute the reduction factor. The upper halves of
+ * the products are added after the accumulator has been shifted down by one
+ * digit, which puts them in the right position; they are computed apart,
+ * to keep them out of the dependency chain through the lowest digit. Since
+ * every lane gathers at most four 52-bit values per iteration, 64-bit lanes
+ * can't overflow for the supported sizes.
+ */
+MPIFMA_TARGET __attribute__((always_inline))
+static inline void mp52mulmod_n(const mp52mont* m, const uint64_t* x, const uint64_t* y, uint64_t* result, const size_t vecs)
+{
+	register size_t i, j;
+
+	__m512i acc[MP52_MAXVECS];
+	__m512i hi[MP52_MAXVECS];
+	__m512i zero = _mm512_setzero_si512();
+
+	register uint64_t carry;
+
+	/* tell the compiler that hi[0] is always set, without zeroing anything */
+	if (vecs == 0 || vecs > MP52_MAXVECS)
+		__builtin_unreachable();
+
+	for (j = 0; j < vecs; j++)
+		acc[j] = zero;
+
+	for (i = 0; i < m->digits; i++)
+	{
+		register uint64_t lsd, q;
+
+		__m512i yi = _mm512_set1_epi64((long long) y[i]);
+		__m512i qv;
+
+		/* the upper halves don't depend on the accumulator */
+		for (j = 0; j < vecs; j++)
+			hi[j] = _mm512_madd52hi_epu64(zero, _mm512_loadu_si512(x+8*j), yi);
+
+		lsd = (uint64_t) _mm_cvtsi128_si64(_mm512_castsi512_si128(acc[0])) + ((x[0] * y[i]) & MP52_MASK);
+		q = (lsd * m->ninv) & MP52_MASK;
+		qv = _mm512_set1_epi64((long long) q);
+
+		for (j = 0; j < vecs; j++)
+		{
+			acc[j] = _mm512_madd52lo_epu64(acc[j], _mm512_loadu_si512(x+8*j), yi);
+			acc[j] = _mm512_madd52lo_epu64(acc[j], _mm512_loadu_si512(m->modl+8*j), qv);
+			hi[j] = _mm512_madd52hi_epu64(hi[j], _mm512_loadu_si512(m->modl+8*j), qv);
+		}
+
+		/* the lowest digit is now zero modulo 2^52; keep its carry and shift down */
+		carry = (lsd + ((m->modl[0] * q) & MP52_MASK)) >> MP52_BITS;
+		hi[0] = _mm512_add_epi64(hi[0], _mm512_maskz_set1_epi64(1, (long long) carry));
+
+		for (j = 0; j+1 < vecs; j++)
+			acc[j] = _mm512_add_epi64(_mm512_alignr_epi64(acc[j+1], acc[j], 1), hi[j]);
+		acc[j] = _mm512_add_epi64(_mm512_alignr_epi64(zero, acc[j], 1), hi[j]);
+	}
+
+	for (j = 0; j < vecs; j++)
+		_mm512_storeu_si512(result+8*j, acc[j]);
+
+	/* normalize the digits */
+	carry = 0;
+	for (i = 0; i < m->digits; i++)
+	{
+		register uint64_t temp = result[i] + carry;
+
+		result[i] = temp & MP52_MASK;
+		carry = temp >> MP52_BITS;
+	}
+}
+
+/*
+ * mp52mulmod
+ *  dispatches to a copy of mp52mulmod_n for a fixed number of vectors if
+ *  possible, so that the compiler can keep the accumulator in registers
+ */
+MPIFMA_TARGET
+static void mp52mulmod(const mp52mont* m, const uint64_t* x, const uint64_t* y, uint64_t* result)
+{
+	switch (m->digits >> 3)
+	{
+	case 2:
+		mp52mulmod_n(m, x, y, result, 2);
+		break;
+	case 3:
+		mp52mulmod_n(m, x, y, result, 3);
+		break;
+	case 4:
+		mp52mulmod_n(m, x, y, result, 4);
+		break;
+	case 5:
+		mp52mulmod_n(m, x, y, result, 5);
+		break;
+	case 6:
+		mp52mulmod_n(m, x, y, result, 6);
+		break;
+	case 8:
+		mp52mulmod_n(m, x, y, result, 8);
+		break;
+	case 10:
+		mp52mulmod_n(m, x, y, result, 10);
+		break;
+	default:
+		mp52mulmod_n(m, x, y, result, m->digits >> 3);
+	}
+}
+
+/*
+ * mp52window
+ *  returns the w bits of p starting at bit lo, where bit zero is the least significant
+ */
+static unsigned int mp52window(size_t psize, const mpw* pdata, size_t bits, size_t lo, size_t w)
+{
+	register unsigned int n = 0;
+	register size_t k = lo + w;
+
+	if (k > bits)
+		k = bits;
+
+	while (k-- > lo)
+	{
+		n <<= 1;
+		n |= (unsigned int) (pdata[psize-1-k/MP_WBITS] >> (k % MP_WBITS)) & 1;
+	}
+
+	return n;
+}
+
+#endif
+
+/*
+ * mpmontifmapowmod
+ */
+int mpmontifmapowmod(const mpmont* m, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result)
+{
+	#if MPIFMA_AVAILABLE
+	register size_t size = m->size;
+	register size_t digits, bits, pbits, w, k, tsize;
+	register uint64_t* temp;
+	register mpw* mtemp;
+
+	mp52mont m52;
+
+	if ((cpuFeatures() & (CPUF_X86_AVX512F | CPUF_X86_AVX512IFMA)) != (CPUF_X86_AVX512F | CPUF_X86_AVX512IFMA))
+		return -1;
+
+	if (xsize > size)
+		return -1;
+
+	/* R = 2^(52*digits) must be larger than 4n */
+	bits = mpbits(size, m->modl);
+	digits = ((bits + 2 + MP52_BITS - 1) / MP52_BITS + 7) & ~((size_t) 7);
+
+	if (digits > 8*MP52_MAXVECS)
+		return -1;
+
+	pbits = mpbits(psize, pdata);
+	if (pbits == 0)
+	{
+		mpsetw(size, result, 1);
+		return 0;
+	}
+
+	w = (pbits > 512) ? 5 : 4;
+
+	/* modulus, R^2, x, one, accumulator, and a table of 2^w powers */
+	tsize = (5 + ((size_t) 1 << w)) * digits;
+
+	temp = (uint64_t*) mpwkspget(MP_BYTES_TO_WORDS(tsize * sizeof(uint64_t)));
+	if (temp == (uint64_t*) 0)
+		return -1;
+
+	/* (2*digits*52)/64+1 words for R^2, plus the workspace of mpmod */
+	k = (2*digits*MP52_BITS)/MP_WBITS + 1;
+	mtemp = mpwkspget(2*k+3*size+1);
+	if (mtemp == (mpw*) 0)
+	{
+		mpwkspput((mpw*) temp);
+		return -1;
+	}
+	else
+	{
+		uint64_t* r2 = temp+digits;
+		uint64_t* x = r2+digits;
+		uint64_t* one = x+digits;
+		uint64_t* acc = one+digits;
+		uint64_t* table = acc+digits;
+
+		register size_t pos;
+
+		m52.digits = digits;
+		m52.ninv = (uint64_t) m->ninv & MP52_MASK;
+		m52.modl = temp;
+
+		mp52from(size, m->modl, digits, m52.modl);
+
+		/* R^2 mod n */
+		mpzero(k, mtemp);
+		mtemp[k-1-(2*digits*MP52_BITS)/MP_WBITS] = ((mpw) 1) << ((2*digits*MP52_BITS) % MP_WBITS);
+		mpmod(mtemp+k, k, mtemp, size, m->modl, mtemp+k+k);
+		mp52from(size, mtemp+2*k-size, digits, r2);
+
+		/* x, reduced if necessary */
+		if (mpgex(xsize, xdata, size, m->modl))
+		{
+			mpmod(mtemp+k, xsize, xdata, size, m->modl, mtemp+k+xsize);
+			mp52from(size, mtemp+k+xsize-size, digits, x);
+		}
+		else
+			mp52from(xsize, xdata, digits, x);
+
+		memset(one, 0, digits * sizeof(uint64_t));
+		one[0] = 1;
+
+		/* table[i] = x^i, in Montgomery form */
+		mp52mulmod(&m52, one, r2, table);
+		mp52mulmod(&m52, x, r2, table+digits);
+		for (k = 2; k < ((size_t) 1 << w); k++)
+			mp52mulmod(&m52, table+(k-1)*digits, table+digits, table+k*digits);
+
+		/* fixed windows, starting with the most significant one */
+		pos = ((pbits - 1) / w) * w;
+		memcpy(acc, table+mp52window(psize, pdata, pbits, pos, w)*digits, digits * sizeof(uint64_t));
+
+		while (pos)
+		{
+			register unsigned int n;
+
+			pos -= w;
+			for (k = 0; k < w; k++)
+				mp52mulmod(&m52, acc, acc, acc);
+
+			if ((n = mp52window(psize, pdata, pbits, pos, w)))
+				mp52mulmod(&m52, acc, table+n*digits, acc);
+		}
+
+		/* leave Montgomery form, and reduce into [0, n) */
+		mp52mulmod(&m52, acc, one, acc);
+		mp52to(digits, acc, size, result);
+		if (mpge(size, result, m->modl))
+			mpsub(size, result, m->modl);
+
+		mpwkspput(mtemp);
+		mpwkspput((mpw*) temp);
+
+		return 0;
+	}
+	#else
+	return -1;
+	#endif
+}
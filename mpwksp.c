@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpwksp.c
+ * \brief Multi-precision workspace cache.
+ *
+ * Every thread keeps one block of scratch space, which is handed out from
+ * the bottom up and given back in reverse order, like a stack. The block
+ * only grows when it's entirely free, so that space still in use never
+ * moves; a request that doesn't fit while part of the block is in use is
+ * served by malloc, but the block remembers the total, so that the same
+ * nesting of requests fits the next time.
+ *
+ * Where POSIX threads aren't available, a library built without thread
+ * support shares one block, and a threaded one always uses malloc; so does
+ * one built with OpenMP, whose threads would otherwise share the block.
+ *
+ * Space is wiped when it's given back, since it may have held key
+ * material. Space from malloc carries its size in the word before it, so
+ * that mpwkspput knows how much to wipe.
+ *
+ * \ingroup MP_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/mpwksp.h"
+
+#if defined(_REENTRANT) && !WIN32 && !(HAVE_THREAD_H && HAVE_SYNCH_H) && HAVE_PTHREAD_H
+# define MPWKSP_TLS 1
+#endif
+
+/*!\addtogroup MP_m
+ * \{
+ */
+
+/*
+ * Requests of this many words or more always go to malloc, so that a
+ * thread doesn't hold on to a large block after a one-off operation
+ */
+#define MPWKSP_MAX		65536
+/*
+ * The block grows in multiples of this many words
+ */
+#define MPWKSP_GRAIN	64
+
+struct mpwkspcache
+{
+	mpw*	data;
+	size_t	size;
+	size_t	used;
+	size_t	peak;
+};
+
+#if MPWKSP_TLS
+static pthread_once_t mpwksponce = PTHREAD_ONCE_INIT;
+static pthread_key_t mpwkspkey;
+static int mpwkspstatus = -1;
+
+static void mpwkspfree(void* arg)
+{
+	struct mpwkspcache* c = (struct mpwkspcache*) arg;
+
+	if (c->data)
+	{
+		memset(c->data, 0, c->size * sizeof(mpw));
+		free(c->data);
+	}
+	free(c);
+}
+
+static void mpwkspinit(void)
+{
+	if (pthread_key_create(&mpwkspkey, mpwkspfree) == 0)
+		mpwkspstatus = 0;
+}
+
+static struct mpwkspcache* mpwkspthread(void)
+{
+	struct mpwkspcache* c;
+
+	if (pthread_once(&mpwksponce, mpwkspinit) || mpwkspstatus)
+		return (struct mpwkspcache*) 0;
+
+	c = (struct mpwkspcache*) pthread_getspecific(mpwkspkey);
+
+	if (c == (struct mpwkspcache*) 0)
+	{
+		if ((c = (struct mpwkspcache*) calloc(1, sizeof(struct mpwkspcache))) == (struct mpwkspcache*) 0)
+			return (struct mpwkspcache*) 0;
+
+		if (pthread_setspecific(mpwkspkey, c))
+		{
+			free(c);
+			return (struct mpwkspcache*) 0;
+		}
+	}
+	return c;
+}
+#elif !defined(_REENTRANT) && !defined(_OPENMP)
+static struct mpwkspcache mpwkspshared;
+
+# define mpwkspthread()	(&mpwkspshared)
+#else
+# define mpwkspthread()	((struct mpwkspcache*) 0)
+#endif
+
+mpw* mpwkspget(size_t size)
+{
+	struct mpwkspcache* c;
+	mpw* wksp;
+
+	/* an empty request could end up at the very end of the block, where mpwkspput wouldn't recognise it */
+	if (size && size < MPWKSP_MAX && (c = mpwkspthread()))
+	{
+		if (c->peak < c->used + size && c->used + size < MPWKSP_MAX)
+			c->peak = c->used + size;
+
+		if (c->used == 0 && c->size < c->peak)
+		{
+			register size_t grow = (c->peak + MPWKSP_GRAIN - 1) & ~((size_t) MPWKSP_GRAIN - 1);
+			register mpw* data = (mpw*) malloc(grow * sizeof(mpw));
+
+			if (data)
+			{
+				if (c->data)
+				{
+					memset(c->data, 0, c->size * sizeof(mpw));
+					free(c->data);
+				}
+				c->data = data;
+				c->size = grow;
+			}
+		}
+
+		if (c->size - c->used >= size)
+		{
+			wksp = c->data + c->used;
+
+			c->used += size;
+
+			return wksp;
+		}
+	}
+
+	if ((wksp = (mpw*) malloc((size + 1) * sizeof(mpw))) == (mpw*) 0)
+		return (mpw*) 0;
+
+	wksp[0] = (mpw) size;
+
+	return wksp + 1;
+}
+
+void mpwkspput(mpw* wksp)
+{
+	struct mpwkspcache* c = mpwkspthread();
+
+	if (c && c->data && wksp >= c->data && wksp < c->data + c->size)
+	{
+		register size_t used = (size_t) (wksp - c->data);
+
+		mpzero(c->used - used, wksp);
+		c->used = used;
+	}
+	else if (wksp)
+	{
+		mpzero((size_t) wksp[-1], wksp);
+		free(wksp - 1);
+	}
+}
+
+/*!\}
+ */
@@ -91,13 +91,31 @@ int mtprngSetup(mtprngParam* mp)
 	return -1;
 }
 
-int mtprngSeed(mtprngParam* mp, const byte* data, size_t size)
+int mtprngSeedUnlocked(mtprngParam* mp, const byte* data, size_t size)
 {
 	if (mp)
 	{
 		size_t	needed = (N+1) * sizeof(uint32_t);
 		byte*	dest = (byte*) mp->state;
 
+		while (size < needed)
+		{
+			memcpy(dest, data, size);
+			dest += size;
+			needed -= size;
+		}
+		memcpy(dest, data, needed);
+		return 0;
+	}
+	return -1;
+}
+
+int mtprngSeed(mtprngParam* mp, const byte* data, size_t size)
+{
+	if (mp)
+	{
+		int rc;
+
 		#ifdef _REENTRANT
 		# if WIN32
 		if (WaitForSingleObject(mp->lock, INFINITE) != WAIT_OBJECT_0)
@@ -112,13 +130,9 @@ int mtprngSeed(mtprngParam* mp, const byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		while (size < needed)
-		{
-			memcpy(dest, data, size);
-			dest += size;
-			needed -= size;
-		}
-		memcpy(dest, data, needed);
+
+		rc = mtprngSeedUnlocked(mp, data, size);
+
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(mp->lock))
@@ -133,31 +147,17 @@ int mtprngSeed(mtprngParam* mp, const byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		return 0;
+		return rc;
 	}
 	return -1;
 }
 
-int mtprngNext(mtprngParam* mp, byte* data, size_t size)
+int mtprngNextUnlocked(mtprngParam* mp, byte* data, size_t size)
 {
 	if (mp)
 	{
 		uint32_t tmp;
 
-		#ifdef _REENTRANT
-		# if WIN32
-		if (WaitForSingleObject(mp->lock, INFINITE) != WAIT_OBJECT_0)
-			return -1;
-		# else
-		#  if HAVE_THREAD_H && HAVE_SYNCH_H
-		if (mutex_lock(&mp->lock))
-			return -1;
-		#  elif HAVE_PTHREAD_H
-		if (pthread_mutex_lock(&mp->lock))
-			return -1;
-		#  endif
-		# endif
-		#endif
 		while (size > 0)
 		{
 			if (mp->left == 0)
@@ -181,6 +181,34 @@ int mtprngNext(mtprngParam* mp, byte* data, size_t size)
 				size = 0;
 			}
 		}
+		return 0;
+	}
+	return -1;
+}
+
+int mtprngNext(mtprngParam* mp, byte* data, size_t size)
+{
+	if (mp)
+	{
+		int rc;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (WaitForSingleObject(mp->lock, INFINITE) != WAIT_OBJECT_0)
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&mp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_lock(&mp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		rc = mtprngNextUnlocked(mp, data, size);
+
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(mp->lock))
@@ -195,7 +223,7 @@ int mtprngNext(mtprngParam* mp, byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		return 0;
+		return rc;
 	}
 	return -1;
 }
@@ -2,80 +2,119 @@
 
 #include "beecrypt/pkcs12.h"
 
-int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+#if defined(_OPENMP)
+# include <omp.h>
+#endif
+
+/*
+ * Below this number of iterations, starting threads costs more than it gains;
+ * without threads, the chains share the SIMD lanes.
+ */
+#define PKCS12_THREAD_ITERATIONS	1024
+
+/*
+ * pkcs12_repeat
+ *  concatenates copies of data until size bytes are filled
+ */
+static void pkcs12_repeat(byte* dest, size_t size, const byte* data, size_t dsize)
 {
-	int rc = -1;
-	size_t i, remain;
-	hashFunctionContext ctxt;
-	byte *digest;
+	while (size > 0)
+	{
+		size_t tmp = size > dsize ? dsize : size;
 
-	digest = (byte*) malloc(h->digestsize);
-	if (!digest)
-		goto cleanup;
+		memcpy(dest, data, tmp);
+		dest += tmp;
+		size -= tmp;
+	}
+}
 
-	if (hashFunctionContextInit(&ctxt, h))
-		goto cleanup;
+int pkcs12_derive_keys(const hashFunction* h, const byte* ids, size_t count, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* const* ndata, const size_t* nsize)
+{
+	int rc = -1, failures = 0;
+	size_t i, slen = 0, plen = 0, dlen;
+	hashFunctionContext ctxt;
+	byte *block = (byte*) 0, *digests = (byte*) 0;
 
-	/* we start by hashing the diversifier; don't allocate a buffer for this */
-	for (i = 0; i < h->blocksize; i++)
-		hashFunctionContextUpdate(&ctxt, &id, 1);
+	if (hashFunctionContextInit(&ctxt, h))
+		return -1;
 
-	/* next we hash the salt data, concatenating until we have a whole number of blocks */
+	/* the salt and the password are concatenated until we have a whole number of blocks */
 	if (ssize)
-	{
-		remain = ((ssize / h->blocksize) + (ssize % h->blocksize)) * h->blocksize;
-		while (remain > 0)
-		{
-			size_t tmp = remain > ssize ? ssize : remain;
-
-			hashFunctionContextUpdate(&ctxt, sdata, tmp);
+		slen = ((ssize / h->blocksize) + (ssize % h->blocksize)) * h->blocksize;
+	if (psize)
+		plen = ((psize / h->blocksize) + (psize % h->blocksize)) * h->blocksize;
 
-			remain -= tmp;
-		}
-	}
+	dlen = h->blocksize + slen + plen;
 
-	/* next we hash the password data, concatenating until we have a whole number of blocks */
-	if (psize)
-	{
-		remain = ((psize / h->blocksize) + (psize % h->blocksize)) * h->blocksize;
-		while (remain > 0)
-		{
-			size_t tmp = remain > psize ? psize : remain;
+	block = (byte*) malloc(dlen);
+	if (!block)
+		goto cleanup;
 
-			hashFunctionContextUpdate(&ctxt, pdata, tmp);
+	digests = (byte*) malloc(count * h->digestsize);
+	if (!digests)
+		goto cleanup;
 
-			remain -= tmp;
-		}
-	}
+	if (ssize)
+		pkcs12_repeat(block + h->blocksize, slen, sdata, ssize);
+	if (psize)
+		pkcs12_repeat(block + h->blocksize + slen, plen, pdata, psize);
 
-	/* now we iterate through the following loop */
-	while (iterationcount-- > 0)
+	/* the first digest covers the diversifier, the salt and the password */
+	for (i = 0; i < count; i++)
 	{
-		hashFunctionContextDigest(&ctxt, digest);
-		hashFunctionContextUpdate(&ctxt, digest, h->digestsize);
-	}
+		memset(block, ids[i], h->blocksize);
 
-	/* do the final digest */
-	hashFunctionContextDigest(&ctxt, digest);
+		if (hashFunctionContextUpdate(&ctxt, block, dlen))
+			goto cleanup;
+		if (hashFunctionContextDigest(&ctxt, digests + i * h->digestsize))
+			goto cleanup;
+	}
 
-	/* fill key */
-	while (nsize > 0)
+	/* the chains of the diversifiers are independent */
+	#if defined(_OPENMP)
+	if (count > 1 && iterationcount >= PKCS12_THREAD_ITERATIONS && omp_get_max_threads() > 1)
 	{
-		size_t tmp = nsize > h->digestsize ? h->digestsize : nsize;
+		int j;
 
-		memcpy(ndata, digest, tmp);
-		ndata += tmp;
-		nsize -= tmp;
+		#pragma omp parallel for reduction(+:failures)
+		for (j = 0; j < (int) count; j++)
+		{
+			if (hashFunctionBatchIterate(h, digests + j * h->digestsize, 1, iterationcount))
+				failures++;
+		}
 	}
+	else
+	#endif
+	if (hashFunctionBatchIterate(h, digests, count, iterationcount))
+		failures++;
 
-	if (hashFunctionContextFree(&ctxt))
+	if (failures)
 		goto cleanup;
 
+	/* fill the keys */
+	for (i = 0; i < count; i++)
+		pkcs12_repeat(ndata[i], nsize[i], digests + i * h->digestsize, h->digestsize);
+
 	rc = 0;
 
 cleanup:
-	if (digest)
-		free(digest);
+	if (block)
+	{
+		memset(block, 0, dlen);
+		free(block);
+	}
+	if (digests)
+	{
+		memset(digests, 0, count * h->digestsize);
+		free(digests);
+	}
+
+	hashFunctionContextFree(&ctxt);
 
 	return rc;
 }
+
+int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+{
+	return pkcs12_derive_keys(h, &id, 1, pdata, psize, sdata, ssize, iterationcount, &ndata, &nsize);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file pkcs5.c
+ * \brief PKCS#5 password-based key derivation.
+ *
+ * PBKDF2 spends nearly all its time iterating HMAC over a single digest.
+ * Each iteration starts from the hash states saved by hmacSetup, so it costs
+ * two compressions; for MD5, SHA-1 and SHA-2 with 32-bit words the output
+ * blocks are iterated side by side in SIMD lanes.
+ *
+ * \see RFC 2898 PKCS #5: Password-Based Cryptography Specification Version 2.0.
+ *
+ * \ingroup PKCS5_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/pkcs5.h"
+#include "beecrypt/hmac.h"
+
+int pkcs5_pbkdf2(const hashFunction* h, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+{
+	int rc = -1;
+	byte* param = (byte*) 0;
+	byte* u = (byte*) 0;
+	byte* t = (byte*) 0;
+	size_t blocks, i, j, k;
+	byte index[4];
+
+	if (h == (const hashFunction*) 0 || iterationcount == 0 || nsize == 0)
+		return -1;
+
+	/* rounded up without adding to nsize, which could wrap */
+	blocks = nsize / h->digestsize + (nsize % h->digestsize != 0);
+
+	/* the block index is a 32-bit counter, which limits the output to (2^32-1) * hLen bytes */
+	if (blocks > 0xffffffffU)
+		return -1;
+
+	/* the U and T buffers below take 2 * blocks * hLen bytes, which must not wrap */
+	if (blocks > ((size_t) ~0) / (2 * h->digestsize))
+		return -1;
+
+	/* the working state, followed by the inner and outer HMAC states */
+	param = (byte*) malloc(3 * h->paramsize);
+	if (!param)
+		goto cleanup;
+
+	u = (byte*) malloc(2 * blocks * h->digestsize);
+	if (!u)
+		goto cleanup;
+
+	t = u + blocks * h->digestsize;
+
+	if (hmacSetup(param + h->paramsize, param + 2 * h->paramsize, h, param, pdata, psize << 3))
+		goto cleanup;
+
+	/* U1 = PRF(P, S || INT(i)) */
+	for (i = 0; i < blocks; i++)
+	{
+		index[0] = (byte) ((i+1) >> 24);
+		index[1] = (byte) ((i+1) >> 16);
+		index[2] = (byte) ((i+1) >>  8);
+		index[3] = (byte) ((i+1)      );
+
+		if (hmacReset(param + h->paramsize, h, param))
+			goto cleanup;
+		if (ssize && hmacUpdate(h, param, sdata, ssize))
+			goto cleanup;
+		if (hmacUpdate(h, param, index, 4))
+			goto cleanup;
+		if (hmacDigest(param + 2 * h->paramsize, h, param, u + i * h->digestsize))
+			goto cleanup;
+	}
+
+	memcpy(t, u, blocks * h->digestsize);
+
+	/* Uj = PRF(P, Uj-1), T = U1 ^ ... ^ Uc */
+	if (hmacBatchIterate(h, param + h->paramsize, param + 2 * h->paramsize, u, t, blocks, iterationcount - 1))
+	{
+		for (i = 0; i < blocks; i++)
+		{
+			byte* ui = u + i * h->digestsize;
+			byte* ti = t + i * h->digestsize;
+
+			for (j = 1; j < iterationcount; j++)
+			{
+				if (hmacReset(param + h->paramsize, h, param))
+					goto cleanup;
+				if (hmacUpdate(h, param, ui, h->digestsize))
+					goto cleanup;
+				if (hmacDigest(param + 2 * h->paramsize, h, param, ui))
+					goto cleanup;
+
+				for (k = 0; k < h->digestsize; k++)
+					ti[k] ^= ui[k];
+			}
+		}
+	}
+
+	memcpy(ndata, t, nsize);
+
+	rc = 0;
+
+cleanup:
+	if (u)
+	{
+		memset(u, 0, 2 * blocks * h->digestsize);
+		free(u);
+	}
+	if (param)
+	{
+		memset(param, 0, 3 * h->paramsize);
+		free(param);
+	}
+
+	return rc;
+}
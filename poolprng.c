@@ -0,0 +1,550 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file poolprng.c
+ * \brief Pools of pre-generated random bytes.
+ *
+ * Each thread that uses a pool owns a slot with two buffers: it copies its
+ * output from the current one without any locking, while the pool's
+ * background thread keeps the spare one filled. When the current buffer
+ * is used up, the thread takes the pool's lock to swap in the spare, or to
+ * refill its buffer itself if the background thread hasn't got to it yet.
+ *
+ * The underlying generator is only used with the pool's lock held. Around
+ * a fork the pools' locks are taken, so that the child gets them in a
+ * consistent state; since the child would otherwise repeat the parent's
+ * output, it reseeds its generators and discards all buffered bytes.
+ *
+ * \ingroup PRNG_m PRNG_pool_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/poolprng.h"
+#include "beecrypt/ctrdrbg.h"
+
+#if defined(_REENTRANT) && !WIN32 && !(HAVE_THREAD_H && HAVE_SYNCH_H) && HAVE_PTHREAD_H
+# define POOLPRNG_THREADS 1
+#endif
+
+/*!\addtogroup PRNG_pool_m
+ * \{
+ */
+
+#if POOLPRNG_THREADS
+struct poolslot
+{
+	struct poolslot*	next;
+	struct _randomPool*	pool;
+	byte*				buf[2];
+	size_t				pos;
+	int					cur;
+	/* whether the spare buffer is full; guarded by the pool's lock */
+	int					full;
+	unsigned int		forks;
+};
+#endif
+
+struct _randomPool
+{
+	randomGeneratorContext	rngc;
+	size_t					bufsize;
+	size_t					reseed;
+	size_t					generated;
+	#if POOLPRNG_THREADS
+	struct _randomPool*		next;
+	pthread_mutex_t			lock;
+	pthread_cond_t			cond;
+	pthread_t				thread;
+	pthread_key_t			key;
+	int						started;
+	int						stop;
+	struct poolslot*		slots;
+	unsigned int			forks;
+	#endif
+};
+
+/*
+ * poolgenerate
+ *  draws from the underlying generator, reseeding it first if it's due
+ */
+static int poolgenerate(randomPool* rp, byte* data, size_t size)
+{
+	if (rp->reseed && rp->generated >= rp->reseed)
+	{
+		byte entropy[32];
+
+		if (entropyGatherNext(entropy, sizeof(entropy)) == 0)
+		{
+			randomGeneratorContextSeed(&rp->rngc, entropy, sizeof(entropy));
+			rp->generated = 0;
+		}
+
+		memset(entropy, 0, sizeof(entropy));
+	}
+
+	rp->generated += size;
+
+	return randomGeneratorContextNext(&rp->rngc, data, size);
+}
+
+#if POOLPRNG_THREADS
+static randomPool* pools = (randomPool*) 0;
+static pthread_mutex_t poolslock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t poolsonce = PTHREAD_ONCE_INIT;
+static volatile unsigned int poolforks = 0;
+
+static void poolprepare(void)
+{
+	randomPool* rp;
+
+	pthread_mutex_lock(&poolslock);
+	for (rp = pools; rp; rp = rp->next)
+		pthread_mutex_lock(&rp->lock);
+}
+
+static void poolparent(void)
+{
+	randomPool* rp;
+
+	for (rp = pools; rp; rp = rp->next)
+		pthread_mutex_unlock(&rp->lock);
+	pthread_mutex_unlock(&poolslock);
+}
+
+static void poolchild(void)
+{
+	randomPool* rp;
+
+	poolforks++;
+
+	/* the background threads didn't survive the fork */
+	for (rp = pools; rp; rp = rp->next)
+	{
+		rp->started = 0;
+		pthread_mutex_unlock(&rp->lock);
+	}
+	pthread_mutex_unlock(&poolslock);
+}
+
+static void poolsinit(void)
+{
+	pthread_atfork(poolprepare, poolparent, poolchild);
+}
+
+static void poolslotfree(void* arg)
+{
+	struct poolslot* s = (struct poolslot*) arg;
+	randomPool* rp = s->pool;
+	struct poolslot** p;
+
+	pthread_mutex_lock(&rp->lock);
+	for (p = &rp->slots; *p; p = &(*p)->next)
+	{
+		if (*p == s)
+		{
+			*p = s->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&rp->lock);
+
+	memset(s->buf[0], 0, 2 * rp->bufsize);
+	free(s->buf[0]);
+	free(s);
+}
+
+static void* poolrefill(void* arg)
+{
+	randomPool* rp = (randomPool*) arg;
+	struct poolslot* s;
+
+	pthread_mutex_lock(&rp->lock);
+	while (!rp->stop)
+	{
+		for (s = rp->slots; s; s = s->next)
+		{
+			if (!s->full && s->forks == poolforks)
+				s->full = (poolgenerate(rp, s->buf[s->cur ^ 1], rp->bufsize) == 0);
+		}
+		pthread_cond_wait(&rp->cond, &rp->lock);
+	}
+	pthread_mutex_unlock(&rp->lock);
+
+	return arg;
+}
+
+/*
+ * poolslotget
+ *  returns the calling thread's slot, creating it if necessary; a new slot
+ *  starts out empty
+ */
+static struct poolslot* poolslotget(randomPool* rp)
+{
+	struct poolslot* s = (struct poolslot*) pthread_getspecific(rp->key);
+
+	if (s == (struct poolslot*) 0)
+	{
+		if ((s = (struct poolslot*) calloc(1, sizeof(struct poolslot))) == (struct poolslot*) 0)
+			return (struct poolslot*) 0;
+
+		if ((s->buf[0] = (byte*) malloc(2 * rp->bufsize)) == (byte*) 0)
+		{
+			free(s);
+			return (struct poolslot*) 0;
+		}
+
+		s->buf[1] = s->buf[0] + rp->bufsize;
+		s->pos = rp->bufsize;
+		s->pool = rp;
+		s->forks = poolforks;
+
+		if (pthread_setspecific(rp->key, s))
+		{
+			free(s->buf[0]);
+			free(s);
+			return (struct poolslot*) 0;
+		}
+
+		pthread_mutex_lock(&rp->lock);
+		s->next = rp->slots;
+		rp->slots = s;
+		pthread_mutex_unlock(&rp->lock);
+	}
+	return s;
+}
+
+/*
+ * poolforked
+ *  reseeds the generator on its first use in a forked child, so that the
+ *  child's output differs from the parent's; called with the pool's lock
+ *  held
+ */
+static int poolforked(randomPool* rp)
+{
+	if (rp->forks != poolforks)
+	{
+		struct poolslot* t;
+		byte entropy[32];
+
+		if (entropyGatherNext(entropy, sizeof(entropy)))
+			return -1;
+
+		randomGeneratorContextSeed(&rp->rngc, entropy, sizeof(entropy));
+		memset(entropy, 0, sizeof(entropy));
+
+		for (t = rp->slots; t; t = t->next)
+			t->full = 0;
+
+		rp->forks = poolforks;
+	}
+	return 0;
+}
+
+/*
+ * poolswap
+ *  makes a full buffer current; called with the pool's lock held
+ */
+static int poolswap(randomPool* rp, struct poolslot* s)
+{
+	if (poolforked(rp))
+		return -1;
+
+	if (s->forks != poolforks)
+	{
+		s->full = 0;
+		s->forks = poolforks;
+	}
+
+	if (s->full)
+	{
+		s->cur ^= 1;
+		s->full = 0;
+	}
+	else if (poolgenerate(rp, s->buf[s->cur], rp->bufsize))
+		return -1;
+
+	s->pos = 0;
+
+	if (!rp->started && !rp->stop)
+		rp->started = (pthread_create(&rp->thread, (pthread_attr_t*) 0, poolrefill, rp) == 0);
+
+	pthread_cond_signal(&rp->cond);
+
+	return 0;
+}
+#endif
+
+randomPool* randomPoolAlloc(const randomGenerator* rng, size_t bufsize, size_t reseed)
+{
+	randomPool* rp = (randomPool*) calloc(1, sizeof(randomPool));
+
+	if (rp == (randomPool*) 0)
+		return rp;
+
+	if (randomGeneratorContextInit(&rp->rngc, rng))
+	{
+		free(rp);
+		return (randomPool*) 0;
+	}
+
+	rp->bufsize = bufsize ? bufsize : POOLPRNG_BUFSIZE;
+	rp->reseed = reseed;
+
+	#if POOLPRNG_THREADS
+	if (pthread_once(&poolsonce, poolsinit))
+		goto fail;
+	if (pthread_mutex_init(&rp->lock, (pthread_mutexattr_t*) 0))
+		goto fail;
+	if (pthread_cond_init(&rp->cond, (pthread_condattr_t*) 0))
+	{
+		pthread_mutex_destroy(&rp->lock);
+		goto fail;
+	}
+	if (pthread_key_create(&rp->key, poolslotfree))
+	{
+		pthread_cond_destroy(&rp->cond);
+		pthread_mutex_destroy(&rp->lock);
+		goto fail;
+	}
+
+	pthread_mutex_lock(&poolslock);
+	rp->forks = poolforks;
+	rp->next = pools;
+	pools = rp;
+	pthread_mutex_unlock(&poolslock);
+	#endif
+
+	return rp;
+
+	#if POOLPRNG_THREADS
+fail:
+	randomGeneratorContextFree(&rp->rngc);
+	free(rp);
+	return (randomPool*) 0;
+	#endif
+}
+
+int randomPoolNext(randomPool* rp, byte* data, size_t size)
+{
+	#if POOLPRNG_THREADS
+	struct poolslot* s;
+
+	if (rp == (randomPool*) 0)
+		return -1;
+
+	/* large requests gain nothing from the buffers */
+	if (size >= rp->bufsize)
+	{
+		int rc;
+
+		pthread_mutex_lock(&rp->lock);
+		rc = poolforked(rp);
+		if (rc == 0)
+			rc = poolgenerate(rp, data, size);
+		pthread_mutex_unlock(&rp->lock);
+
+		return rc;
+	}
+
+	if ((s = poolslotget(rp)) == (struct poolslot*) 0)
+		return -1;
+
+	while (size)
+	{
+		size_t n;
+		byte* src;
+
+		if (s->pos == rp->bufsize || s->forks != poolforks)
+		{
+			int rc;
+
+			pthread_mutex_lock(&rp->lock);
+			rc = poolswap(rp, s);
+			pthread_mutex_unlock(&rp->lock);
+
+			if (rc)
+				return -1;
+		}
+
+		n = rp->bufsize - s->pos;
+		if (n > size)
+			n = size;
+
+		/* bytes handed out don't stay behind in the buffer */
+		src = s->buf[s->cur] + s->pos;
+		memcpy(data, src, n);
+		memset(src, 0, n);
+
+		s->pos += n;
+		data += n;
+		size -= n;
+	}
+	return 0;
+	#else
+	if (rp == (randomPool*) 0)
+		return -1;
+
+	return poolgenerate(rp, data, size);
+	#endif
+}
+
+int randomPoolSeed(randomPool* rp, const byte* data, size_t size)
+{
+	int rc;
+
+	if (rp == (randomPool*) 0)
+		return -1;
+
+	#if POOLPRNG_THREADS
+	pthread_mutex_lock(&rp->lock);
+	rc = randomGeneratorContextSeed(&rp->rngc, data, size);
+	if (rc == 0)
+	{
+		struct poolslot* s;
+
+		/* let the background thread replace the spare buffers */
+		for (s = rp->slots; s; s = s->next)
+			s->full = 0;
+
+		pthread_cond_signal(&rp->cond);
+	}
+	pthread_mutex_unlock(&rp->lock);
+	#else
+	rc = randomGeneratorContextSeed(&rp->rngc, data, size);
+	#endif
+
+	return rc;
+}
+
+void randomPoolFree(randomPool* rp)
+{
+	#if POOLPRNG_THREADS
+	randomPool** p;
+	struct poolslot* s;
+	#endif
+
+	if (rp == (randomPool*) 0)
+		return;
+
+	#if POOLPRNG_THREADS
+	pthread_mutex_lock(&poolslock);
+	for (p = &pools; *p; p = &(*p)->next)
+	{
+		if (*p == rp)
+		{
+			*p = rp->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&poolslock);
+
+	pthread_mutex_lock(&rp->lock);
+	rp->stop = 1;
+	pthread_cond_signal(&rp->cond);
+	pthread_mutex_unlock(&rp->lock);
+
+	if (rp->started)
+		pthread_join(rp->thread, (void**) 0);
+
+	/* the slots of threads which are still running go as well */
+	pthread_key_delete(rp->key);
+	while ((s = rp->slots))
+	{
+		rp->slots = s->next;
+		memset(s->buf[0], 0, 2 * rp->bufsize);
+		free(s->buf[0]);
+		free(s);
+	}
+
+	pthread_cond_destroy(&rp->cond);
+	pthread_mutex_destroy(&rp->lock);
+	#endif
+
+	randomGeneratorContextFree(&rp->rngc);
+
+	memset(rp, 0, sizeof(randomPool));
+	free(rp);
+}
+
+static randomPool* poolglobal = (randomPool*) 0;
+
+#if POOLPRNG_THREADS
+static pthread_once_t poolglobalonce = PTHREAD_ONCE_INIT;
+#endif
+
+static void poolglobalinit(void)
+{
+	const char* selection = getenv("BEECRYPT_RANDOM_POOL");
+	const randomGenerator* rng = &ctrdrbg;
+
+	if (selection && (rng = randomGeneratorFind(selection)) == (const randomGenerator*) 0)
+		return;
+
+	/* a pool can't draw from another pool */
+	if (rng == &poolprng)
+		return;
+
+	poolglobal = randomPoolAlloc(rng, 0, POOLPRNG_RESEED);
+}
+
+static int poolprngSetup(randomGeneratorParam* unused)
+{
+	#if POOLPRNG_THREADS
+	if (pthread_once(&poolglobalonce, poolglobalinit))
+		return -1;
+	#else
+	if (poolglobal == (randomPool*) 0)
+		poolglobalinit();
+	#endif
+
+	return poolglobal ? 0 : -1;
+}
+
+static int poolprngSeed(randomGeneratorParam* unused, const byte* data, size_t size)
+{
+	return randomPoolSeed(poolglobal, data, size);
+}
+
+static int poolprngNext(randomGeneratorParam* unused, byte* data, size_t size)
+{
+	return randomPoolNext(poolglobal, data, size);
+}
+
+static int poolprngCleanup(randomGeneratorParam* unused)
+{
+	/* the pool is shared by all contexts, and stays */
+	return 0;
+}
+
+const randomGenerator poolprng = {
+	"Pooled",
+	0,
+	poolprngSetup,
+	poolprngSeed,
+	poolprngNext,
+	poolprngCleanup
+};
+
+/*!\}
+ */
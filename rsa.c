@@ -31,104 +31,459 @@
 #endif
 
 #include "beecrypt/rsa.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/mpwksp.h"
+
+#if defined(_REENTRANT) && !WIN32 && !(HAVE_THREAD_H && HAVE_SYNCH_H) && HAVE_PTHREAD_H
+# define RSACRT_THREADS 1
+# if HAVE_UNISTD_H
+#  include <unistd.h>
+# endif
+/* compilers with the __atomic builtins predefine their memory orders */
+# ifdef __ATOMIC_ACQUIRE
+#  define RSACRT_SEQLOCK 1
+# endif
+#endif
+
+/*
+ * One of the two exponentiations of rsapricrt_w; its result ends up in
+ * the first words of temp
+ */
+struct rsacrthalf
+{
+	const mpbarrett*	p;
+	const mpnumber*		dp;
+	const mpnumber*		c;
+	mpw*				temp;
+};
+
+static void rsacrtpowmod(void* arg)
+{
+	struct rsacrthalf* h = (struct rsacrthalf*) arg;
+	register size_t psize = h->p->size;
+	register mpw* temp = h->temp;
+
+	/* resize c for powmod p */
+	mpsetx(psize*2, temp, h->c->size, h->c->data);
+
+	/* reduce modulo p before we powmod */
+	mpbmod_w(h->p, temp, temp+psize, temp+2*psize);
+
+	/* compute c^dp mod p, store @ temp */
+	mpmontbpowmod_w(h->p, psize, temp+psize, h->dp->size, h->dp->data, temp, temp+2*psize);
+}
+
+static rsacrtpolicy rsacrtcurrent = { RSACRT_AUTO, 0, 0, (rsacrtexecutor) 0, (void*) 0 };
+
+#if RSACRT_SEQLOCK
+/*
+ * The policy is read on every private key operation and hardly ever
+ * changed, so readers don't take rsacrtlock; rsacrtSetPolicy makes this
+ * counter odd while it changes the policy, and a reader which sees it odd,
+ * or changed since it started copying, copies again
+ */
+static unsigned int rsacrtgen = 0;
+#endif
+
+#if RSACRT_THREADS
+/*
+ * The pool only ever runs the second half of a private key operation,
+ * while the calling thread runs the first. A job which no worker has
+ * taken by the time the caller is done with its own half is taken back
+ * from the queue, so that a caller never waits for a job that hasn't
+ * started yet.
+ *
+ * The workers are started when they're first needed, and are never
+ * joined; they exit when the policy asks for fewer of them. The pool's
+ * counters are reset in the child after a fork, since it has none of the
+ * workers, nor any of the threads whose jobs were queued.
+ */
+#define RSACRT_QUEUED	0
+#define RSACRT_RUNNING	1
+#define RSACRT_DONE		2
+
+struct rsacrtjob
+{
+	struct rsacrtjob*	next;
+	struct rsacrthalf*	half;
+	int					state;
+};
+
+static pthread_mutex_t rsacrtlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rsacrtwork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t rsacrtdone = PTHREAD_COND_INITIALIZER;
+static pthread_once_t rsacrtonce = PTHREAD_ONCE_INIT;
+static struct rsacrtjob* rsacrtjobs = (struct rsacrtjob*) 0;
+static int rsacrtcpus = 1;
+/* the number of workers started, and how many of them wait for a job */
+static int rsacrtworkers = 0;
+static int rsacrtidle = 0;
+/* the number of queued jobs */
+static int rsacrtpending = 0;
+/* the number of threads in rsapricrt_w which use the pool */
+static int rsacrtcallers = 0;
+
+static void rsacrtprepare(void)
+{
+	pthread_mutex_lock(&rsacrtlock);
+}
+
+static void rsacrtparent(void)
+{
+	pthread_mutex_unlock(&rsacrtlock);
+}
+
+static void rsacrtchild(void)
+{
+	rsacrtjobs = (struct rsacrtjob*) 0;
+	rsacrtworkers = rsacrtidle = rsacrtpending = rsacrtcallers = 0;
+	pthread_cond_init(&rsacrtwork, (pthread_condattr_t*) 0);
+	pthread_cond_init(&rsacrtdone, (pthread_condattr_t*) 0);
+	pthread_mutex_unlock(&rsacrtlock);
+}
+
+static void rsacrtinit(void)
+{
+	# ifdef _SC_NPROCESSORS_ONLN
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (cpus > 1)
+		rsacrtcpus = (int) cpus;
+	# endif
+
+	pthread_atfork(rsacrtprepare, rsacrtparent, rsacrtchild);
+}
+
+/*
+ * rsacrtthreads
+ *  returns the number of workers the policy asks for; rsacrtlock must be held
+ */
+static int rsacrtthreads(void)
+{
+	return rsacrtcurrent.threads ? rsacrtcurrent.threads : rsacrtcpus - 1;
+}
+
+static void* rsacrtworker(void* arg)
+{
+	struct rsacrtjob* job;
+
+	pthread_mutex_lock(&rsacrtlock);
+	while (rsacrtworkers <= rsacrtthreads())
+	{
+		if ((job = rsacrtjobs) == (struct rsacrtjob*) 0)
+		{
+			rsacrtidle++;
+			pthread_cond_wait(&rsacrtwork, &rsacrtlock);
+			rsacrtidle--;
+			continue;
+		}
+
+		rsacrtjobs = job->next;
+		rsacrtpending--;
+		job->state = RSACRT_RUNNING;
+		pthread_mutex_unlock(&rsacrtlock);
+
+		rsacrtpowmod(job->half);
+
+		pthread_mutex_lock(&rsacrtlock);
+		job->state = RSACRT_DONE;
+		pthread_cond_broadcast(&rsacrtdone);
+	}
+	rsacrtworkers--;
+	pthread_mutex_unlock(&rsacrtlock);
+
+	return arg;
+}
+
+/*
+ * rsacrtspawn
+ *  starts another worker, if the policy allows it; rsacrtlock must be held
+ */
+static int rsacrtspawn(void)
+{
+	pthread_attr_t attr;
+	pthread_t thread;
+	int rc = -1;
+
+	if (rsacrtworkers >= rsacrtthreads())
+		return -1;
+
+	if (pthread_attr_init(&attr))
+		return -1;
+
+	if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0)
+	{
+		if (pthread_create(&thread, &attr, rsacrtworker, (void*) 0) == 0)
+		{
+			rsacrtworkers++;
+			rc = 0;
+		}
+	}
+	pthread_attr_destroy(&attr);
+
+	return rc;
+}
+
+/*
+ * rsacrtpool
+ *  runs both halves, handing the second one to the pool if always is set,
+ *  or if a worker and a processor are free
+ */
+static void rsacrtpool(struct rsacrthalf* h, int always)
+{
+	struct rsacrtjob job, **j;
+	int queued = 0, stolen = 0;
+
+	job.next = (struct rsacrtjob*) 0;
+	job.half = h+1;
+	job.state = RSACRT_QUEUED;
+
+	/* set up the fork handlers before the lock is first used */
+	pthread_once(&rsacrtonce, rsacrtinit);
+	pthread_mutex_lock(&rsacrtlock);
+	rsacrtcallers++;
+	/* the callers and the busy workers each occupy a processor */
+	if (always || rsacrtcallers + (rsacrtworkers - rsacrtidle) + rsacrtpending < rsacrtcpus)
+	{
+		if (rsacrtidle > rsacrtpending || rsacrtspawn() == 0 || (always && rsacrtworkers > 0))
+		{
+			for (j = &rsacrtjobs; *j; j = &(*j)->next);
+			*j = &job;
+			rsacrtpending++;
+			pthread_cond_signal(&rsacrtwork);
+			queued = 1;
+		}
+	}
+	pthread_mutex_unlock(&rsacrtlock);
+
+	rsacrtpowmod(h);
+	if (!queued)
+		rsacrtpowmod(h+1);
+
+	pthread_mutex_lock(&rsacrtlock);
+	if (queued)
+	{
+		if (job.state == RSACRT_QUEUED)
+		{
+			for (j = &rsacrtjobs; *j != &job; j = &(*j)->next);
+			*j = job.next;
+			rsacrtpending--;
+			stolen = 1;
+		}
+		else
+		{
+			while (job.state != RSACRT_DONE)
+				pthread_cond_wait(&rsacrtdone, &rsacrtlock);
+		}
+	}
+	rsacrtcallers--;
+	pthread_mutex_unlock(&rsacrtlock);
+
+	if (stolen)
+		rsacrtpowmod(h+1);
+}
+#endif
+
+/*
+ * rsacrtread
+ *  copies the current policy
+ */
+static void rsacrtread(rsacrtpolicy* policy)
+{
+	#if RSACRT_SEQLOCK
+	register unsigned int gen;
+
+	do
+	{
+		gen = __atomic_load_n(&rsacrtgen, __ATOMIC_ACQUIRE);
+		*policy = rsacrtcurrent;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((gen & 1) || gen != __atomic_load_n(&rsacrtgen, __ATOMIC_RELAXED));
+	#elif RSACRT_THREADS
+	/* set up the fork handlers before the lock is first used */
+	pthread_once(&rsacrtonce, rsacrtinit);
+	pthread_mutex_lock(&rsacrtlock);
+	*policy = rsacrtcurrent;
+	pthread_mutex_unlock(&rsacrtlock);
+	#else
+	*policy = rsacrtcurrent;
+	#endif
+}
+
+int rsacrtGetPolicy(rsacrtpolicy* policy)
+{
+	if (policy == (rsacrtpolicy*) 0)
+		return -1;
+
+	rsacrtread(policy);
+
+	return 0;
+}
+
+int rsacrtSetPolicy(const rsacrtpolicy* policy)
+{
+	if (policy == (const rsacrtpolicy*) 0)
+		return -1;
+
+	if ((int) policy->mode < RSACRT_AUTO || (int) policy->mode > RSACRT_EXECUTOR || policy->threads < 0)
+		return -1;
+
+	if (policy->mode == RSACRT_EXECUTOR && policy->executor == (rsacrtexecutor) 0)
+		return -1;
+
+	#if RSACRT_THREADS
+	pthread_once(&rsacrtonce, rsacrtinit);
+	pthread_mutex_lock(&rsacrtlock);
+	#endif
+	#if RSACRT_SEQLOCK
+	/* rsacrtlock keeps other writers out, so the counter needn't be read atomically */
+	__atomic_store_n(&rsacrtgen, rsacrtgen + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	rsacrtcurrent = *policy;
+	__atomic_store_n(&rsacrtgen, rsacrtgen + 1, __ATOMIC_RELEASE);
+	#else
+	rsacrtcurrent = *policy;
+	#endif
+	#if RSACRT_THREADS
+	/* let surplus workers exit */
+	pthread_cond_broadcast(&rsacrtwork);
+	pthread_mutex_unlock(&rsacrtlock);
+	#endif
+
+	return 0;
+}
 
 int rsapub(const mpbarrett* n, const mpnumber* e,
            const mpnumber* m, mpnumber* c)
 {
-	register size_t size = n->size;
 	register mpw* temp;
+	register int rc;
 
-	if (mpgex(m->size, m->data, n->size, n->modl))
+	temp = mpwkspget(RSAPUB_WKSP(n->size));
+	if (temp == (mpw*) 0)
 		return -1;
 
-	temp = (mpw*) malloc((4*size+2)*sizeof(mpw));
+	rc = rsapub_w(n, e, m, c, temp);
 
-	if (temp)
-	{
-		mpnsize(c, size);
-		mpbpowmod_w(n, m->size, m->data, e->size, e->data, c->data, temp);
+	mpwkspput(temp);
 
-		free(temp);
+	return rc;
+}
 
-		return 0;
-	}
-	return -1;
+int rsapub_w(const mpbarrett* n, const mpnumber* e,
+             const mpnumber* m, mpnumber* c, mpw* wksp)
+{
+	if (mpgex(m->size, m->data, n->size, n->modl))
+		return -1;
+
+	mpnsize(c, n->size);
+	mpbpowmod_w(n, m->size, m->data, e->size, e->data, c->data, wksp);
+
+	return 0;
 }
 
 int rsapri(const mpbarrett* n, const mpnumber* d,
            const mpnumber* c, mpnumber* m)
 {
-	register size_t size = n->size;
 	register mpw* temp;
+	register int rc;
 
-	if (mpgex(c->size, c->data, n->size, n->modl))
+	temp = mpwkspget(RSAPRI_WKSP(n->size));
+	if (temp == (mpw*) 0)
 		return -1;
 
-	temp = (mpw*) malloc((4*size+2)*sizeof(mpw));
+	rc = rsapri_w(n, d, c, m, temp);
 
-	if (temp)
-	{
-		mpnsize(m, size);
-		mpbpowmod_w(n, c->size, c->data, d->size, d->data, m->data, temp);
+	mpwkspput(temp);
 
-		free(temp);
+	return rc;
+}
 
-		return 0;
-	}
-	return -1;
+int rsapri_w(const mpbarrett* n, const mpnumber* d,
+             const mpnumber* c, mpnumber* m, mpw* wksp)
+{
+	if (mpgex(c->size, c->data, n->size, n->modl))
+		return -1;
+
+	mpnsize(m, n->size);
+	mpmontbpowmod_w(n, c->size, c->data, d->size, d->data, m->data, wksp);
+
+	return 0;
 }
 
 int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
               const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
               const mpnumber* c, mpnumber* m)
+{
+	register mpw* temp;
+	register int rc;
+
+	temp = mpwkspget(RSAPRICRT_WKSP(p->size, q->size));
+	if (temp == (mpw*) 0)
+		return -1;
+
+	rc = rsapricrt_w(n, p, q, dp, dq, qi, c, m, temp);
+
+	mpwkspput(temp);
+
+	return rc;
+}
+
+int rsapricrt_w(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
+                const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
+                const mpnumber* c, mpnumber* m, mpw* wksp)
 {
 	register size_t nsize = n->size;
 	register size_t psize = p->size;
 	register size_t qsize = q->size;
 
-	register mpw* ptemp;
-	register mpw* qtemp;
+	register mpw* ptemp = wksp;
+	register mpw* qtemp = wksp+6*psize+2;
+
+	struct rsacrthalf h[2];
+	rsacrtpolicy policy;
 
 	if (mpgex(c->size, c->data, n->size, n->modl))
 		return -1;
 
-	ptemp = (mpw*) malloc((6*psize+2)*sizeof(mpw));
-	if (ptemp == (mpw*) 0)
-		return -1;
+	/* compute j1 = c^dp mod p, store @ ptemp */
+	h[0].p = p;
+	h[0].dp = dp;
+	h[0].c = c;
+	h[0].temp = ptemp;
 
-	qtemp = (mpw*) malloc((6*qsize+2)*sizeof(mpw));
-	if (qtemp == (mpw*) 0)
-	{
-		free(ptemp);
-		return -1;
-	}
+	/* compute j2 = c^dq mod q, store @ qtemp */
+	h[1].p = q;
+	h[1].dp = dq;
+	h[1].c = c;
+	h[1].temp = qtemp;
 
-	#pragma omp parallel sections
-	{
-		#pragma omp section
-		{
-		/* resize c for powmod p */
-		mpsetx(psize*2, ptemp, c->size, c->data);
+	rsacrtread(&policy);
 
-		/* reduce modulo p before we powmod */
-		mpbmod_w(p, ptemp, ptemp+psize, ptemp+2*psize);
+	if (policy.mode == RSACRT_EXECUTOR)
+	{
+		void* args[2];
 
-		/* compute j1 = c^dp mod p, store @ ptemp */
-		mpbpowmod_w(p, psize, ptemp+psize, dp->size, dp->data, ptemp, ptemp+2*psize);
-		}
+		args[0] = h;
+		args[1] = h+1;
 
-		#pragma omp section
+		if (policy.executor(policy.param, rsacrtpowmod, args, 2))
 		{
-		/* resize c for powmod q */
-		mpsetx(qsize*2, qtemp, c->size, c->data);
-
-		/* reduce modulo q before we powmod */
-		mpbmod_w(q, qtemp, qtemp+qsize, qtemp+2*qsize);
-
-		/* compute j2 = c^dq mod q, store @ qtemp */
-		mpbpowmod_w(q, qsize, qtemp+qsize, dq->size, dq->data, qtemp, qtemp+2*qsize);
+			rsacrtpowmod(h);
+			rsacrtpowmod(h+1);
 		}
 	}
+	#if RSACRT_THREADS
+	else if (policy.mode == RSACRT_POOL)
+		rsacrtpool(h, 1);
+	else if (policy.mode == RSACRT_AUTO && mpbits(nsize, n->modl) >= (policy.minbits ? policy.minbits : RSACRT_MINBITS))
+		rsacrtpool(h, 0);
+	#endif
+	else
+	{
+		rsacrtpowmod(h);
+		rsacrtpowmod(h+1);
+	}
 
 	/* compute j1-j2 mod p, store @ ptemp */
 	mpbsubmod_w(p, psize, ptemp, qsize, qtemp, ptemp, ptemp+2*psize);
@@ -143,35 +498,38 @@ int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
 	mpmul(m->data, psize, ptemp, qsize, q->modl);
 	mpaddx(nsize, m->data, qsize, qtemp);
 
-	free(ptemp);
-	free(qtemp);
-
 	return 0;
 }
 
 int rsavrfy(const mpbarrett* n, const mpnumber* e,
             const mpnumber* m, const mpnumber* c)
 {
-	int rc = 0;
-	register size_t size = n->size;
-
 	register mpw* temp;
+	register int rc;
 
-	if (mpgex(m->size, m->data, n->size, n->modl))
-		return rc;
+	temp = mpwkspget(RSAVRFY_WKSP(n->size));
+	if (temp == (mpw*) 0)
+		return 0;
 
-	if (mpgex(c->size, c->data, n->size, n->modl))
-		return rc;
+	rc = rsavrfy_w(n, e, m, c, temp);
 
-	temp = (mpw*) malloc((5*size+2)*sizeof(mpw));
-	if (temp)
-	{
-		mpbpowmod_w(n, m->size, m->data, e->size, e->data, temp, temp+size);
+	mpwkspput(temp);
+
+	return rc;
+}
 
-		rc = mpeqx(size, temp, c->size, c->data);
+int rsavrfy_w(const mpbarrett* n, const mpnumber* e,
+              const mpnumber* m, const mpnumber* c, mpw* wksp)
+{
+	register size_t size = n->size;
 
-		free(temp);
-	}
+	if (mpgex(m->size, m->data, n->size, n->modl))
+		return 0;
 
-	return rc;
+	if (mpgex(c->size, c->data, n->size, n->modl))
+		return 0;
+
+	mpbpowmod_w(n, m->size, m->data, e->size, e->data, wksp, wksp+size);
+
+	return mpeqx(size, wksp, c->size, c->data);
 }
@@ -32,10 +32,83 @@
 #include "beecrypt/rsakp.h"
 #include "beecrypt/mpprime.h"
 
+#if defined(_REENTRANT) && !WIN32 && !(HAVE_THREAD_H && HAVE_SYNCH_H) && HAVE_PTHREAD_H
+# define RSAKP_THREADS 1
+# if HAVE_UNISTD_H
+#  include <unistd.h>
+# endif
+#endif
+
 /*!\addtogroup IF_rsa_m
  * \{
  */
 
+/*
+ * rsakpfinish
+ *  computes n and the private components, once p and q have been found
+ */
+static int rsakpfinish(rsakp* kp, size_t bits)
+{
+	size_t nsize = MP_BITS_TO_WORDS(bits+MP_WBITS-1);
+	size_t psize = kp->p.size;
+	size_t qsize = kp->q.size;
+	size_t pqsize = psize+qsize;
+	mpw* temp = (mpw*) malloc((16*pqsize+6)*sizeof(mpw));
+
+	if (temp)
+	{
+		mpbarrett psubone, qsubone;
+		mpnumber phi;
+
+		mpbzero(&psubone);
+		mpbzero(&qsubone);
+		mpnzero(&phi);
+
+		/* set n = p*q, with appropriate size (pqsize may be > nsize) */
+		mpmul(temp, psize, kp->p.modl, qsize, kp->q.modl);
+		mpbset(&kp->n, nsize, temp+pqsize-nsize);
+
+		/* compute p-1 */
+		mpbsubone(&kp->p, temp);
+		mpbset(&psubone, psize, temp);
+
+		/* compute q-1 */
+		mpbsubone(&kp->q, temp);
+		mpbset(&qsubone, qsize, temp);
+
+		/* compute phi = (p-1)*(q-1) */
+		mpmul(temp, psize, psubone.modl, qsize, qsubone.modl);
+		mpnset(&phi, nsize, temp);
+
+		/* compute d = inv(e) mod phi; if gcd(e, phi) != 1 then this function will fail
+		 */
+		if (mpninv(&kp->d, &kp->e, &phi) == 0)
+		{
+			/* shouldn't happen, since gcd(p-1,e) = 1 and gcd(q-1,e) = 1 ==> gcd((p-1)(q-1),e) = 1 */
+			mpnfree(&phi);
+			free(temp);
+			return -1;
+		}
+
+		/* compute dp = d mod (p-1) */
+		mpnsize(&kp->dp, psize);
+		mpbmod_w(&psubone, kp->d.data, kp->dp.data, temp);
+
+		/* compute dq = d mod (q-1) */
+		mpnsize(&kp->dq, qsize);
+		mpbmod_w(&qsubone, kp->d.data, kp->dq.data, temp);
+
+		/* compute qi = inv(q) mod p */
+		mpninv(&kp->qi, (mpnumber*) &kp->q, (mpnumber*) &kp->p);
+
+		mpnfree(&phi);
+		free(temp);
+
+		return 0;
+	}
+	return -1;
+}
+
 int rsakpMake(rsakp* kp, randomGeneratorContext* rgc, size_t bits)
 {
 	/* 
@@ -52,8 +125,7 @@ int rsakpMake(rsakp* kp, randomGeneratorContext* rgc, size_t bits)
 
 	if (temp)
 	{
-		mpbarrett psubone, qsubone;
-		mpnumber phi, min;
+		mpnumber min;
 		mpw* divmod = temp;
 		mpw* dividend = divmod+nsize+1;
 		mpw* workspace = dividend+nsize+1;
@@ -87,54 +159,204 @@ int rsakpMake(rsakp* kp, randomGeneratorContext* rgc, size_t bits)
 		}
 
 		mpnfree(&min);
+		free(temp);
 
-		mpbzero(&psubone);
-		mpbzero(&qsubone);
-		mpnzero(&phi);
+		return rsakpfinish(kp, bits);
+	}
+	return -1;
+}
 
-		/* set n = p*q, with appropriate size (pqsize may be > nsize) */
-		mpmul(temp, psize, kp->p.modl, qsize, kp->q.modl);
-		mpbset(&kp->n, nsize, temp+pqsize-nsize);
+#if RSAKP_THREADS
+/*
+ * The state shared by the threads searching for p and q; prime[0] is p
+ * and prime[1] is q. Each thread searches for the prime which hasn't been
+ * found yet, preferring the one its index points to; found[] doubles as
+ * the stop flag for all the searches for that prime.
+ */
+struct rsakpsearch
+{
+	randomGeneratorContext*	rgc;
+	const mpnumber*			e;
+	size_t					bits[2];
+	mpnumber				min[2];
+	mpbarrett				prime[2];
+	volatile int			found[2];
+	int						failed;
+	pthread_mutex_t			lock;
+};
+
+struct rsakpworker
+{
+	struct rsakpsearch*		search;
+	int						index;
+	pthread_t				thread;
+};
 
-		/* compute p-1 */
-		mpbsubone(&kp->p, temp);
-		mpbset(&psubone, psize, temp);
+static void* rsakpsearchprime(void* arg)
+{
+	struct rsakpworker* w = (struct rsakpworker*) arg;
+	struct rsakpsearch* s = w->search;
+	size_t size = MP_BITS_TO_WORDS(s->bits[0]+MP_WBITS-1);
+	mpw* wksp = (mpw*) malloc((8*size+2)*sizeof(mpw));
+	mpbarrett b;
 
-		/* compute q-1 */
-		mpbsubone(&kp->q, temp);
-		mpbset(&qsubone, qsize, temp);
+	mpbzero(&b);
 
-		/* compute phi = (p-1)*(q-1) */
-		mpmul(temp, psize, psubone.modl, qsize, qsubone.modl);
-		mpnset(&phi, nsize, temp);
+	while (wksp)
+	{
+		int target, rc;
 
-		/* compute d = inv(e) mod phi; if gcd(e, phi) != 1 then this function will fail
-		 */
-		if (mpninv(&kp->d, &kp->e, &phi) == 0)
+		pthread_mutex_lock(&s->lock);
+		if (s->failed || (s->found[0] && s->found[1]))
 		{
-			/* shouldn't happen, since gcd(p-1,e) = 1 and gcd(q-1,e) = 1 ==> gcd((p-1)(q-1),e) = 1 */
-			mpnfree(&phi);
-			free(temp);
-			return -1;
+			pthread_mutex_unlock(&s->lock);
+			break;
 		}
+		target = s->found[w->index] ? !w->index : w->index;
+		pthread_mutex_unlock(&s->lock);
 
-		/* compute dp = d mod (p-1) */
-		mpnsize(&kp->dp, psize);
-		mpbmod_w(&psubone, kp->d.data, kp->dp.data, temp);
+		rc = mpprndrstop_w(&b, s->rgc, s->bits[target], mpptrials(s->bits[target]), &s->min[target], (mpnumber*) 0, s->e, &s->found[target], wksp);
 
-		/* compute dq = d mod (q-1) */
-		mpnsize(&kp->dq, qsize);
-		mpbmod_w(&qsubone, kp->d.data, kp->dq.data, temp);
+		pthread_mutex_lock(&s->lock);
+		if (rc < 0)
+			s->failed = 1;
+		else if (rc == 0 && !s->found[target])
+		{
+			/* make sure that p and q differ */
+			if (!(s->found[!target] && mpeqx(b.size, b.modl, s->prime[!target].size, s->prime[!target].modl)))
+			{
+				s->prime[target] = b;
+				s->found[target] = 1;
+				mpbzero(&b);
+			}
+		}
+		pthread_mutex_unlock(&s->lock);
 
-		/* compute qi = inv(q) mod p */
-		mpninv(&kp->qi, (mpnumber*) &kp->q, (mpnumber*) &kp->p);
+		mpbwipe(&b);
+		mpbfree(&b);
+	}
 
-		mpnfree(&phi);
-		free(temp);
+	if (wksp)
+	{
+		mpzero(8*size+2, wksp);
+		free(wksp);
+	}
+	else
+	{
+		pthread_mutex_lock(&s->lock);
+		s->failed = 1;
+		pthread_mutex_unlock(&s->lock);
+	}
 
-		return 0;
+	return arg;
+}
+
+/*
+ * rsakpsetmin
+ *  sets min to the smallest number of the given size with the same leading
+ *  64 bits as sqrt(2)/2 * 2^bits, rounded up
+ */
+static void rsakpsetmin(mpnumber* min, size_t bits)
+{
+	size_t size = MP_BITS_TO_WORDS(bits+MP_WBITS-1);
+
+	mpnsize(min, size);
+	mpzero(size, min->data);
+	#if (MP_WBITS == 64)
+	min->data[size-1] = 0xb504f333f9de6485U;
+	#else
+	min->data[size-2] = 0xb504f333U;
+	min->data[size-1] = 0xf9de6485U;
+	#endif
+	mplshift(size, min->data, bits - 64);
+}
+#endif
+
+int rsakpMakeThreads(rsakp* kp, randomGeneratorContext* rgc, size_t bits, int threads)
+{
+	#if RSAKP_THREADS
+	size_t pbits = (bits+1) >> 1;
+	size_t qbits = (bits - pbits);
+	struct rsakpsearch s;
+	struct rsakpworker* w;
+	int i, started = 0;
+
+	# ifdef _SC_NPROCESSORS_ONLN
+	if (threads == 0)
+		threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	# endif
+
+	if (threads < 2 || qbits < 64)
+		return rsakpMake(kp, rgc, bits);
+
+	if ((w = (struct rsakpworker*) calloc(threads, sizeof(struct rsakpworker))) == (struct rsakpworker*) 0)
+		return -1;
+
+	if (pthread_mutex_init(&s.lock, (pthread_mutexattr_t*) 0))
+	{
+		free(w);
+		return -1;
 	}
-	return -1;
+
+	/* set e to default value if e is empty */
+	if (kp->e.size == 0 && !kp->e.data)
+		mpnsetw(&kp->e, 65537U);
+
+	/*
+	 * Instead of deriving the lower bound for q from p, both primes are
+	 * at least sqrt(2)/2 times the largest number of their size, which
+	 * guarantees that n gets the full number of bits, and allows the two
+	 * searches to run at the same time.
+	 */
+	s.rgc = rgc;
+	s.e = &kp->e;
+	s.bits[0] = pbits;
+	s.bits[1] = qbits;
+	s.found[0] = s.found[1] = 0;
+	s.failed = 0;
+	for (i = 0; i < 2; i++)
+	{
+		mpnzero(&s.min[i]);
+		mpbzero(&s.prime[i]);
+		rsakpsetmin(&s.min[i], s.bits[i]);
+	}
+
+	for (i = 0; i < threads; i++)
+	{
+		w[i].search = &s;
+		w[i].index = i & 1;
+		if (pthread_create(&w[i].thread, (pthread_attr_t*) 0, rsakpsearchprime, w+i))
+			break;
+		started++;
+	}
+
+	if (started == 0)
+		rsakpsearchprime(w);
+	for (i = 0; i < started; i++)
+		pthread_join(w[i].thread, (void**) 0);
+
+	pthread_mutex_destroy(&s.lock);
+	mpnfree(&s.min[0]);
+	mpnfree(&s.min[1]);
+	free(w);
+
+	if (s.failed)
+	{
+		for (i = 0; i < 2; i++)
+		{
+			mpbwipe(&s.prime[i]);
+			mpbfree(&s.prime[i]);
+		}
+		return -1;
+	}
+
+	kp->p = s.prime[0];
+	kp->q = s.prime[1];
+
+	return rsakpfinish(kp, bits);
+	#else
+	return rsakpMake(kp, rgc, bits);
+	#endif
 }
 
 int rsakpInit(rsakp* kp)
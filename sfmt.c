@@ -0,0 +1,682 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file sfmt.c
+ * \brief SIMD-oriented Fast Mersenne Twister pseudo-random number generator.
+ *
+ * SFMT19937 was developed by Mutsuo Saito and Makoto Matsumoto; see
+ * http://www.math.sci.hiroshima-u.ac.jp/~m-mat/MT/SFMT/. Its recursion works
+ * on 128-bit words, which SSE2 computes directly; the output needs no
+ * tempering, so that it can be copied straight from the state.
+ *
+ * Jumping ahead by J steps multiplies the state by x^J modulo the
+ * generator's characteristic polynomial, evaluated with Horner's rule on
+ * copies of the state, as described by Haramoto et al. in "Efficient Jump
+ * Ahead for F2-Linear Random Number Generators".
+ *
+ * \warning This generator is not suitable for use in cryptography.
+ *
+ * \ingroup PRNG_m PRNG_mt_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/sfmt.h"
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+/*!\addtogroup PRNG_mt_m
+ * \{
+ */
+
+#define SFMT_POS1	122
+#define SFMT_SL1	18
+#define SFMT_SL2	1
+#define SFMT_SR1	11
+#define SFMT_SR2	1
+
+static const uint32_t sfmtmask[4] = { 0xdfffffefU, 0xddfecb7fU, 0xbffaffffU, 0xbffffff6U };
+static const uint32_t sfmtparity[4] = { 0x00000001U, 0x00000000U, 0x00000000U, 0x13c9e684U };
+
+/* the degree of the recursion's characteristic polynomial, 128 * SFMT_N */
+#define SFMT_POLYDEG	19968
+/* polynomials over GF(2) of degree up to SFMT_POLYDEG, one bit per coefficient */
+#define SFMT_POLYWORDS	((SFMT_POLYDEG + 64) >> 6)
+
+/*
+ * sfmtcharpoly
+ *  the characteristic polynomial of the recursion, lowest coefficient
+ *  first; it was obtained with the Berlekamp-Massey algorithm from the
+ *  least significant output bit
+ */
+static const uint64_t sfmtcharpoly[SFMT_POLYWORDS] = {
+	0x0000000000000001ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+	0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+	0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+	0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+	0x0000000000020000ULL, 0x0000000000000000ULL, 0x0000280000000000ULL, 0x0000100000010000ULL,
+	0x0000000000000000ULL, 0x00000000000000a0ULL, 0x0000000000000140ULL, 0x0000000a00000000ULL,
+	0x1100001400000000ULL, 0x8200000000000000ULL, 0x0000000000200000ULL, 0x0000000000540001ULL,
+	0x0000800008280000ULL, 0x0011400000000000ULL, 0x00a0800000000000ULL, 0x0000400000000000ULL,
+	0x0000000400000040ULL, 0x00000088000a0800ULL, 0x1000004400000500ULL, 0x000080a000000200ULL,
+	0x4400001400000020ULL, 0x0000002004400010ULL, 0x5008800108000808ULL, 0x0010000105500001ULL,
+	0x000200a0a2200002ULL, 0x0441000011008200ULL, 0x0802804020810400ULL, 0x011100880008000aULL,
+	0x000a040001054100ULL, 0x2020000082a20805ULL, 0x400040500015140aULL, 0x8820000810002804ULL,
+	0x0009415808808808ULL, 0xa00102a400010500ULL, 0xc2800000a0a0202aULL, 0x000404440002d011ULL,
+	0x0a8200020ad444a2ULL, 0x0111040115028080ULL, 0x028c170826050105ULL, 0x1512280000828020ULL,
+	0x4220144044141282ULL, 0x8008200044880c20ULL, 0x04d0501029419208ULL, 0x2260a9a201342400ULL,
+	0x42b011808200a0a0ULL, 0x6043668044470047ULL, 0x02800a0280028a42ULL, 0x101448840d038108ULL,
+	0x8a0249858605200fULL, 0x0614be1144282080ULL, 0x982846067854480eULL, 0x005aa00480a040d4ULL,
+	0x24915400e1456171ULL, 0x41a8002841a1a172ULL, 0x8236063b70e58020ULL, 0x045a0e4302c2c14eULL,
+	0x1e1281a00c8a020eULL, 0x363f214518ba8948ULL, 0x0271812261458186ULL, 0x1cc00e4401222930ULL,
+	0x2854d800a7263278ULL, 0x68b8aa40a02c9855ULL, 0x0373450904111bdcULL, 0x2600f3a0602350a0ULL,
+	0x644f4c31b0bb80a5ULL, 0xd20a1d4608ef2560ULL, 0x8a0b4b9211312406ULL, 0x82ae7517009f9982ULL,
+	0x601756539a200074ULL, 0x640a70122436867cULL, 0x8020484dc862a715ULL, 0xe2e2e81b48d8b424ULL,
+	0x72b122c30548ac38ULL, 0xd2a3870790381012ULL, 0xcb56e0eece1c70b7ULL, 0x3502990347470682ULL,
+	0xa8601f8b5c7411e1ULL, 0x3775a12a833a30b5ULL, 0x052143a0016f9a44ULL, 0xce3b6a1212780c22ULL,
+	0xc05c5070c11b954eULL, 0xa6b0b13223bc8d00ULL, 0x26110291d7d998c0ULL, 0x2097e7a161246d50ULL,
+	0x8d4d25c4574d475cULL, 0x152e14187c8b1e6bULL, 0xda950b3fcb88e537ULL, 0x835944751836d521ULL,
+	0x2636a40253002240ULL, 0xffef9c51964912a5ULL, 0x7d4964adc523308cULL, 0x69f98f32aa726ab9ULL,
+	0x47130b37425091ddULL, 0x401ab0ff24e21061ULL, 0x9453c512e050cd4bULL, 0x1ac684510d88fa5fULL,
+	0xa16ca218b2933017ULL, 0x5424cd6cea03afbaULL, 0x3df8a93b3b286b75ULL, 0x32873ba3471bc681ULL,
+	0x5b798315ecd48145ULL, 0xb45a9468ba2e3b9eULL, 0xd571d4457ecae4b2ULL, 0xc9d63e3bd3bbfa43ULL,
+	0x192bea7fa9441ce2ULL, 0x79b6d1bcc6cfa705ULL, 0xd63fc57efa82ca0bULL, 0xc839574ca64d7f35ULL,
+	0xecf5868d70ee9058ULL, 0x29f4a75568cf95dbULL, 0x67a6382493eac127ULL, 0xd196437f9f4a71cbULL,
+	0x1b3022c27d461c7fULL, 0xa6a567ce4085d0bcULL, 0xae311af7b7278a1eULL, 0xa48c600294a94bfcULL,
+	0xd624ca7a2f95b256ULL, 0x560241615d847f18ULL, 0xc6371879a520d42cULL, 0xd08d5f07d17e3abdULL,
+	0x3df9d3be7ad73124ULL, 0xc33686612cb4cbfaULL, 0x2dbe79740e8090c0ULL, 0x30a4a80f6d4c79ecULL,
+	0x5519d7912ce7f435ULL, 0xc764fa909d0b2688ULL, 0x27c655cfecc233f7ULL, 0xe85987a8af20a5f9ULL,
+	0xd411bc7314c8d5dcULL, 0x93899b016b45a3f0ULL, 0x61f5d113c20b0df0ULL, 0xb25da61e4a096903ULL,
+	0x0dbe028d6d3567afULL, 0x9fa2ffe90c694a8bULL, 0xddbc8fc13fbb001bULL, 0xd4f0394b007675b1ULL,
+	0x82a77db81439b4c5ULL, 0xe3926b17cba15b02ULL, 0x8c9459c774f90065ULL, 0xc96951bd97a7280dULL,
+	0xd05abe912bca7f94ULL, 0x60711d1a815f1c57ULL, 0x042d25ce0d6cfd66ULL, 0xe26807fc63178c4fULL,
+	0x7ce8a197b575c993ULL, 0x40b7cd97348c4e6eULL, 0x4121abca0b44faf6ULL, 0xe52018057e436e7cULL,
+	0xeee29d71348ff820ULL, 0x5897af73be049411ULL, 0x0a6fdc8a2abfe601ULL, 0x9927489f06e9acb9ULL,
+	0x212a9e204d2b3555ULL, 0x726f34b152c7e23bULL, 0xba18032b9081e787ULL, 0x1e6fd7621f8d4fceULL,
+	0xddc1ca0a680b74f2ULL, 0x0b73fbbb3926fb78ULL, 0x99f11bf5fbcb7c8cULL, 0xfa95b50d32e55b88ULL,
+	0x898481c3f32feb9fULL, 0x0c5530801a0da142ULL, 0xe8d7a917f97df770ULL, 0x4875f816a8423596ULL,
+	0xdbb428b030a50aa9ULL, 0x0e3950a4612c5231ULL, 0xe3e8182323c04d1dULL, 0x391f65dd70a31febULL,
+	0xd0037d2ea87036c2ULL, 0x585cb2a68d024115ULL, 0x3ca80652b82e08daULL, 0x1222a69b8994a108ULL,
+	0x4de6d9cdceae67bcULL, 0xddca8edabd55bf58ULL, 0xf6a0757e4667e48eULL, 0x9b32d9f9b71a27e7ULL,
+	0x40f2769f8f20f8f8ULL, 0x45043e807c88737fULL, 0xb8ee0dd038f6f4afULL, 0x1484c5e77d62c435ULL,
+	0x8dd2569dfa4d9131ULL, 0x5f523ec999db3861ULL, 0x3418fa6737e8b00dULL, 0x269f5801674ff9a5ULL,
+	0x0cd977b54925f868ULL, 0x0efe2aca2f5aac13ULL, 0x56317da6a2f6b8c4ULL, 0xe534d38250fa24ddULL,
+	0xdfa8dc9afeb39524ULL, 0xf68b95bdbfe9f66fULL, 0xcd69cc6772132bd7ULL, 0xb5b4dfded98e8544ULL,
+	0x0387409dcb87d8d7ULL, 0x8f0023832ffcb147ULL, 0x2765011aafc4140fULL, 0x83081b652eca2bddULL,
+	0x4d14a10e4b5b0ac3ULL, 0x7c88af6e819ec2c9ULL, 0x0e191e6f25748090ULL, 0xd6495ebd110a22f4ULL,
+	0xdbf1f3cefb3cbcdfULL, 0x9448bef759c292caULL, 0xa5634a3ae4d4acfbULL, 0x7164a8c8c26ad6a4ULL,
+	0x965e5a7cfb55c640ULL, 0xdcf519a0992e424eULL, 0x8f610efdff342da1ULL, 0xf9242248af2415d8ULL,
+	0x10c4b695164603b8ULL, 0x1e87d6082fa1757bULL, 0x7a57a7a99015387cULL, 0x286a730fd18197c4ULL,
+	0x337303598db3d5d7ULL, 0xfec20b20ffa6cb03ULL, 0x420ebf29112f2932ULL, 0x854a5d8b53939260ULL,
+	0xcb1a14d9f27695a2ULL, 0x70d1a3a726ac668eULL, 0xf1b6da4284c007a7ULL, 0x72a04fdc5cb3134eULL,
+	0x2a3d847fe51d6b08ULL, 0x3b3b804a91cea167ULL, 0xc59263aa363cac3bULL, 0x034e799408af0885ULL,
+	0x006262ed52a6fa26ULL, 0xe0acc024778a11e8ULL, 0xcd4d4ab18447afcaULL, 0x576f160423a6c70cULL,
+	0x10631e8624500040ULL, 0x02221f668cc007feULL, 0x4b061c0105120745ULL, 0x2b15ed7d4b520260ULL,
+	0x20410d99d63883d1ULL, 0xe3375e48c3b54b20ULL, 0xcc86a05034ecdea6ULL, 0xced1542ae91014a1ULL,
+	0x622980024f61246eULL, 0x08b013659c68f806ULL, 0xf5909002f128b242ULL, 0x67d3234a7a8458beULL,
+	0x201ac293eeaa9176ULL, 0x0cb848026d5fa140ULL, 0x5c02883711114816ULL, 0x1c518a7c4631ec3aULL,
+	0x164ab085407e6130ULL, 0x00609822b1288189ULL, 0x420e03588aad0882ULL, 0xa0558040a144a900ULL,
+	0x0054b1a8b0022848ULL, 0x0a974810486c5464ULL, 0x20406990422a4880ULL, 0x04201d5a0c864f08ULL,
+	0x00a14580208b518bULL, 0x2020d0b080740015ULL, 0xc000b3323000a400ULL, 0x13011049400a9948ULL,
+	0x8348220c6a884c49ULL, 0x91500a5781080941ULL, 0x16a001b492002140ULL, 0x00a480923051a804ULL,
+	0x1b11001460854081ULL, 0x010442001c20810aULL, 0x001a4d8101a30803ULL, 0x4552001182b32021ULL,
+	0x900000c8b61000a0ULL, 0x4831008010402074ULL, 0xa9d1000a00180808ULL, 0x2040020c42038108ULL,
+	0x80400040a0a03122ULL, 0x448808048a111020ULL, 0x0e8a1110001440a0ULL, 0x0889100200080804ULL,
+	0x2201120805400101ULL, 0x2000000040888030ULL, 0x0450880048841500ULL, 0x0408801100800028ULL,
+	0x00a8414002010808ULL, 0x2220010280560201ULL, 0x000000020000a804ULL, 0x20050080000a0050ULL,
+	0x01000a0000000000ULL, 0x1100800400000008ULL, 0x0022000000004020ULL, 0x0000000000100080ULL,
+	0x0000000000000004ULL, 0x0800000000000000ULL, 0x0010000040000000ULL, 0x0000200000000002ULL,
+	0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+	0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+	0x0000000000000001ULL
+};
+
+const randomGenerator sfmtprng = {
+	"SFMT",
+	sizeof(sfmtParam),
+	(randomGeneratorSetup) sfmtSetup,
+	(randomGeneratorSeed) sfmtSeed,
+	(randomGeneratorNext) sfmtNext,
+	(randomGeneratorCleanup) sfmtCleanup
+};
+
+/*
+ * sfmtrecursion
+ *  r = a ^ (a << 8*SL2) ^ ((b >> SR1) & mask) ^ (c >> 8*SR2) ^ (d << SL1),
+ *  where the byte shifts apply to a and c as 128-bit numbers, and the
+ *  others to each 32-bit word; r may be the same as a
+ */
+static void sfmtrecursion(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* c, const uint32_t* d)
+{
+	uint32_t x[4], y[4];
+	register int i;
+
+	x[3] = (a[3] << (8*SFMT_SL2)) | (a[2] >> (32-8*SFMT_SL2));
+	x[2] = (a[2] << (8*SFMT_SL2)) | (a[1] >> (32-8*SFMT_SL2));
+	x[1] = (a[1] << (8*SFMT_SL2)) | (a[0] >> (32-8*SFMT_SL2));
+	x[0] = (a[0] << (8*SFMT_SL2));
+	y[3] = (c[3] >> (8*SFMT_SR2));
+	y[2] = (c[2] >> (8*SFMT_SR2)) | (c[3] << (32-8*SFMT_SR2));
+	y[1] = (c[1] >> (8*SFMT_SR2)) | (c[2] << (32-8*SFMT_SR2));
+	y[0] = (c[0] >> (8*SFMT_SR2)) | (c[1] << (32-8*SFMT_SR2));
+
+	for (i = 0; i < 4; i++)
+		r[i] = a[i] ^ x[i] ^ ((b[i] >> SFMT_SR1) & sfmtmask[i]) ^ y[i] ^ (d[i] << SFMT_SL1);
+}
+
+#if defined(__SSE2__)
+static inline __m128i sfmtrecursion2(__m128i a, __m128i b, __m128i c, __m128i d, __m128i mask)
+{
+	__m128i x = _mm_slli_si128(a, SFMT_SL2);
+	__m128i y = _mm_srli_si128(c, SFMT_SR2);
+	__m128i z = _mm_and_si128(_mm_srli_epi32(b, SFMT_SR1), mask);
+	__m128i v = _mm_slli_epi32(d, SFMT_SL1);
+
+	return _mm_xor_si128(_mm_xor_si128(_mm_xor_si128(a, x), _mm_xor_si128(y, z)), v);
+}
+#endif
+
+/*
+ * sfmtreload
+ *  generates the next block of SFMT_N words; each word depends on the two
+ *  before it, so the words are computed one after the other
+ */
+static void sfmtreload(uint32_t* st)
+{
+	#if defined(__SSE2__)
+	__m128i* s = (__m128i*) st;
+	__m128i mask = _mm_loadu_si128((const __m128i*) sfmtmask);
+	__m128i r1 = _mm_loadu_si128(s + SFMT_N - 2);
+	__m128i r2 = _mm_loadu_si128(s + SFMT_N - 1);
+	__m128i r;
+	register int i;
+
+	for (i = 0; i < SFMT_N - SFMT_POS1; i++)
+	{
+		r = sfmtrecursion2(_mm_loadu_si128(s + i), _mm_loadu_si128(s + i + SFMT_POS1), r1, r2, mask);
+		_mm_storeu_si128(s + i, r);
+		r1 = r2;
+		r2 = r;
+	}
+	for (; i < SFMT_N; i++)
+	{
+		r = sfmtrecursion2(_mm_loadu_si128(s + i), _mm_loadu_si128(s + i + SFMT_POS1 - SFMT_N), r1, r2, mask);
+		_mm_storeu_si128(s + i, r);
+		r1 = r2;
+		r2 = r;
+	}
+	#else
+	register uint32_t *r1 = st + 4*(SFMT_N - 2), *r2 = st + 4*(SFMT_N - 1);
+	register int i;
+
+	for (i = 0; i < SFMT_N - SFMT_POS1; i++)
+	{
+		sfmtrecursion(st + 4*i, st + 4*i, st + 4*(i + SFMT_POS1), r1, r2);
+		r1 = r2;
+		r2 = st + 4*i;
+	}
+	for (; i < SFMT_N; i++)
+	{
+		sfmtrecursion(st + 4*i, st + 4*i, st + 4*(i + SFMT_POS1 - SFMT_N), r1, r2);
+		r1 = r2;
+		r2 = st + 4*i;
+	}
+	#endif
+}
+
+/*
+ * sfmtstep
+ *  generates a single word of a state kept as a ring, of which pos is the
+ *  oldest word; SFMT_N steps from position zero amount to sfmtreload
+ */
+static void sfmtstep(uint32_t* st, unsigned int* pos)
+{
+	register unsigned int p = *pos;
+
+	sfmtrecursion(st + 4*p, st + 4*p, st + 4*((p + SFMT_POS1) % SFMT_N), st + 4*((p + SFMT_N - 2) % SFMT_N), st + 4*((p + SFMT_N - 1) % SFMT_N));
+
+	*pos = (p + 1) % SFMT_N;
+}
+
+/*
+ * sfmtcertify
+ *  makes sure the state lies in the subspace of period 2^19937-1, by
+ *  flipping a bit if necessary
+ */
+static void sfmtcertify(uint32_t* st)
+{
+	uint32_t inner = 0, work;
+	register int i, j;
+
+	for (i = 0; i < 4; i++)
+		inner ^= st[i] & sfmtparity[i];
+	for (i = 16; i > 0; i >>= 1)
+		inner ^= inner >> i;
+
+	if (inner & 1)
+		return;
+
+	for (i = 0; i < 4; i++)
+	{
+		for (j = 0, work = 1; j < 32; j++, work <<= 1)
+		{
+			if (work & sfmtparity[i])
+			{
+				st[i] ^= work;
+				return;
+			}
+		}
+	}
+}
+
+/*
+ * sfmtkey
+ *  returns 32-bit word j of the seed, padding the last one with zeros
+ */
+static uint32_t sfmtkey(const byte* data, size_t size, size_t j)
+{
+	uint32_t w = 0;
+
+	if (4*j + 4 <= size)
+		memcpy(&w, data + 4*j, 4);
+	else
+		memcpy(&w, data + 4*j, size - 4*j);
+
+	return w;
+}
+
+#define sfmtfunc1(x)	(((x) ^ ((x) >> 27)) * 1664525U)
+#define sfmtfunc2(x)	(((x) ^ ((x) >> 27)) * 1566083941U)
+
+/*
+ * sfmtinit
+ *  initializes the state from a seed, as init_by_array does
+ */
+static void sfmtinit(uint32_t* st, const byte* data, size_t size)
+{
+	const size_t lag = 11, mid = (SFMT_N32 - 11) / 2, keys = (size + 3) >> 2;
+	size_t i, j, count = (keys + 1 > SFMT_N32) ? keys + 1 : SFMT_N32;
+	uint32_t r;
+
+	memset(st, 0x8b, SFMT_N32 * sizeof(uint32_t));
+
+	r = sfmtfunc1(st[0] ^ st[mid] ^ st[SFMT_N32 - 1]);
+	st[mid] += r;
+	r += (uint32_t) keys;
+	st[mid + lag] += r;
+	st[0] = r;
+	count--;
+
+	for (i = 1, j = 0; j < count; j++)
+	{
+		r = sfmtfunc1(st[i] ^ st[(i + mid) % SFMT_N32] ^ st[(i + SFMT_N32 - 1) % SFMT_N32]);
+		st[(i + mid) % SFMT_N32] += r;
+		r += (uint32_t) i;
+		if (j < keys)
+			r += sfmtkey(data, size, j);
+		st[(i + mid + lag) % SFMT_N32] += r;
+		st[i] = r;
+		i = (i + 1) % SFMT_N32;
+	}
+	for (j = 0; j < SFMT_N32; j++)
+	{
+		r = sfmtfunc2(st[i] + st[(i + mid) % SFMT_N32] + st[(i + SFMT_N32 - 1) % SFMT_N32]);
+		st[(i + mid) % SFMT_N32] ^= r;
+		r -= (uint32_t) i;
+		st[(i + mid + lag) % SFMT_N32] ^= r;
+		st[i] = r;
+		i = (i + 1) % SFMT_N32;
+	}
+
+	sfmtcertify(st);
+}
+
+static int sfmtlock(sfmtParam* sp)
+{
+	#ifdef _REENTRANT
+	# if WIN32
+	if (WaitForSingleObject(sp->lock, INFINITE) != WAIT_OBJECT_0)
+		return -1;
+	# else
+	#  if HAVE_THREAD_H && HAVE_SYNCH_H
+	if (mutex_lock(&sp->lock))
+		return -1;
+	#  elif HAVE_PTHREAD_H
+	if (pthread_mutex_lock(&sp->lock))
+		return -1;
+	#  endif
+	# endif
+	#endif
+	return 0;
+}
+
+static int sfmtunlock(sfmtParam* sp)
+{
+	#ifdef _REENTRANT
+	# if WIN32
+	if (!ReleaseMutex(sp->lock))
+		return -1;
+	# else
+	#  if HAVE_THREAD_H && HAVE_SYNCH_H
+	if (mutex_unlock(&sp->lock))
+		return -1;
+	#  elif HAVE_PTHREAD_H
+	if (pthread_mutex_unlock(&sp->lock))
+		return -1;
+	#  endif
+	# endif
+	#endif
+	return 0;
+}
+
+int sfmtSetup(sfmtParam* sp)
+{
+	if (sp)
+	{
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!(sp->lock = CreateMutex(NULL, FALSE, NULL)))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_init(&sp->lock, USYNC_THREAD, (void *) 0))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_init(&sp->lock, (pthread_mutexattr_t *) 0))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		sp->idx = SFMT_N32;
+
+		if (entropyGatherNext((byte*) sp->state, sizeof(sp->state)))
+			return -1;
+
+		sfmtcertify(sp->state);
+
+		return 0;
+	}
+	return -1;
+}
+
+int sfmtSeedUnlocked(sfmtParam* sp, const byte* data, size_t size)
+{
+	if (sp && data)
+	{
+		sfmtinit(sp->state, data, size);
+		sp->idx = SFMT_N32;
+		return 0;
+	}
+	return -1;
+}
+
+int sfmtSeed(sfmtParam* sp, const byte* data, size_t size)
+{
+	if (sp)
+	{
+		int rc;
+
+		if (sfmtlock(sp))
+			return -1;
+
+		rc = sfmtSeedUnlocked(sp, data, size);
+
+		if (sfmtunlock(sp))
+			return -1;
+
+		return rc;
+	}
+	return -1;
+}
+
+int sfmtNextUnlocked(sfmtParam* sp, byte* data, size_t size)
+{
+	if (sp)
+	{
+		while (size > 0)
+		{
+			size_t n;
+
+			if (sp->idx >= SFMT_N32)
+			{
+				sfmtreload(sp->state);
+				sp->idx = 0;
+			}
+
+			n = (SFMT_N32 - sp->idx) * sizeof(uint32_t);
+			if (n > size)
+				n = size;
+
+			/* a partial word is used up all the same */
+			memcpy(data, sp->state + sp->idx, n);
+			sp->idx += (uint32_t) ((n + 3) >> 2);
+
+			data += n;
+			size -= n;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int sfmtNext(sfmtParam* sp, byte* data, size_t size)
+{
+	if (sp)
+	{
+		int rc;
+
+		if (sfmtlock(sp))
+			return -1;
+
+		rc = sfmtNextUnlocked(sp, data, size);
+
+		if (sfmtunlock(sp))
+			return -1;
+
+		return rc;
+	}
+	return -1;
+}
+
+/*
+ * sfmtpolysqr
+ *  squares a, a polynomial of degree below SFMT_POLYDEG, into t, which must
+ *  have room for 2*SFMT_POLYWORDS words; squaring over GF(2) spreads out
+ *  the bits
+ */
+static void sfmtpolysqr(uint64_t* t, const uint64_t* a)
+{
+	register int i, k;
+
+	for (i = 0; i < SFMT_POLYWORDS; i++)
+	{
+		for (k = 0; k < 2; k++)
+		{
+			register uint64_t x = (a[i] >> (32*k)) & 0xffffffffU;
+
+			x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+			x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+			x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+			x = (x | (x << 2)) & 0x3333333333333333ULL;
+			x = (x | (x << 1)) & 0x5555555555555555ULL;
+
+			t[2*i + k] = x;
+		}
+	}
+}
+
+/*
+ * sfmtpolymod
+ *  reduces t, of degree below 2*SFMT_POLYDEG, modulo the characteristic
+ *  polynomial; shifted holds the polynomial shifted by 0 to 63 bits, each
+ *  in SFMT_POLYWORDS+1 words
+ */
+static void sfmtpolymod(uint64_t* t, const uint64_t* shifted)
+{
+	register int k, i;
+
+	for (k = 2*SFMT_POLYDEG - 2; k >= SFMT_POLYDEG; k--)
+	{
+		if ((t[k >> 6] >> (k & 63)) & 1)
+		{
+			register int off = k - SFMT_POLYDEG;
+			register const uint64_t* p = shifted + (off & 63) * (SFMT_POLYWORDS+1);
+			register uint64_t* q = t + (off >> 6);
+
+			for (i = 0; i <= SFMT_POLYWORDS; i++)
+				q[i] ^= p[i];
+		}
+	}
+}
+
+/*
+ * sfmtjumppoly
+ *  computes x^steps modulo the characteristic polynomial
+ */
+static int sfmtjumppoly(uint64_t* jump, uint64_t steps)
+{
+	uint64_t* shifted = (uint64_t*) calloc(64 * (SFMT_POLYWORDS+1) + 2 * SFMT_POLYWORDS + 1, sizeof(uint64_t));
+	uint64_t* t;
+	register int i, s, bit;
+
+	if (shifted == (uint64_t*) 0)
+		return -1;
+
+	t = shifted + 64 * (SFMT_POLYWORDS+1);
+
+	for (s = 0; s < 64; s++)
+	{
+		uint64_t* p = shifted + s * (SFMT_POLYWORDS+1);
+
+		for (i = 0; i < SFMT_POLYWORDS; i++)
+		{
+			p[i] ^= sfmtcharpoly[i] << s;
+			if (s)
+				p[i+1] ^= sfmtcharpoly[i] >> (64 - s);
+		}
+	}
+
+	memset(jump, 0, SFMT_POLYWORDS * sizeof(uint64_t));
+	jump[0] = 1;
+
+	/* square and multiply by x, from the most significant bit of steps */
+	for (bit = 63; bit >= 0; bit--)
+	{
+		sfmtpolysqr(t, jump);
+		sfmtpolymod(t, shifted);
+		memcpy(jump, t, SFMT_POLYWORDS * sizeof(uint64_t));
+
+		if ((steps >> bit) & 1)
+		{
+			for (i = SFMT_POLYWORDS - 1; i > 0; i--)
+				jump[i] = (jump[i] << 1) | (jump[i-1] >> 63);
+			jump[0] <<= 1;
+
+			if ((jump[SFMT_POLYDEG >> 6] >> (SFMT_POLYDEG & 63)) & 1)
+				for (i = 0; i < SFMT_POLYWORDS; i++)
+					jump[i] ^= sfmtcharpoly[i];
+		}
+	}
+
+	free(shifted);
+
+	return 0;
+}
+
+int sfmtJump(sfmtParam* sp, uint64_t steps)
+{
+	if (sp)
+	{
+		uint64_t jump[SFMT_POLYWORDS];
+		uint32_t* work;
+		uint32_t* st;
+		unsigned int pos = 0;
+		register int i, j;
+		int rc = -1;
+
+		if (sfmtjumppoly(jump, steps))
+			return -1;
+
+		if ((work = (uint32_t*) calloc(2 * SFMT_N32, sizeof(uint32_t))) == (uint32_t*) 0)
+			return -1;
+
+		st = work + SFMT_N32;
+
+		if (sfmtlock(sp))
+			goto cleanup;
+
+		/* the state's block starts at position zero of the ring */
+		memcpy(st, sp->state, sizeof(sp->state));
+
+		/* work = sum of jump_j * T^j(state), lining up the rings */
+		for (i = 0; i <= SFMT_POLYDEG; i++)
+		{
+			if ((jump[i >> 6] >> (i & 63)) & 1)
+			{
+				for (j = 0; j < SFMT_N32; j++)
+					work[j] ^= st[(4*pos + j) % SFMT_N32];
+			}
+			sfmtstep(st, &pos);
+		}
+
+		memcpy(sp->state, work, sizeof(sp->state));
+
+		rc = sfmtunlock(sp);
+
+cleanup:
+		memset(work, 0, 2 * SFMT_N32 * sizeof(uint32_t));
+		free(work);
+
+		return rc;
+	}
+	return -1;
+}
+
+int sfmtCleanup(sfmtParam* sp)
+{
+	if (sp)
+	{
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!CloseHandle(sp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_destroy(&sp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_destroy(&sp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return 0;
+	}
+	return -1;
+}
+
+/*!\}
+ */
@@ -31,6 +31,7 @@
 
 #include "beecrypt/sha1.h"
 #include "beecrypt/endianness.h"
+#include "beecrypt/shani.h"
 
 /*!\addtogroup HASH_sha1_m
  * \{
@@ -85,6 +86,9 @@ void sha1Process(sha1Param* sp)
 	register uint32_t *w;
 	register byte t;
 
+	if (shaniSha1Blocks(sp->h, (const byte*) sp->data, 1) == 0)
+		return;
+
 	#if WORDS_BIGENDIAN
 	w = sp->data + 16;
 	#else
@@ -220,6 +224,19 @@ int sha1Update(sha1Param* sp, const byte* data, size_t size)
 
 	while (size > 0)
 	{
+		if (sp->offset == 0 && size >= 64U)
+		{
+			/* hash whole blocks straight from the input, if the processor can */
+			register size_t nblocks = size >> 6;
+
+			if (shaniSha1Blocks(sp->h, data, nblocks) == 0)
+			{
+				data += nblocks << 6;
+				size -= nblocks << 6;
+				continue;
+			}
+		}
+
 		proclength = ((sp->offset + size) > 64U) ? (64U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
 		size -= proclength;
@@ -32,6 +32,7 @@
 #include "beecrypt/sha256.h"
 #include "beecrypt/sha2k32.h"
 #include "beecrypt/endianness.h"
+#include "beecrypt/shani.h"
 
 /*!\addtogroup HASH_sha256_m
  * \{
@@ -89,6 +90,9 @@ void sha256Process(register sha256Param* sp)
 	register const uint32_t *k;
 	register byte t;
 	
+	if (shaniSha256Blocks(sp->h, (const byte*) sp->data, 1) == 0)
+		return;
+
 	#if WORDS_BIGENDIAN
 	w = sp->data + 16;
 	#else
@@ -211,6 +215,19 @@ int sha256Update(register sha256Param* sp, const byte* data, size_t size)
 
 	while (size > 0)
 	{
+		if (sp->offset == 0 && size >= 64U)
+		{
+			/* hash whole blocks straight from the input, if the processor can */
+			register size_t nblocks = size >> 6;
+
+			if (shaniSha256Blocks(sp->h, data, nblocks) == 0)
+			{
+				data += nblocks << 6;
+				size -= nblocks << 6;
+				continue;
+			}
+		}
+
 		proclength = ((sp->offset + size) > 64U) ? (64U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
 		size -= proclength;
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file shani.c
+ * \brief SHA-1 and SHA-256 compression with the x86 SHA extensions.
+ *
+ * The SHA extensions perform four SHA-1 rounds or two SHA-256 rounds per
+ * instruction, and also compute the message schedule.
+ *
+ * \ingroup HASH_sha1_m HASH_sha256_m HASH_sha224_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/shani.h"
+
+#if (defined(__i386__) || defined(__x86_64__)) && ((defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || defined(__clang__))
+# include <immintrin.h>
+# include "beecrypt/cpu.h"
+# include "beecrypt/sha2k32.h"
+# define SHANI_AVAILABLE 1
+# define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+# define SHANI_FEATURES (CPUF_X86_SHA | CPUF_X86_SSE41 | CPUF_X86_SSSE3)
+#endif
+
+#if SHANI_AVAILABLE
+/*
+ * sha1Group
+ *  performs rounds 4g to 4g+3 for g >= 4, and advances the message schedule;
+ *  m0 holds the words for these rounds, m1 receives the last step for the
+ *  next group, m2 and m3 the first steps for later groups; the compiler
+ *  drops the schedule updates which the last groups don't need
+ */
+#define sha1Group(e0, e1, m0, m1, m2, m3, f) \
+	e0 = _mm_sha1nexte_epu32(e0, m0); \
+	e1 = abcd; \
+	m1 = _mm_sha1msg2_epu32(m1, m0); \
+	abcd = _mm_sha1rnds4_epu32(abcd, e0, f); \
+	m3 = _mm_sha1msg1_epu32(m3, m0); \
+	m2 = _mm_xor_si128(m2, m0)
+
+SHANI_TARGET
+static void sha1shani(uint32_t* h, const byte* data, size_t nblocks)
+{
+	const __m128i swap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+	__m128i abcd, e0, e1, abcdsave, e0save, m0, m1, m2, m3;
+
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) h), 0x1b);
+	e0 = _mm_set_epi32((int) h[4], 0, 0, 0);
+
+	while (nblocks--)
+	{
+		abcdsave = abcd;
+		e0save = e0;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data +  0)), swap);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16)), swap);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 32)), swap);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 48)), swap);
+
+		/* rounds 0 to 15, while the schedule gets going */
+		e0 = _mm_add_epi32(e0, m0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+		e1 = _mm_sha1nexte_epu32(e1, m1);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+		m0 = _mm_sha1msg1_epu32(m0, m1);
+
+		e0 = _mm_sha1nexte_epu32(e0, m2);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+		m1 = _mm_sha1msg1_epu32(m1, m2);
+		m0 = _mm_xor_si128(m0, m2);
+
+		sha1Group(e1, e0, m3, m0, m1, m2, 0);
+
+		/* rounds 16 to 79 */
+		sha1Group(e0, e1, m0, m1, m2, m3, 0);
+		sha1Group(e1, e0, m1, m2, m3, m0, 1);
+		sha1Group(e0, e1, m2, m3, m0, m1, 1);
+		sha1Group(e1, e0, m3, m0, m1, m2, 1);
+		sha1Group(e0, e1, m0, m1, m2, m3, 1);
+		sha1Group(e1, e0, m1, m2, m3, m0, 1);
+		sha1Group(e0, e1, m2, m3, m0, m1, 2);
+		sha1Group(e1, e0, m3, m0, m1, m2, 2);
+		sha1Group(e0, e1, m0, m1, m2, m3, 2);
+		sha1Group(e1, e0, m1, m2, m3, m0, 2);
+		sha1Group(e0, e1, m2, m3, m0, m1, 2);
+		sha1Group(e1, e0, m3, m0, m1, m2, 3);
+		sha1Group(e0, e1, m0, m1, m2, m3, 3);
+		sha1Group(e1, e0, m1, m2, m3, m0, 3);
+		sha1Group(e0, e1, m2, m3, m0, m1, 3);
+		sha1Group(e1, e0, m3, m0, m1, m2, 3);
+
+		e0 = _mm_sha1nexte_epu32(e0, e0save);
+		abcd = _mm_add_epi32(abcd, abcdsave);
+
+		data += 64;
+	}
+
+	_mm_storeu_si128((__m128i*) h, _mm_shuffle_epi32(abcd, 0x1b));
+	h[4] = (uint32_t) _mm_extract_epi32(e0, 3);
+}
+
+/*
+ * sha256Group
+ *  performs rounds 4g to 4g+3 for g >= 3, and advances the message schedule;
+ *  m0 holds the words for these rounds, m3 those of the previous group
+ */
+#define sha256Group(m0, m1, m2, m3, g) \
+	t = _mm_add_epi32(m0, _mm_loadu_si128((const __m128i*) (SHA2_32BIT_K + 4*(g)))); \
+	cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t); \
+	m1 = _mm_sha256msg2_epu32(_mm_add_epi32(m1, _mm_alignr_epi8(m0, m3, 4)), m0); \
+	abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0e)); \
+	m3 = _mm_sha256msg1_epu32(m3, m0)
+
+SHANI_TARGET
+static void sha256shani(uint32_t* h, const byte* data, size_t nblocks)
+{
+	const __m128i swap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+	__m128i abef, cdgh, abefsave, cdghsave, m0, m1, m2, m3, t;
+
+	/* the instructions keep the state as ABEF and CDGH */
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) h), 0xb1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (h + 4)), 0x1b);
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+	while (nblocks--)
+	{
+		abefsave = abef;
+		cdghsave = cdgh;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data +  0)), swap);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16)), swap);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 32)), swap);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 48)), swap);
+
+		/* rounds 0 to 11, while the schedule gets going */
+		t = _mm_add_epi32(m0, _mm_loadu_si128((const __m128i*) (SHA2_32BIT_K + 0)));
+		cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);
+		abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0e));
+
+		t = _mm_add_epi32(m1, _mm_loadu_si128((const __m128i*) (SHA2_32BIT_K + 4)));
+		cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);
+		abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0e));
+		m0 = _mm_sha256msg1_epu32(m0, m1);
+
+		t = _mm_add_epi32(m2, _mm_loadu_si128((const __m128i*) (SHA2_32BIT_K + 8)));
+		cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);
+		abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0e));
+		m1 = _mm_sha256msg1_epu32(m1, m2);
+
+		/* rounds 12 to 63 */
+		sha256Group(m3, m0, m1, m2,  3);
+		sha256Group(m0, m1, m2, m3,  4);
+		sha256Group(m1, m2, m3, m0,  5);
+		sha256Group(m2, m3, m0, m1,  6);
+		sha256Group(m3, m0, m1, m2,  7);
+		sha256Group(m0, m1, m2, m3,  8);
+		sha256Group(m1, m2, m3, m0,  9);
+		sha256Group(m2, m3, m0, m1, 10);
+		sha256Group(m3, m0, m1, m2, 11);
+		sha256Group(m0, m1, m2, m3, 12);
+		sha256Group(m1, m2, m3, m0, 13);
+		sha256Group(m2, m3, m0, m1, 14);
+		sha256Group(m3, m0, m1, m2, 15);
+
+		abef = _mm_add_epi32(abef, abefsave);
+		cdgh = _mm_add_epi32(cdgh, cdghsave);
+
+		data += 64;
+	}
+
+	t = _mm_shuffle_epi32(abef, 0x1b);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+	_mm_storeu_si128((__m128i*) h, _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i*) (h + 4), _mm_alignr_epi8(cdgh, t, 8));
+}
+#endif
+
+int shaniSha1Blocks(uint32_t* h, const byte* data, size_t nblocks)
+{
+	#if SHANI_AVAILABLE
+	if ((cpuFeatures() & SHANI_FEATURES) == SHANI_FEATURES)
+	{
+		sha1shani(h, data, nblocks);
+		return 0;
+	}
+	#endif
+
+	return -1;
+}
+
+int shaniSha256Blocks(uint32_t* h, const byte* data, size_t nblocks)
+{
+	#if SHANI_AVAILABLE
+	if ((cpuFeatures() & SHANI_FEATURES) == SHANI_FEATURES)
+	{
+		sha256shani(h, data, nblocks);
+		return 0;
+	}
+	#endif
+
+	return -1;
+}
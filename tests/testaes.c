@@ -26,6 +26,7 @@
 #include <stdio.h>
 
 #include "beecrypt/aes.h"
+#include "beecrypt/cpu.h"
 
 extern int fromhex(byte*, const char*);
 extern void hexdump(const byte*, size_t);
@@ -67,7 +68,7 @@ struct vector table[NVECTORS] = {
 	  DECRYPT }
 };
 
-int main()
+static int testvectors()
 {
 	int i, failures = 0;
 	aesParam param;
@@ -109,3 +110,96 @@ int main()
 
 	return failures;
 }
+
+#define NBLOCKS	19
+
+/*
+ * testmodes
+ *  runs the ECB, CBC and CTR functions with all processor features, and
+ *  compares the key schedule, output and feedback with those of the table
+ *  code
+ */
+static int testmodes()
+{
+	int failures = 0;
+	aesParam param[2];
+	uint32_t src[4*NBLOCKS];
+	uint32_t dst[2][4*NBLOCKS];
+	byte key[32];
+	size_t keybits;
+	unsigned int i, j, nblocks;
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = (byte) (i * 37 + 11);
+	for (i = 0; i < 4*NBLOCKS; i++)
+		src[i] = (uint32_t) i * 0x9e3779b9U;
+
+	for (keybits = 128; keybits <= 256; keybits += 64)
+	{
+		for (nblocks = 1; nblocks <= NBLOCKS; nblocks += 6)
+		{
+			for (j = 0; j < 5; j++)
+			{
+				for (i = 0; i < 2; i++)
+				{
+					cipherOperation op = (j & 1) ? DECRYPT : ENCRYPT;
+
+					/* the first pass uses the table code, the second all features */
+					cpuFeaturesMask(i ? ~0U : 0);
+
+					if (aesSetup(param+i, key, keybits, (j == 4) ? ENCRYPT : op))
+						return -1;
+					aesSetCTR(param+i, key, 0xfffffffe);
+
+					/* decrypt CBC in place */
+					memcpy(dst[i], src, sizeof(src));
+
+					switch (j)
+					{
+					case 0:
+						aes.ecb.encrypt(param+i, dst[i], src, nblocks);
+						break;
+					case 1:
+						aes.ecb.decrypt(param+i, dst[i], src, nblocks);
+						break;
+					case 2:
+						aes.cbc.encrypt(param+i, dst[i], src, nblocks);
+						break;
+					case 3:
+						aes.cbc.decrypt(param+i, dst[i], dst[i], nblocks);
+						break;
+					case 4:
+						aes.ctr.encrypt(param+i, dst[i], src, nblocks);
+						break;
+					}
+				}
+
+				if (memcmp(param[0].k, param[1].k, 16 * (param[0].nr + 1)))
+				{
+					printf("key schedule mismatch for %u bits\n", (unsigned) keybits);
+					failures++;
+				}
+				if (memcmp(dst[0], dst[1], sizeof(dst[0])) || memcmp(param[0].fdback, param[1].fdback, sizeof(param[0].fdback)))
+				{
+					printf("mode %u mismatch for %u bits, %u blocks\n", j, (unsigned) keybits, nblocks);
+					failures++;
+				}
+			}
+		}
+	}
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+
+	cpuFeaturesMask(0);
+	failures += testvectors();
+	cpuFeaturesMask(~0U);
+	failures += testvectors();
+	failures += testmodes();
+
+	return failures;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testblockmode.c
+ * \brief Unit test program for the generic block cipher modes.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "beecrypt/blockmode.h"
+#include "beecrypt/aes.h"
+#include "beecrypt/blowfish.h"
+
+/* a little over twice the number of blocks blockmode.c processes at once */
+#define NBLOCKS	19
+
+/*
+ * testcipher
+ *  compares CBC decryption and CTR encryption of 1 up to NBLOCKS blocks
+ *  in one call with the same done one block per call, and with CBC
+ *  decryption built from the raw decrypt function
+ */
+static int testcipher(const blockCipher* bc)
+{
+	int failures = 0;
+	unsigned int blockwords = bc->blocksize >> 2;
+	unsigned int nblocks, i, k;
+	blockCipherParam* param = (blockCipherParam*) malloc(bc->paramsize);
+	uint32_t src[4*NBLOCKS], cbc[4*NBLOCKS], dst[4*NBLOCKS], chk[4*NBLOCKS], fb[4];
+	byte key[16], iv[16];
+
+	for (i = 0; i < sizeof(key); i++)
+	{
+		key[i] = (byte) (i * 37 + 11);
+		iv[i] = (byte) (i * 53 + 7);
+	}
+	for (i = 0; i < 4*NBLOCKS; i++)
+		src[i] = (uint32_t) i * 0x9e3779b9U;
+
+	for (nblocks = 1; nblocks <= NBLOCKS; nblocks++)
+	{
+		unsigned int nwords = nblocks * blockwords;
+
+		/* make a CBC ciphertext */
+		bc->setup(param, key, 128, ENCRYPT);
+		bc->setiv(param, iv);
+		blockEncryptCBC(bc, param, cbc, src, nblocks);
+
+		/* the reference decryption, one raw block at a time */
+		bc->setup(param, key, 128, DECRYPT);
+		bc->setiv(param, iv);
+		for (i = 0; i < blockwords; i++)
+			fb[i] = bc->getfb(param)[i];
+		for (k = 0; k < nblocks; k++)
+		{
+			bc->raw.decrypt(param, chk + k * blockwords, cbc + k * blockwords);
+			for (i = 0; i < blockwords; i++)
+				chk[k * blockwords + i] ^= (k ? cbc[(k-1) * blockwords + i] : fb[i]);
+		}
+		if (memcmp(chk, src, nwords * sizeof(uint32_t)))
+		{
+			printf("%s: CBC round trip failed for %u blocks\n", bc->name, nblocks);
+			failures++;
+		}
+
+		/* all at once, in place */
+		bc->setiv(param, iv);
+		memcpy(dst, cbc, nwords * sizeof(uint32_t));
+		if (blockDecryptCBC(bc, param, dst, dst, nblocks) || memcmp(dst, chk, nwords * sizeof(uint32_t)) || memcmp(bc->getfb(param), cbc + nwords - blockwords, bc->blocksize))
+		{
+			printf("%s: CBC decryption in place failed for %u blocks\n", bc->name, nblocks);
+			failures++;
+		}
+
+		/* one block per call */
+		bc->setiv(param, iv);
+		for (k = 0; k < nblocks; k++)
+			blockDecryptCBC(bc, param, dst + k * blockwords, cbc + k * blockwords, 1);
+		if (memcmp(dst, chk, nwords * sizeof(uint32_t)))
+		{
+			printf("%s: CBC decryption per block failed for %u blocks\n", bc->name, nblocks);
+			failures++;
+		}
+
+		/* CTR, one block per call */
+		bc->setup(param, key, 128, ENCRYPT);
+		bc->setiv(param, iv);
+		for (k = 0; k < nblocks; k++)
+			blockEncryptCTR(bc, param, chk + k * blockwords, src + k * blockwords, 1);
+		for (i = 0; i < blockwords; i++)
+			fb[i] = bc->getfb(param)[i];
+
+		/* all at once */
+		bc->setiv(param, iv);
+		if (blockEncryptCTR(bc, param, dst, src, nblocks) || memcmp(dst, chk, nwords * sizeof(uint32_t)) || memcmp(bc->getfb(param), fb, bc->blocksize))
+		{
+			printf("%s: CTR failed for %u blocks\n", bc->name, nblocks);
+			failures++;
+		}
+	}
+
+	free(param);
+
+	return failures;
+}
+
+/* a cipher with blocks too large for the block modes; only its feedback is ever touched */
+static uint32_t widefb[64];
+
+static uint32_t* widegetfb(blockCipherParam* bp)
+{
+	return widefb;
+}
+
+static const blockCipher wide = { "wide", 0, sizeof(widefb), 0, 0, 0, 0, 0, 0, widegetfb };
+
+int main()
+{
+	int failures = 0;
+	uint32_t data[64];
+
+	failures += testcipher(&aes);
+	failures += testcipher(&blowfish);
+
+	if (blockDecryptCBC(&wide, (blockCipherParam*) 0, data, data, 1) != -1 || blockEncryptCTR(&wide, (blockCipherParam*) 0, data, data, 1) != -1)
+	{
+		printf("256-byte blocks weren't rejected\n");
+		failures++;
+	}
+
+	return failures;
+}
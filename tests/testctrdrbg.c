@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testctrdrbg.c
+ * \brief Unit test program for the AES-256 CTR_DRBG.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/ctrdrbg.h"
+#include "beecrypt/cpu.h"
+
+extern int fromhex(byte*, const char*);
+
+/* instantiation with entropy input 01 04 07 .. 5e, nonce a0 a1 .. af and
+ * personalization string "abcde", then a reseed with 48 bytes of entropy
+ * input 55 52 5b .. (0x55 ^ 7i); expected values from OpenSSL */
+static const char* expect[4] = {
+	"6b1410fbde6545631913b664a0821f8a6b9f49e1f66a0c3ab226760ebed2d35b77233cee601bda4ef9160200a8dd821a21f02d675aacb6ae9106771cba734185",
+	"28dc73d99177c609c67ed8c191e68320eb7ffb4718d11eb453e91e6a9a9c5bdbba121e9c8102065a",
+	"715157ec113057c84563ee38dc2b9689242aaf698bfc18089a64d3ce7dc0287b975c0091a6",
+	"df803a61dc8b2324fec5f7c67012d5ea6fab6c0a488dc439e6f210ac064e9819beb29a33ec6c1638c793d34043597c16d9d00d53adf91551ba5a66249a5fbcef"
+};
+
+static int testvectors()
+{
+	int failures = 0;
+	randomGeneratorContext rngc;
+	ctrdrbgParam* dp;
+	byte seed[53], reseed[48], chk[64], out[1000];
+	int i;
+
+	for (i = 0; i < 32; i++)
+		seed[i] = (byte) (i * 3 + 1);
+	for (i = 0; i < 16; i++)
+		seed[32+i] = (byte) (0xa0 + i);
+	memcpy(seed + 48, "abcde", 5);
+	for (i = 0; i < 48; i++)
+		reseed[i] = (byte) (0x55 ^ (i * 7));
+
+	/* the context holds parameters of the size the library was built with */
+	if (randomGeneratorContextInit(&rngc, &ctrdrbg))
+		return -1;
+
+	dp = (ctrdrbgParam*) rngc.param;
+	if (ctrdrbgInstantiate(dp, seed, sizeof(seed)))
+		return -1;
+
+	ctrdrbgNext(dp, out, 64);
+	fromhex(chk, expect[0]);
+	if (memcmp(out, chk, 64))
+	{
+		printf("failed first request\n");
+		failures++;
+	}
+
+	ctrdrbgNext(dp, out, 1000);
+	fromhex(chk, expect[1]);
+	if (memcmp(out + 960, chk, 40))
+	{
+		printf("failed long request\n");
+		failures++;
+	}
+
+	ctrdrbgSeed(dp, reseed, sizeof(reseed));
+
+	ctrdrbgNext(dp, out, 37);
+	fromhex(chk, expect[2]);
+	if (memcmp(out, chk, 37))
+	{
+		printf("failed request after reseed\n");
+		failures++;
+	}
+
+	ctrdrbgNext(dp, out, 64);
+	fromhex(chk, expect[3]);
+	if (memcmp(out, chk, 64))
+	{
+		printf("failed last request\n");
+		failures++;
+	}
+
+	if (randomGeneratorContextFree(&rngc))
+		return -1;
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	randomGeneratorContext rngc;
+	byte data[100];
+
+	cpuFeaturesMask(0);
+	failures += testvectors();
+	cpuFeaturesMask(~0U);
+	failures += testvectors();
+
+	/* the generator must also work through a context */
+	if (randomGeneratorContextInit(&rngc, randomGeneratorFind("AES-CTR-DRBG")))
+		return -1;
+	if (randomGeneratorContextNext(&rngc, data, sizeof(data)))
+		failures++;
+	if (randomGeneratorContextFree(&rngc))
+		failures++;
+
+	return failures;
+}
@@ -56,6 +56,33 @@ int main()
 
 		mpnfree(&gq);
 
+		dldp_pFree(&params);
+
+		/* make parameters with a safe prime p = 2q+1 of 512 bits, searched on several threads */
+		dldp_pInit(&params);
+		if (dldp_pgonMakeSafeThreads(&params, &rngc, 512, 4))
+		{
+			printf("failed test vector 2\n");
+			failures++;
+		}
+		else
+		{
+			mpnumber p;
+
+			mpnzero(&p);
+			mpnset(&p, params.q.size, params.q.modl);
+			mpmultwo(p.size, p.data);
+			mpaddw(p.size, p.data, 1);
+
+			if (dldp_pgonValidate(&params, &rngc) != 1 || mpbits(params.p.size, params.p.modl) != 512 || mpnex(p.size, p.data, params.p.size, params.p.modl))
+			{
+				printf("failed test vector 2\n");
+				failures++;
+			}
+
+			mpnfree(&p);
+		}
+
 		dldp_pFree(&params);
 		
 		randomGeneratorContextFree(&rngc);  
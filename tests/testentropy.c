@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testentropy.c
+ * \brief Unit test program for the entropy sources.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+
+/* larger than the 256 bytes getrandom(2) guarantees per call */
+#define NBYTES	1000
+
+static int filled(const byte* data, size_t size)
+{
+	size_t i;
+
+	/* a thousand zero bytes from a working source are not going to happen */
+	for (i = 0; i < size; i++)
+		if (data[i])
+			return 1;
+
+	return 0;
+}
+
+int main()
+{
+	int failures = 0;
+	const entropySource* es;
+	byte a[NBYTES], b[NBYTES];
+
+	/* the source is only listed where the system call exists, which every
+	 * supported Linux has */
+	es = entropySourceFind("getrandom");
+	#if defined(__linux__)
+	if (es == (const entropySource*) 0)
+	{
+		printf("getrandom not listed\n");
+		failures++;
+	}
+	#endif
+	if (es)
+	{
+		memset(a, 0, sizeof(a));
+		memset(b, 0, sizeof(b));
+
+		if (es->next(a, sizeof(a)) || es->next(b, sizeof(b)))
+		{
+			printf("getrandom failed\n");
+			failures++;
+		}
+		else if (!filled(a, sizeof(a)) || !filled(b, sizeof(b)) || memcmp(a, b, sizeof(a)) == 0)
+		{
+			printf("getrandom didn't fill the buffers\n");
+			failures++;
+		}
+	}
+
+	memset(a, 0, sizeof(a));
+
+	if (entropyGatherNext(a, sizeof(a)))
+	{
+		printf("default entropy source failed\n");
+		failures++;
+	}
+	else if (!filled(a, sizeof(a)))
+	{
+		printf("default entropy source didn't fill the buffer\n");
+		failures++;
+	}
+
+	return failures;
+}
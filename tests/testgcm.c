@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testgcm.c
+ * \brief Unit test program for AES in Galois/Counter Mode.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/aes.h"
+#include "beecrypt/gcm.h"
+#include "beecrypt/cpu.h"
+
+extern int fromhex(byte*, const char*);
+extern void hexdump(const byte*, size_t);
+
+struct vector
+{
+	char*	key;
+	char*	iv;
+	char*	aad;
+	char*	input;
+	char*	expect;
+	char*	tag;
+};
+
+#define NVECTORS 7
+
+/* test cases from the GCM specification by McGrew and Viega, plus one with
+ * a 60-byte IV, checked against OpenSSL */
+struct vector table[NVECTORS] = {
+	{ "00000000000000000000000000000000",
+	  "000000000000000000000000",
+	  "",
+	  "",
+	  "",
+	  "58e2fccefa7e3061367f1d57a4e7455a" },
+	{ "00000000000000000000000000000000",
+	  "000000000000000000000000",
+	  "",
+	  "00000000000000000000000000000000",
+	  "0388dace60b6a392f328c2b971b2fe78",
+	  "ab6e47d42cec13bdf53a67b21257bddf" },
+	{ "feffe9928665731c6d6a8f9467308308",
+	  "cafebabefacedbaddecaf888",
+	  "",
+	  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255",
+	  "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+	  "4d5c2af327cd64a62cf35abd2ba6fab4" },
+	{ "feffe9928665731c6d6a8f9467308308",
+	  "cafebabefacedbaddecaf888",
+	  "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+	  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+	  "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+	  "5bc94fbc3221a5db94fae95ae7121a47" },
+	{ "feffe9928665731c6d6a8f9467308308",
+	  "cafebabefacedbad",
+	  "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+	  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+	  "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c742373806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+	  "3612d2e79e3b0785561be14aaca2fccb" },
+	{ "feffe9928665731c6d6a8f9467308308",
+	  "9313225df88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+	  "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+	  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+	  "2b4b26fb49f400296428f090cdb8671a60f2f674c7d2635c67c52763caccfb7afbde37c47ceaeaf102e38224d71d8e8c6a6ed055a28dcef35ee92cd9",
+	  "9a58d4b7c0030413d4cc72a5b67c11df" },
+	{ "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+	  "cafebabefacedbaddecaf888",
+	  "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+	  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+	  "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+	  "76fc6ece0f4e1768cddf8853bb2d551b" }
+};
+
+static int testvectors()
+{
+	int i, failures = 0;
+	blockCipherContext bc;
+	gcmContext gcm;
+	byte key[32], iv[64], aad[32], src[64], dst[64], chk[64], tag[16], chktag[16];
+	size_t keybits, ivlen, aadlen, size;
+
+	if (blockCipherContextInit(&bc, &aes))
+		return -1;
+
+	for (i = 0; i < NVECTORS; i++)
+	{
+		keybits = fromhex(key, table[i].key) << 3;
+		ivlen = fromhex(iv, table[i].iv);
+		aadlen = fromhex(aad, table[i].aad);
+		size = fromhex(src, table[i].input);
+		fromhex(chk, table[i].expect);
+		fromhex(chktag, table[i].tag);
+
+		if (blockCipherContextSetup(&bc, key, keybits, ENCRYPT))
+			return -1;
+		if (gcmContextInit(&gcm, &bc))
+			return -1;
+
+		/* encrypt */
+		gcmContextSetIV(&gcm, iv, ivlen);
+		gcmContextUpdateAAD(&gcm, aad, aadlen);
+		if (gcmContextEncrypt(&gcm, dst, src, size))
+			return -1;
+		gcmContextDigest(&gcm, tag, 16);
+
+		if (memcmp(dst, chk, size) || memcmp(tag, chktag, 16))
+		{
+			printf("failed vector %d encryption\n", i+1);
+			failures++;
+		}
+
+		/* decrypt in place */
+		gcmContextSetIV(&gcm, iv, ivlen);
+		gcmContextUpdateAAD(&gcm, aad, aadlen);
+		if (gcmContextDecrypt(&gcm, dst, dst, size))
+			return -1;
+
+		if (memcmp(dst, src, size) || gcmContextVerify(&gcm, chktag, 16) != 1)
+		{
+			printf("failed vector %d decryption\n", i+1);
+			failures++;
+		}
+
+		/* a modified tag must be rejected */
+		chktag[15] ^= 1;
+
+		gcmContextSetIV(&gcm, iv, ivlen);
+		gcmContextUpdateAAD(&gcm, aad, aadlen);
+		gcmContextDecrypt(&gcm, dst, chk, size);
+
+		if (gcmContextVerify(&gcm, chktag, 16) != 0)
+		{
+			printf("failed vector %d verification\n", i+1);
+			failures++;
+		}
+
+		gcmContextFree(&gcm);
+	}
+
+	blockCipherContextFree(&bc);
+
+	return failures;
+}
+
+#define NBYTES	1031
+
+/* the tag of the whole stream, checked against OpenSSL */
+static const char* streamtag = "be5d78a14fefd04ba55032b3e17e2652";
+
+/*
+ * teststream
+ *  checks the tag of a long message, and that processing it in pieces of
+ *  odd sizes gives the same result as processing it at once, with and
+ *  without processor features
+ */
+static int teststream()
+{
+	int failures = 0;
+	blockCipherContext bc;
+	gcmContext gcm;
+	byte key[16], iv[12], aad[NBYTES], src[NBYTES], dst[3][NBYTES], tag[3][16], expect[16];
+	unsigned int i, j;
+	size_t off, chunk;
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = (byte) (i * 37 + 11);
+	for (i = 0; i < sizeof(iv); i++)
+		iv[i] = (byte) (i * 13 + 5);
+	for (i = 0; i < NBYTES; i++)
+	{
+		aad[i] = (byte) (i * 7 + 3);
+		src[i] = (byte) (i * 101 + 17);
+	}
+
+	if (blockCipherContextInit(&bc, &aes))
+		return -1;
+
+	for (j = 0; j < 3; j++)
+	{
+		/* the first pass uses the generic code, the others all features */
+		cpuFeaturesMask(j ? ~0U : 0);
+
+		if (blockCipherContextSetup(&bc, key, 128, ENCRYPT))
+			return -1;
+		if (gcmContextInit(&gcm, &bc))
+			return -1;
+
+		gcmContextSetIV(&gcm, iv, sizeof(iv));
+
+		if (j < 2)
+		{
+			gcmContextUpdateAAD(&gcm, aad, NBYTES);
+			gcmContextEncrypt(&gcm, dst[j], src, NBYTES);
+		}
+		else
+		{
+			for (off = 0, chunk = 1; off < NBYTES; off += chunk, chunk += 6)
+				gcmContextUpdateAAD(&gcm, aad + off, (off + chunk > NBYTES) ? NBYTES - off : chunk);
+			for (off = 0, chunk = 3; off < NBYTES; off += chunk, chunk += 10)
+				gcmContextEncrypt(&gcm, dst[j] + off, src + off, (off + chunk > NBYTES) ? NBYTES - off : chunk);
+		}
+
+		gcmContextDigest(&gcm, tag[j], 16);
+		gcmContextFree(&gcm);
+	}
+
+	fromhex(expect, streamtag);
+
+	if (memcmp(tag[0], expect, 16))
+	{
+		printf("failed stream tag\n");
+		failures++;
+	}
+
+	for (j = 1; j < 3; j++)
+	{
+		if (memcmp(dst[0], dst[j], NBYTES) || memcmp(tag[0], tag[j], 16))
+		{
+			printf("stream mismatch in pass %u\n", j);
+			failures++;
+		}
+	}
+
+	/* once text was processed, more AAD isn't allowed */
+	gcmContextInit(&gcm, &bc);
+	gcmContextSetIV(&gcm, iv, sizeof(iv));
+	gcmContextEncrypt(&gcm, dst[0], src, 1);
+	if (gcmContextUpdateAAD(&gcm, aad, 1) != -1)
+	{
+		printf("AAD accepted after text\n");
+		failures++;
+	}
+	gcmContextFree(&gcm);
+
+	blockCipherContextFree(&bc);
+
+	return failures;
+}
+
+/*
+ * teststate
+ *  checks that a message has to be started with an IV, and that a bad IV
+ *  leaves the message in progress alone
+ */
+static int teststate()
+{
+	int failures = 0;
+	blockCipherContext bc;
+	gcmContext gcm;
+	byte key[16], iv[12], src[32], dst[2][32], tag[2][16];
+	unsigned int i;
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = (byte) (i * 37 + 11);
+	for (i = 0; i < sizeof(iv); i++)
+		iv[i] = (byte) (i * 13 + 5);
+	for (i = 0; i < sizeof(src); i++)
+		src[i] = (byte) (i * 101 + 17);
+
+	if (blockCipherContextInit(&bc, &aes))
+		return -1;
+	if (blockCipherContextSetup(&bc, key, 128, ENCRYPT))
+		return -1;
+	if (gcmContextInit(&gcm, &bc))
+		return -1;
+
+	/* there's no implicit IV */
+	if (gcmContextUpdateAAD(&gcm, src, 1) != -1 || gcmContextEncrypt(&gcm, dst[0], src, 1) != -1 || gcmContextDecrypt(&gcm, dst[0], src, 1) != -1 || gcmContextDigest(&gcm, tag[0], 16) != -1)
+	{
+		printf("operation accepted without IV\n");
+		failures++;
+	}
+
+	/* a null or empty IV is refused, and doesn't disturb the message */
+	gcmContextSetIV(&gcm, iv, sizeof(iv));
+	gcmContextEncrypt(&gcm, dst[0], src, 13);
+	if (gcmContextSetIV(&gcm, (const byte*) 0, sizeof(iv)) != -1 || gcmContextSetIV(&gcm, iv, 0) != -1)
+	{
+		printf("bad IV accepted\n");
+		failures++;
+	}
+	gcmContextEncrypt(&gcm, dst[0] + 13, src + 13, sizeof(src) - 13);
+	gcmContextDigest(&gcm, tag[0], 16);
+
+	gcmContextSetIV(&gcm, iv, sizeof(iv));
+	gcmContextEncrypt(&gcm, dst[1], src, sizeof(src));
+	gcmContextDigest(&gcm, tag[1], 16);
+
+	if (memcmp(dst[0], dst[1], sizeof(src)) || memcmp(tag[0], tag[1], 16))
+	{
+		printf("bad IV disturbed the message\n");
+		failures++;
+	}
+
+	/* tag lengths NIST SP 800-38D doesn't allow are refused, and leave the
+	 * message unfinished */
+	gcmContextSetIV(&gcm, iv, sizeof(iv));
+	gcmContextEncrypt(&gcm, dst[1], src, sizeof(src));
+	if (gcmContextDigest(&gcm, tag[1], 1) != -1 || gcmContextVerify(&gcm, tag[0], 1) != 0 || gcmContextVerify(&gcm, tag[0], 10) != 0)
+	{
+		printf("bad tag length accepted\n");
+		failures++;
+	}
+	if (gcmContextVerify(&gcm, tag[0], 12) != 1)
+	{
+		printf("truncated tag rejected\n");
+		failures++;
+	}
+
+	/* a finished message needs a new IV */
+	if (gcmContextEncrypt(&gcm, dst[0], src, 1) != -1)
+	{
+		printf("encryption accepted after the tag\n");
+		failures++;
+	}
+
+	gcmContextFree(&gcm);
+	blockCipherContextFree(&bc);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+
+	cpuFeaturesMask(0);
+	failures += testvectors();
+	cpuFeaturesMask(~0U);
+	failures += testvectors();
+	failures += teststream();
+	failures += teststate();
+
+	return failures;
+}
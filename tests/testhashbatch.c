@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testhashbatch.c
+ * \brief Unit test program for batch hashing.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/cpu.h"
+
+#define NITEMS	53
+#define NBYTES	(NITEMS * 64)
+
+static const char* names[] = { "MD5", "SHA-1", "SHA-224", "SHA-256", "SHA-512" };
+
+/* no acceleration, AVX2 only, no SHA extensions, everything */
+static const unsigned int masks[] = {
+	0,
+	CPUF_X86_AVX2,
+	~CPUF_X86_SHA,
+	~0U
+};
+
+/*
+ * testbatch
+ *  hashes messages of many different sizes as one batch, and compares the
+ *  digests with those computed one at a time
+ */
+static int testbatch(const hashFunction* hash, unsigned int mask)
+{
+	int failures = 0;
+	hashFunctionContext ctxt;
+	hashFunctionBatchItem items[NITEMS];
+	byte data[NBYTES];
+	byte digest[NITEMS][64];
+	byte check[64];
+	size_t i, off;
+
+	for (i = 0; i < NBYTES; i++)
+		data[i] = (byte) (i * 101 + 17);
+
+	/* sizes around the padding boundaries, and a few longer ones */
+	for (i = 0, off = 0; i < NITEMS; i++)
+	{
+		items[i].data = data + off;
+		items[i].size = (i % 7 == 6) ? 64 * (i % 23) + i : (i * 13) % 130;
+		if (off + items[i].size > NBYTES)
+			items[i].size = NBYTES - off;
+		items[i].digest = digest[i];
+		off = (off + 31) % 1000;
+	}
+
+	cpuFeaturesMask(mask);
+
+	if (hashFunctionBatchDigest(hash, items, NITEMS))
+		return -1;
+
+	cpuFeaturesMask(~0U);
+
+	if (hashFunctionContextInit(&ctxt, hash))
+		return -1;
+
+	for (i = 0; i < NITEMS; i++)
+	{
+		hashFunctionContextUpdate(&ctxt, items[i].data, items[i].size);
+		hashFunctionContextDigest(&ctxt, check);
+
+		if (memcmp(check, digest[i], hash->digestsize))
+		{
+			printf("%s mismatch for item %u of %u bytes with features %x\n", hash->name, (unsigned) i, (unsigned) items[i].size, mask);
+			failures++;
+		}
+	}
+
+	hashFunctionContextFree(&ctxt);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	unsigned int i, j;
+
+	for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		const hashFunction* hash = hashFunctionFind(names[i]);
+
+		if (hash == (const hashFunction*) 0)
+		{
+			printf("%s not found\n", names[i]);
+			failures++;
+			continue;
+		}
+
+		for (j = 0; j < sizeof(masks) / sizeof(masks[0]); j++)
+			failures += testbatch(hash, masks[j]);
+	}
+
+	return failures;
+}
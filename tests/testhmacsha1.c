@@ -96,6 +96,27 @@ int main()
 			printf("failed test vector %d\n", i+1);
 			failures++;
 		}
+
+		/* the digest leaves the context ready for the next message, and a
+		 * reset discards a partial one */
+		if (hmacsha1Update(&param, table[i].input, 3))
+			return -1;
+		if (hmacsha1Reset(&param))
+			return -1;
+		if (hmacsha1Update(&param, table[i].input, table[i].input_size))
+			return -1;
+		if (hmacsha1Digest(&param, digest))
+			return -1;
+		if (hmacsha1Update(&param, table[i].input, table[i].input_size))
+			return -1;
+		if (hmacsha1Digest(&param, digest))
+			return -1;
+
+		if (memcmp(digest, table[i].expect, 20))
+		{
+			printf("failed test vector %d reuse\n", i+1);
+			failures++;
+		}
 	}
 
 	return failures;
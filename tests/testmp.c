@@ -2,6 +2,7 @@
 
 #include "beecrypt/beecrypt.h"
 #include "beecrypt/mp.h"
+#include "beecrypt/cpu.h"
 
 #define INIT	0xdeadbeefU;
 
@@ -10,6 +11,175 @@ static const mpw F[4] = { MP_ALLMASK, MP_ALLMASK, MP_ALLMASK, MP_ALLMASK};
 static const mpw P[8] = { MP_ALLMASK, MP_ALLMASK, MP_ALLMASK, MP_ALLMASK-1U, 0U, 0U, 0U, 1U };
 static const mpw SM[5] = { MP_ALLMASK-1U, MP_ALLMASK, MP_ALLMASK, MP_ALLMASK, 1U };
 
+/* large enough to exercise a few levels of the Karatsuba recursion */
+#define KSIZE	(4*MP_KARATSUBA_MUL_THRESHOLD+4*MP_KARATSUBA_SQR_THRESHOLD+1)
+
+static mpw kf[KSIZE];
+static mpw kp[2*KSIZE];
+static mpw kr[2*KSIZE];
+static mpw kw[4*KSIZE];
+static mpw kx[KSIZE];
+static mpw ky[KSIZE];
+
+/*
+ * refmul
+ *  the schoolbook product, one row at a time, as a reference
+ */
+static void refmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
+{
+	register mpw rc;
+
+	result += ysize;
+	ydata += ysize;
+
+	rc = mpsetmul(xsize, result, xdata, *(--ydata));
+	*(--result) = rc;
+
+	while (--ysize)
+	{
+		rc = mpaddmul(xsize, result, xdata, *(--ydata));
+		*(--result) = rc;
+	}
+}
+
+/* a 32-bit xorshift generator, for reproducible operands */
+static mpw xorshift(uint32_t* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+
+	return (mpw) *state;
+}
+
+static int testlarge()
+{
+	int i;
+
+	/* (W^n - 1) * (W^m - 1) for all sizes around the Karatsuba thresholds */
+	for (i = 0; i < KSIZE; i++)
+		kf[i] = MP_ALLMASK;
+
+	for (i = 1; i <= KSIZE; i++)
+	{
+		int j = (i > 8) ? i/3 : 1;
+
+		mpzero(2*i, kp);
+		mpcopy(i, kp, kf);
+		mpsubx(2*i, kp, i, kf);
+
+		mpkmul_w(kr, i, kf, kf, kw);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpkmul_w failed for size %d\n", i);
+			return 1;
+		}
+		mpksqr_w(kr, i, kf, kw);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpksqr_w failed for size %d\n", i);
+			return 1;
+		}
+		mpmul(kr, i, kf, i, kf);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpmul failed for size %d\n", i);
+			return 1;
+		}
+		mpsqr(kr, i, kf);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpsqr failed for size %d\n", i);
+			return 1;
+		}
+
+		/* unbalanced */
+		mpzero(i+j, kp);
+		mpcopy(i, kp, kf);
+		mpsubx(i+j, kp, i, kf);
+
+		mpmul(kr, i, kf, j, kf);
+		if (!mpeq(i+j, kr, kp))
+		{
+			printf("mpmul failed for sizes %d and %d\n", i, j);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * testrandom
+ *  pseudo-random operands whose halves differ, so that the middle term of
+ *  Karatsuba takes either sign and the carries and borrows get fixed up
+ */
+static int testrandom()
+{
+	int i;
+	uint32_t state = 0x2545f491U;
+
+	for (i = 0; i < KSIZE; i++)
+	{
+		#if (MP_WBITS == 64)
+		kx[i] = xorshift(&state) << 32;
+		kx[i] |= xorshift(&state);
+		ky[i] = xorshift(&state) << 32;
+		ky[i] |= xorshift(&state);
+		#else
+		kx[i] = xorshift(&state);
+		ky[i] = xorshift(&state);
+		#endif
+	}
+
+	for (i = 1; i <= KSIZE; i++)
+	{
+		int j = (i > 8) ? i/3 : 1;
+
+		refmul(kp, i, kx, i, ky);
+
+		mpkmul_w(kr, i, kx, ky, kw);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpkmul_w failed for random operands of size %d\n", i);
+			return 1;
+		}
+		mpmul(kr, i, kx, i, ky);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpmul failed for random operands of size %d\n", i);
+			return 1;
+		}
+
+		refmul(kp, i, kx, i, kx);
+
+		mpksqr_w(kr, i, kx, kw);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpksqr_w failed for a random operand of size %d\n", i);
+			return 1;
+		}
+		mpsqr(kr, i, kx);
+		if (!mpeq(2*i, kr, kp))
+		{
+			printf("mpsqr failed for a random operand of size %d\n", i);
+			return 1;
+		}
+
+		/* unbalanced */
+		refmul(kp, i, kx, j, ky);
+
+		mpmul(kr, i, kx, j, ky);
+		if (!mpeq(i+j, kr, kp))
+		{
+			printf("mpmul failed for random operands of sizes %d and %d\n", i, j);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 int main()
 {
 	int i, carry;
@@ -119,5 +289,13 @@ int main()
 		return 1;
 	}
 
+	/* run the large tests with the generic routines, and with the optimized ones if available */
+	cpuFeaturesMask(0);
+	if (testlarge() || testrandom())
+		return 1;
+	cpuFeaturesMask(~0U);
+	if (testlarge() || testrandom())
+		return 1;
+
 	return 0;
 }
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testmpmont.c
+ * \brief Unit test program for the Montgomery modular exponentiation.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/cpu.h"
+
+#define NSIZES	6
+
+static size_t sizes[NSIZES] = { 1, 2, 5, 9, 16, 33 };
+
+int main()
+{
+	int failures = 0;
+
+	randomGeneratorContext rngc;
+
+	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()) == 0)
+	{
+		int i, j;
+
+		for (i = 0; i < NSIZES; i++)
+		{
+			size_t size = sizes[i];
+
+			mpw* modl = (mpw*) malloc(size * sizeof(mpw));
+			mpw* x = (mpw*) malloc(size * sizeof(mpw));
+			mpw* p = (mpw*) malloc(size * sizeof(mpw));
+			mpw* r1 = (mpw*) malloc(size * sizeof(mpw));
+			mpw* r2 = (mpw*) malloc(size * sizeof(mpw));
+			mpw* wksp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+
+			mpbarrett b;
+			mpmont m;
+
+			mpbzero(&b);
+			mpmontzero(&m);
+
+			for (j = 0; j < 10; j++)
+			{
+				/* random odd modulus with the most significant bit set */
+				rngc.rng->next(rngc.param, (byte*) modl, MP_WORDS_TO_BYTES(size));
+				mpsetmsb(size, modl);
+				mpsetlsb(size, modl);
+
+				mpbset(&b, size, modl);
+
+				if (mpmontset(&m, size, modl))
+				{
+					printf("mpmontset failed\n");
+					failures++;
+					break;
+				}
+
+				mpbrnd_w(&b, &rngc, x, wksp);
+				rngc.rng->next(rngc.param, (byte*) p, MP_WORDS_TO_BYTES(size));
+
+				mpbpowmod_w(&b, size, x, size, p, r1, wksp);
+
+				mpmontpowmod_w(&m, size, x, size, p, r2, wksp);
+				if (mpne(size, r1, r2))
+				{
+					printf("mpmontpowmod_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				mpmontbpowmod_w(&b, size, x, size, p, r2, wksp);
+				if (mpne(size, r1, r2))
+				{
+					printf("mpmontbpowmod_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				/* the IFMA code, if the processor has it, and the generic code */
+				if (mpmontifmapowmod(&m, size, x, size, p, r2) == 0 && mpne(size, r1, r2))
+				{
+					printf("mpmontifmapowmod failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				cpuFeaturesMask(0);
+				if (mpmontifmapowmod(&m, size, x, size, p, r2) == 0)
+				{
+					printf("mpmontifmapowmod ignored the processor feature mask\n");
+					failures++;
+				}
+				mpmontpowmod_w(&m, size, x, size, p, r2, wksp);
+				cpuFeaturesMask(~0U);
+				if (mpne(size, r1, r2))
+				{
+					printf("generic mpmontpowmod_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				/* x^p * p^x, both with simultaneous exponentiation and separately */
+				mpbpowmod_w(&b, size, p, size, x, r2, wksp);
+				mpbmulmod_w(&b, size, r1, size, r2, r1, wksp);
+
+				mpbpowmod2_w(&b, size, x, size, p, size, p, size, x, r2, wksp);
+				if (mpne(size, r1, r2))
+				{
+					printf("mpbpowmod2_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				mpmontbpowmod2_w(&b, size, x, size, p, size, p, size, x, r2, wksp);
+				if (mpne(size, r1, r2))
+				{
+					printf("mpmontbpowmod2_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+			}
+
+			/* fixed-base comb, for exponents of the full size and of fewer bits */
+			for (j = 0; j < 2; j++)
+			{
+				size_t bits = j ? MP_WORDS_TO_BITS(size)/2+1 : MP_WORDS_TO_BITS(size);
+
+				mpmontcomb c;
+
+				mpmontcombzero(&c);
+
+				if (mpmontcombset(&c, &b, size, x, bits))
+				{
+					printf("mpmontcombset failed\n");
+					failures++;
+					break;
+				}
+
+				rngc.rng->next(rngc.param, (byte*) p, MP_WORDS_TO_BYTES(size));
+				if (j)
+				{
+					mpzero(size, r1);
+					mpsetlsb(size, r1);
+					mplshift(size, r1, bits);
+					mpsubw(size, r1, 1);
+					mpand(size, p, r1);
+				}
+
+				mpbpowmod_w(&b, size, x, size, p, r1, wksp);
+				if (mpmontcombpowmod_w(&c, size, p, r2, wksp) || mpne(size, r1, r2))
+				{
+					printf("mpmontcombpowmod_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				/* an exponent which is too large must be rejected */
+				if (j)
+				{
+					mpsetmsb(size, p);
+					if (mpmontcombpowmod_w(&c, size, p, r2, wksp) == 0)
+					{
+						printf("mpmontcombpowmod_w accepted a large exponent\n");
+						failures++;
+					}
+				}
+
+				mpmontcombbpowmod_w(&c, &b, size, x, size, p, r2, wksp);
+				mpbpowmod_w(&b, size, x, size, p, r1, wksp);
+				if (mpne(size, r1, r2))
+				{
+					printf("mpmontcombbpowmod_w failed for size %u\n", (unsigned) size);
+					failures++;
+				}
+
+				mpmontcombfree(&c);
+			}
+
+			/* an even modulus must be rejected by mpmontset, but still work through mpmontbpowmod_w */
+			mpclrlsb(size, modl);
+			mpbset(&b, size, modl);
+
+			if (mpmontset(&m, size, modl) == 0)
+			{
+				printf("mpmontset accepted an even modulus\n");
+				failures++;
+			}
+
+			mpbpowmod_w(&b, size, x, size, p, r1, wksp);
+			mpmontbpowmod_w(&b, size, x, size, p, r2, wksp);
+			if (mpne(size, r1, r2))
+			{
+				printf("mpmontbpowmod_w failed for even modulus of size %u\n", (unsigned) size);
+				failures++;
+			}
+
+			mpmontfree(&m);
+			mpbfree(&b);
+
+			free(wksp);
+			free(r2);
+			free(r1);
+			free(p);
+			free(x);
+			free(modl);
+		}
+
+		randomGeneratorContextFree(&rngc);
+	}
+	else
+	{
+		printf("random generator failure\n");
+		return -1;
+	}
+
+	return failures;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testmpprime.c
+ * \brief Unit test program for the Baillie-PSW probable prime test.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpprime.h"
+
+struct vector
+{
+	const char* n;
+	int prime;
+};
+
+#define NVECTORS	12
+
+/* Mersenne and curve primes, and composites that pass strong tests to several bases, or are squares */
+struct vector table[NVECTORS] = {
+	{ "7fffffffffffffffffffffffffffffff", 1 },
+	{ "1ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff", 1 },
+	{ "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f", 1 },
+	{ "7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed", 1 },
+	{ "bfa17dc7", 0 },
+	{ "123a99", 0 },
+	{ "351591274f9af9fb", 0 },
+	{ "437ae92817f9fc85b7e5", 0 },
+	{ "2be6951adc5b22410a5fd", 0 },
+	{ "3ffffffffffffffc000000000000001", 0 },
+	{ "80000000000000000000000000000001", 0 },
+	{ "ffffffffffffffffffffff7fffe0000000000000000000001", 0 }
+};
+
+int main()
+{
+	int i, failures = 0;
+
+	mpbarrett n;
+	mpw* wksp;
+	randomGeneratorContext rngc;
+
+	mpbzero(&n);
+
+	for (i = 0; i < NVECTORS; i++)
+	{
+		mpbsethex(&n, table[i].n);
+
+		wksp = (mpw*) malloc((8*n.size+2) * sizeof(mpw));
+
+		if (mppbpsw_w(&n, wksp) != table[i].prime)
+		{
+			printf("failed test vector %d\n", i+1);
+			failures++;
+		}
+
+		free(wksp);
+	}
+
+	/* generate a prime with the Baillie-PSW test, and confirm it with Miller-Rabin */
+	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()) == 0)
+	{
+		wksp = (mpw*) malloc((8*MP_BITS_TO_WORDS(1024+MP_WBITS-1)+2) * sizeof(mpw));
+
+		if (mpprnd_w(&n, &rngc, 1024, MPP_BPSW, (const mpnumber*) 0, wksp) || mpbits(n.size, n.modl) != 1024 || !mppmilrab_w(&n, &rngc, 40, wksp))
+		{
+			printf("failed to generate a prime\n");
+			failures++;
+		}
+
+		free(wksp);
+
+		randomGeneratorContextFree(&rngc);
+	}
+	else
+	{
+		printf("random generator failure\n");
+		failures++;
+	}
+
+	mpbfree(&n);
+
+	return failures;
+}
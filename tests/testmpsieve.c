@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testmpsieve.c
+ * \brief Unit test program for the sieve used in the prime searches.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpsieve.h"
+
+#define NWINDOWS	2
+
+/*
+ * trialmod
+ *  returns x mod q the plain way, sixteen bits at a time
+ */
+static unsigned int trialmod(size_t size, const mpw* xdata, unsigned int q)
+{
+	register unsigned int r = 0;
+	register size_t i;
+	register int j;
+
+	for (i = 0; i < size; i++)
+		for (j = MP_WBITS - 16; j >= 0; j -= 16)
+			r = ((r << 16) | (unsigned int) ((xdata[i] >> j) & 0xffff)) % q;
+
+	return r;
+}
+
+static int trialdiv(size_t size, const mpw* xdata)
+{
+	register size_t i;
+
+	for (i = 0; i < MPP_SIEVE_PRIMES; i++)
+		if (trialmod(size, xdata, mppsieveprimes[i]) == 0)
+			return 1;
+
+	return 0;
+}
+
+/*
+ * testsieve
+ *  compares the residues of x, and the candidates the sieve rules out in
+ *  NWINDOWS consecutive windows from x, with trial division
+ */
+static int testsieve(size_t size, const mpw* x, int safe)
+{
+	uint16_t res[MPP_SIEVE_PRIMES];
+	byte sieve[MPP_SIEVE_WINDOW];
+	mpw* c = (mpw*) malloc(2 * (size+1) * sizeof(mpw));
+	mpw* d = c + size + 1;
+	size_t i, k, w;
+
+	mppsieveres(size, x, res);
+
+	for (i = 0; i < MPP_SIEVE_PRIMES; i++)
+	{
+		if (res[i] != trialmod(size, x, mppsieveprimes[i]))
+		{
+			printf("wrong residue modulo %u\n", mppsieveprimes[i]);
+			free(c);
+			return 1;
+		}
+	}
+
+	/* one extra word, so that 2c+1 can't overflow */
+	c[0] = 0;
+	mpcopy(size, c+1, x);
+
+	for (w = 0; w < NWINDOWS; w++)
+	{
+		mppsieve(res, sieve, safe);
+
+		for (k = 0; k < MPP_SIEVE_WINDOW; k++)
+		{
+			int expect = trialdiv(size+1, c);
+
+			if (safe && !expect)
+			{
+				mpcopy(size+1, d, c);
+				mpmultwo(size+1, d);
+				mpaddw(size+1, d, 1);
+				expect = trialdiv(size+1, d);
+			}
+
+			if (expect != sieve[k])
+			{
+				printf("sieve disagrees with trial division at candidate %u of window %u\n", (unsigned) k, (unsigned) w);
+				free(c);
+				return 1;
+			}
+
+			mpaddw(size+1, c, 2);
+		}
+
+		mppsievenext(res);
+	}
+
+	free(c);
+	return 0;
+}
+
+/*
+ * testinrange
+ *  checks where mppinrange stops a candidate of the given number of bits
+ *  which starts just below the limit
+ */
+static int testinrange(size_t bits)
+{
+	int failures = 0;
+	size_t size = MP_BITS_TO_WORDS(bits + MP_WBITS - 1);
+	mpbarrett p;
+	mpnumber max;
+
+	mpbzero(&p);
+	mpbinit(&p, size);
+	mpnzero(&max);
+
+	/* p = 2^bits - 3 */
+	mpfill(size, p.modl, MP_ALLMASK);
+	p.modl[0] &= MP_ALLMASK >> (MP_WORDS_TO_BITS(size) - bits);
+	mpsubw(size, p.modl, 2);
+
+	if (!mppinrange(&p, bits, (mpnumber*) 0, mpaddw(size, p.modl, 2)))
+	{
+		printf("2^%u - 1 is out of range\n", (unsigned) bits);
+		failures++;
+	}
+	if (mppinrange(&p, bits, (mpnumber*) 0, mpaddw(size, p.modl, 2)))
+	{
+		printf("2^%u + 1 is in range\n", (unsigned) bits);
+		failures++;
+	}
+
+	/* max = 2^bits - 101, and p = max - 2 */
+	mpsubw(size, p.modl, 102);
+	mpnset(&max, size, p.modl);
+	mpsubw(size, p.modl, 2);
+
+	if (!mppinrange(&p, bits, &max, mpaddw(size, p.modl, 2)))
+	{
+		printf("max is out of range\n");
+		failures++;
+	}
+	if (mppinrange(&p, bits, &max, mpaddw(size, p.modl, 2)))
+	{
+		printf("max + 2 is in range\n");
+		failures++;
+	}
+
+	/* a carry out of the top word */
+	mpfill(size, p.modl, MP_ALLMASK);
+	if (mppinrange(&p, MP_WORDS_TO_BITS(size), (mpnumber*) 0, mpaddw(size, p.modl, 2)))
+	{
+		printf("wrapped candidate is in range\n");
+		failures++;
+	}
+
+	mpnfree(&max);
+	mpbfree(&p);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	randomGeneratorContext rngc;
+	size_t bits, size, i;
+	mpw x[4];
+
+	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()) == 0)
+	{
+		for (bits = 32; bits <= MP_WORDS_TO_BITS(4); bits += 96)
+		{
+			size = MP_BITS_TO_WORDS(bits + MP_WBITS - 1);
+
+			for (i = 0; i < 2; i++)
+			{
+				rngc.rng->next(rngc.param, (byte*) x, MP_WORDS_TO_BYTES(size));
+				x[0] &= MP_ALLMASK >> (MP_WORDS_TO_BITS(size) - bits);
+				x[0] |= MP_MSBMASK >> (MP_WORDS_TO_BITS(size) - bits);
+				x[size-1] |= 1;
+
+				failures += testsieve(size, x, (int) i);
+			}
+		}
+
+		/* the odd candidates either side of 2^64, where the second window
+		 * goes past the top word */
+		size = MP_BITS_TO_WORDS(64 + MP_WBITS - 1);
+		mpfill(size, x, MP_ALLMASK);
+		mpsubw(size, x, 2 * (MPP_SIEVE_WINDOW + 17));
+		failures += testsieve(size, x, 0);
+
+		failures += testinrange(40);
+		failures += testinrange(MP_WBITS);
+		failures += testinrange(MP_WBITS + 23);
+
+		randomGeneratorContextFree(&rngc);
+	}
+	else
+	{
+		printf("random generator failure\n");
+		return 1;
+	}
+
+	return failures;
+}
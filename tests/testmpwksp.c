@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testmpwksp.c
+ * \brief Unit test program for the multi-precision workspace cache.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/mpwksp.h"
+
+#define NDEPTH	5
+
+/* the last request is too large for the cache, and comes from malloc */
+static const size_t sizes[NDEPTH] = { 100, 50, 1, 300, 1 << 20 };
+
+/*
+ * testnesting
+ *  takes nested workspace, checks that no two pieces overlap and that each
+ *  keeps what was written to it, and gives it back in reverse order
+ */
+static int testnesting(int round)
+{
+	int failures = 0;
+	mpw* w[NDEPTH];
+	int i, j;
+
+	for (i = 0; i < NDEPTH; i++)
+	{
+		w[i] = mpwkspget(sizes[i]);
+
+		if (w[i] == (mpw*) 0)
+		{
+			printf("workspace request of %u words failed in round %d\n", (unsigned) sizes[i], round);
+			while (i-- > 0)
+				mpwkspput(w[i]);
+			return 1;
+		}
+
+		mpfill(sizes[i], w[i], (mpw) (i+1));
+	}
+
+	for (i = 0; i < NDEPTH; i++)
+	{
+		for (j = i+1; j < NDEPTH; j++)
+		{
+			if ((w[j] >= w[i] && w[j] < w[i] + sizes[i]) || (w[i] >= w[j] && w[i] < w[j] + sizes[j]))
+			{
+				printf("nested workspace overlaps in round %d\n", round);
+				failures++;
+			}
+		}
+
+		if (w[i][0] != (mpw) (i+1) || w[i][sizes[i]-1] != (mpw) (i+1))
+		{
+			printf("nested workspace overwritten in round %d\n", round);
+			failures++;
+		}
+	}
+
+	for (i = NDEPTH; i-- > 0; )
+		mpwkspput(w[i]);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	int round;
+
+	/* the first round may grow a cache, which the later ones then reuse */
+	for (round = 0; round < 3; round++)
+		failures += testnesting(round);
+
+	return failures;
+}
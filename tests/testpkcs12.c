@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testpkcs12.c
+ * \brief Unit test program for the PKCS#12 key derivation.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/pkcs12.h"
+#include "beecrypt/cpu.h"
+
+extern int fromhex(byte*, const char*);
+
+struct vector
+{
+	const char*	hash;
+	const char*	password;
+	size_t		ssize;
+	size_t		iterations;
+	/* the keys for the cipher, IV and MAC diversifiers */
+	const char*	expect[3];
+};
+
+#define NVECTORS 3
+
+/* these were computed by the original implementation of pkcs12_derive_key,
+ * which key stores depend on */
+struct vector table[NVECTORS] = {
+	{ "SHA-1", "a rather long password of more than sixty four bytes in length, for sure", 8, 5,
+	  { "542c1a0544c49a0a9402226e273ffb562351cfb5542c1a05",
+	    "f9760678f87366997f078b93e7cd5091b2d036f6f9760678",
+	    "5623135854a6db656ff3fa78b66fd58d7af1ef9356231358" } },
+	{ "SHA-256", "password", 8, 2000,
+	  { "6e86a3dad59a72f68e1db5e18691edaa8b2fc029e3e364cb",
+	    "6d7b44ddd3d189715a341670c8b0c83fa91f2d4cbe305322",
+	    "476fa46e214cbb0d730015ce457662918984867f383b4788" } },
+	{ "MD5", "a rather long password of more than sixty four bytes in length, for sure", 8, 2000,
+	  { "7193af098339b534d05faf7d616e01fd7193af09",
+	    (const char*) 0,
+	    (const char*) 0 } }
+};
+
+/* no acceleration, AVX2 only, no SHA extensions, everything */
+static const unsigned int masks[] = { 0, CPUF_X86_AVX2, ~CPUF_X86_SHA, ~0U };
+
+int main()
+{
+	static const byte ids[3] = { PKCS12_ID_CIPHER, PKCS12_ID_IV, PKCS12_ID_MAC };
+
+	int i, j, k, failures = 0;
+	byte keys[3][40], single[40], expect[40];
+	byte* ndata[3];
+	size_t nsize[3];
+
+	for (i = 0; i < NVECTORS; i++)
+	{
+		const hashFunction* hash = hashFunctionFind(table[i].hash);
+		const byte* pswd = (const byte*) table[i].password;
+		size_t psize = strlen(table[i].password);
+
+		if (hash == (const hashFunction*) 0)
+		{
+			printf("%s not found\n", table[i].hash);
+			failures++;
+			continue;
+		}
+
+		for (j = 0; j < sizeof(masks) / sizeof(masks[0]); j++)
+		{
+			cpuFeaturesMask(masks[j]);
+
+			for (k = 0; k < 3; k++)
+			{
+				ndata[k] = keys[k];
+				nsize[k] = sizeof(keys[k]) - 8 * k;
+			}
+
+			if (pkcs12_derive_keys(hash, ids, 3, pswd, psize, (const byte*) "saltsalt", table[i].ssize, table[i].iterations, ndata, nsize))
+				return -1;
+
+			for (k = 0; k < 3; k++)
+			{
+				if (pkcs12_derive_key(hash, ids[k], pswd, psize, (const byte*) "saltsalt", table[i].ssize, table[i].iterations, single, nsize[k]))
+					return -1;
+
+				if (memcmp(keys[k], single, nsize[k]))
+				{
+					printf("vector %d key %d differs from a single derivation with features %x\n", i+1, k+1, masks[j]);
+					failures++;
+				}
+
+				if (table[i].expect[k] && memcmp(keys[k], expect, fromhex(expect, table[i].expect[k])))
+				{
+					printf("failed test vector %d key %d with features %x\n", i+1, k+1, masks[j]);
+					failures++;
+				}
+			}
+		}
+	}
+
+	cpuFeaturesMask(~0U);
+
+	return failures;
+}
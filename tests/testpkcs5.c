@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testpkcs5.c
+ * \brief Unit test program for PBKDF2.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/pkcs5.h"
+#include "beecrypt/cpu.h"
+#include "beecrypt/sha1.h"
+
+extern int fromhex(byte*, const char*);
+
+struct vector
+{
+	const char*	hash;
+	const char*	password;
+	size_t		psize;
+	const char*	salt;
+	size_t		ssize;
+	size_t		iterations;
+	size_t		nsize;
+	const char*	expect;
+};
+
+#define NVECTORS 14
+
+/* the SHA-1 vectors come from RFC 6070; the others were checked against
+ * Python's hashlib; the empty passwords are allowed by RFC 2898; the last
+ * four have enough output blocks to fill the SIMD lanes */
+struct vector table[NVECTORS] = {
+	{ "SHA-1", "password", 8, "salt", 4, 1, 20, "0c60c80f961f0e71f3a9b524af6012062fe037a6" },
+	{ "SHA-1", "password", 8, "salt", 4, 2, 20, "ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957" },
+	{ "SHA-1", "password", 8, "salt", 4, 4096, 20, "4b007901b765489abead49d926f721d065a429c1" },
+	{ "SHA-1", "passwordPASSWORDpassword", 24, "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36, 4096, 25, "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038" },
+	{ "SHA-1", "pass\0word", 9, "sa\0lt", 5, 4096, 16, "56fa6aa75548099dcc37d7f03425e0c3" },
+	{ "SHA-1", "", 0, "salt", 4, 2, 20, "133a4ce837b4d2521ee2bf03e11c71ca794e0797" },
+	{ "SHA-256", "", 0, "salt", 4, 1000, 32, "94fb56af3ea22e5d3ed1b054085b136ca301b75d8b406c802c489479f27387c6" },
+	{ "SHA-256", "password", 8, "salt", 4, 4096, 32, "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a" },
+	{ "SHA-256", "passwordPASSWORDpassword", 24, "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36, 4096, 40, "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9" },
+	{ "SHA-512", "password", 8, "salt", 4, 1000, 64, "afe6c5530785b6cc6b1c6453384731bd5ee432ee549fd42fb6695779ad8a1c5bf59de69c48f774efc4007d5298f9033c0241d5ab69305e7b64eceeb8d834cfec" },
+	{ "MD5", "password", 8, "salt", 4, 1000, 300,
+		"8d189946a32d883622a16ae18af0632f5791d5e7b1abb0ab1757d28ce34056140335105994495f9142070f064027d6df"
+		"9db8e3d6fbd0042acbfb7637ee1e10b3cacb4d24dbded1eb26d33d5b6426ab6b8f64c8dcf40477f12fa398b1dfe6b4bc"
+		"372827466fc58593e2aa204b1ee7acb451f6ebb1712f03f695bc30a89e927d85fd5f4d3bfd02f566e20df2bced260b0d"
+		"b1732e99e92c54ff82b0b7c43c4c2fa82681f2b31d635854f561afeba3bfb8b099ece6f32eeb99866d07a5f8e96ee602"
+		"bc2daf4b956bcd120c70f10b233f7ab79f45d4a2466b88e44fb64a2d2397fa4e15e7466c82395de03fff063829095911"
+		"ce4e22b1af7279b40814adb548f70bea5f96d837925dacf4a13efb23e04189770d6003c89183d83fad5f017cf78fdf06"
+		"cc87ce4c60420650d440bea9" },
+	{ "SHA-1", "password", 8, "salt", 4, 1000, 400,
+		"6e88be8bad7eae9d9e10aa061224034fed48d03fcbad968b56006784539d5214ce970d912ec2049b04231d47c2eb8850"
+		"6945b26b2325e6adfeeba08895ff9587a30b79968d7c300921db460902c9e1838b09462351a549a1f1d84e47a4e521b8"
+		"39224cf347c3a09ea223e344955cd659813e6a80ef11fda1ca2b5749311501bac5d99474b3725ff440dc71deac3ff80a"
+		"20748911a1d55a5de4283a7820da3a21015fd5721b3adada046620c9e88b45b96a95dc319ab0304245779cc7fd69794d"
+		"c8312ad9073682a727f11d7a2791cdb15bf89ab701da1389be1e76e8004d1cd0f693ad1e968dd49c121451c139429ae7"
+		"a287ea791ea592cb9cf725ce2a3fbb7763f1913488f9ab99930e6832c3c615fc4d63608355059aecec4490197db6bd09"
+		"063bcaa5aeca472bd1070db2b14b7d231e163c0c1d0595f98923f1daf96ec451d287c351710c11c50c326c37a34df802"
+		"00303657315f732caa1d1a688ccb52dde76b6beb653bf4cdfb3d37c6c38cc34a214f7ff2c12a45ed2e5f2057a91927ff"
+		"72e6bf0786c01176e92909def40c304b" },
+	{ "SHA-224", "password", 8, "salt", 4, 1000, 300,
+		"d3bcf320fd918908eafcaa460faf40e201f6508d4e6f3d9c1c0abd30dae08cc8b1bc0657e2ebc229d22e48df55df72e8"
+		"3f2e50db2324a73b01ddbb88831662f0080da7025964a778aee580fd2b77824070dbd32f40158e709ad32ac7e2dd28df"
+		"c9d95cf326f3c959ce2d1a9c8b1d14a68ea5a5e8fd2659d955aba30c4316ae60bcfe8813a8002ce27ef25dd41f594883"
+		"746b796f3db11a71969cc299c5aae76e9ce7a8ed2ebeca38bf0068944abe590f0a2208dff8ced0aff27cc7a92b9c5e56"
+		"0e790718eeec8e6ef9b7da63a24219e4e66be58903c7dd1b36e6c98102290d459fb1c58f0075fb67ecbddd8f8afd1176"
+		"786e4c4c3e92324bb98ff447785b24ff9713d232be17bdf057a2e6c1034a40f38dbe61e5585dfb396818357920358263"
+		"07849d2d71208b80ffed4f73" },
+	{ "SHA-256", "a very long password that does not fit into a single block of the hash function at all", 86, "NaCl", 4, 1000, 600,
+		"d50082afaa7327604429521cb793ab3210d8804c1de24c4789e8ef57c57497f9ce06a84654d95fb4f93d778cff7d7b71"
+		"c7f8005497db2b23e3a7e3fcb1b81cc1ca0cb03f140bb6ad7fac52878bbbc1be79aa92526b4d30aeb458de30eb7ea101"
+		"eb43866a456b0e3b78688e7b445eee7400a6f896333bbd23a5c9de8bea303bb0ad2300e41e4a6dda4ad462c7668929cf"
+		"07dcff46b01a540785b32b9d2b67d57980c7fb5a34f4d449652e6438866ce34e2e28ae2a1767ad5784a157dd7337c70b"
+		"b45b7e8e98ee57fda91ebec730a200acb90b7d27e5dad900b7821795c5b4098a203df012b7efcb1a0343a6360938175d"
+		"25547d2f16067cfd7b8cc76dc402294bcd777375248850ae5fb9ce8cb385f16fcd641da8da0d608e7adc68f631fec63e"
+		"cb131ee24fa1b9c55e6c9f294e05f1ff6b636da4831be90aa50c49c218f0e27b6d602013dacf9a1ba62c0058e7ffe4f7"
+		"32eaa162f8f719b9dd1504a6f8f504e18fe135245fbaf4de103fe3408d3af4bbcab4d9fcfa7662b6d3552e2e6055b24a"
+		"9c393b67e1390576235fc63cc8caaa9ec79650636586e84945079c10e6a22cf9b408e6753c49a485a69ee3d837618d20"
+		"18cf09c59d26cf3e48829e2d0597db403d1e7e7375f3f22ba8c774aab8cea1978b21b1379e1109e2f35a5e44a4361712"
+		"c1f50db012b83b4aacbe7ee509baf7a875f4470af63467bc05c7235ecea81b9509aa50a524f9b6c56d061042882b23ed"
+		"ac400f07c29bb30b6c407969196121c658188da7e979a9b7802787ce05540cf63fe77632a04b68af80e9916bd85db425"
+		"827730e10ed42b180ce6a2025731df607199c01318c5933d" }
+};
+
+/* no acceleration, AVX2 only, everything */
+static const unsigned int masks[] = { 0, CPUF_X86_AVX2, ~0U };
+
+int main()
+{
+	int i, j, failures = 0;
+	byte key[600], expect[600];
+	size_t size;
+
+	for (i = 0; i < NVECTORS; i++)
+	{
+		const hashFunction* hash = hashFunctionFind(table[i].hash);
+
+		if (hash == (const hashFunction*) 0)
+		{
+			printf("%s not found\n", table[i].hash);
+			failures++;
+			continue;
+		}
+
+		size = fromhex(expect, table[i].expect);
+
+		for (j = 0; j < sizeof(masks) / sizeof(masks[0]); j++)
+		{
+			cpuFeaturesMask(masks[j]);
+
+			if (pkcs5_pbkdf2(hash, (const byte*) table[i].password, table[i].psize, (const byte*) table[i].salt, table[i].ssize, table[i].iterations, key, table[i].nsize))
+				return -1;
+
+			if (size != table[i].nsize || memcmp(key, expect, size))
+			{
+				printf("failed test vector %d with features %x\n", i+1, masks[j]);
+				failures++;
+			}
+		}
+	}
+
+	cpuFeaturesMask(~0U);
+
+	/* an output whose buffers would wrap size_t must be refused up front */
+	if (pkcs5_pbkdf2(&sha1, (const byte*) "password", 8, (const byte*) "salt", 4, 1, key, ~((size_t) 0)) != -1)
+	{
+		printf("oversized output not refused\n");
+		failures++;
+	}
+
+	return failures;
+}
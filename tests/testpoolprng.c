@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testpoolprng.c
+ * \brief Unit test program for the pools of random bytes.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+#include <sys/wait.h>
+
+#include "beecrypt/poolprng.h"
+#include "beecrypt/fips186.h"
+
+#define NTHREADS	4
+#define NREQUESTS	2000
+#define NBYTES		13
+
+struct job
+{
+	randomPool*	pool;
+	byte		data[NREQUESTS * NBYTES];
+	int			rc;
+};
+
+/* small requests, which cross the buffer boundaries at varying offsets */
+static void* draw(void* arg)
+{
+	struct job* j = (struct job*) arg;
+	int i;
+
+	j->rc = 0;
+	for (i = 0; i < NREQUESTS; i++)
+		if (randomPoolNext(j->pool, j->data + i * NBYTES, NBYTES))
+			j->rc = -1;
+
+	return arg;
+}
+
+static int testthreads(randomPool* pool)
+{
+	int failures = 0;
+	struct job jobs[NTHREADS];
+	pthread_t threads[NTHREADS];
+	int i, k;
+
+	for (i = 0; i < NTHREADS; i++)
+	{
+		jobs[i].pool = pool;
+		if (pthread_create(threads+i, (pthread_attr_t*) 0, draw, jobs+i))
+			return -1;
+	}
+	for (i = 0; i < NTHREADS; i++)
+		pthread_join(threads[i], (void**) 0);
+
+	for (i = 0; i < NTHREADS; i++)
+	{
+		if (jobs[i].rc)
+		{
+			printf("thread %d failed\n", i);
+			failures++;
+		}
+		for (k = 0; k < i; k++)
+		{
+			if (memcmp(jobs[i].data, jobs[k].data, 64) == 0)
+			{
+				printf("threads %d and %d produced the same output\n", k, i);
+				failures++;
+			}
+		}
+	}
+
+	return failures;
+}
+
+/*
+ * testfork
+ *  a child must not hand out the bytes its parent still has buffered, nor
+ *  repeat the parent's output for requests which bypass the buffers
+ */
+static int testfork(randomPool* pool, size_t size)
+{
+	byte mine[256], theirs[256];
+	int fd[2], status;
+	pid_t pid;
+
+	if (size > sizeof(mine))
+		return -1;
+
+	/* make sure there's a buffer to inherit */
+	randomPoolNext(pool, mine, 1);
+
+	if (pipe(fd))
+		return -1;
+
+	if ((pid = fork()) < 0)
+		return -1;
+
+	if (pid == 0)
+	{
+		close(fd[0]);
+		if (randomPoolNext(pool, theirs, size))
+			_exit(1);
+		_exit(write(fd[1], theirs, size) != (ssize_t) size);
+	}
+
+	close(fd[1]);
+	if (randomPoolNext(pool, mine, size))
+		return 1;
+	if (read(fd[0], theirs, size) != (ssize_t) size)
+		return 1;
+	close(fd[0]);
+
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status))
+	{
+		printf("child failed\n");
+		return 1;
+	}
+
+	if (memcmp(mine, theirs, size) == 0)
+	{
+		printf("child repeated the parent's output for %u bytes\n", (unsigned) size);
+		return 1;
+	}
+	return 0;
+}
+
+int main()
+{
+	int failures = 0;
+	randomGeneratorContext rngc;
+	randomPool* pool;
+	byte data[300];
+
+	/* small buffers and a short reseed interval, to exercise both */
+	if ((pool = randomPoolAlloc(&fips186prng, 64, 1000)) == (randomPool*) 0)
+		return -1;
+
+	failures += testthreads(pool);
+
+	if (randomPoolNext(pool, data, sizeof(data)))
+	{
+		printf("large request failed\n");
+		failures++;
+	}
+	if (randomPoolSeed(pool, data, 20))
+	{
+		printf("seeding failed\n");
+		failures++;
+	}
+
+	failures += testthreads(pool);
+	failures += testfork(pool, 32);
+	/* more than the buffer size of 64 bytes */
+	failures += testfork(pool, 256);
+
+	randomPoolFree(pool);
+
+	/* the process-wide pool */
+	if (randomGeneratorContextInit(&rngc, randomGeneratorFind("Pooled")))
+		return -1;
+	if (randomGeneratorContextNext(&rngc, data, 16) || randomGeneratorContextNext(&rngc, data, sizeof(data)))
+	{
+		printf("pooled generator failed\n");
+		failures++;
+	}
+	randomGeneratorContextFree(&rngc);
+
+	return failures;
+}
@@ -24,6 +24,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "beecrypt/beecrypt.h"
 #include "beecrypt/rsa.h"
@@ -37,6 +38,24 @@ static const char* rsa_dp = "7e80668e4b5d098bba51100edf91b66e8f5639089ac0e210a23
 static const char* rsa_dq = "676abe5aa972e1392f40453415bae67198c04cff3f31b840eac70925df69de71033989d517d2b01330269626f396177415579ada6079cde61e8787856fb25215";
 static const char* rsa_qi = "352b5d9d650e5e8ba1bf075e1b6ea6413cdcd419d16ae446a97f28a6b9f7aa38230b5834ee6daaf9adedee85ddc95fce36f16d4fd01eee9fdfefdcae7b152d8";
 
+static int executed = 0;
+
+/* runs the tasks in reverse order */
+static int reverse(void* param, rsacrttask task, void* args[], size_t count)
+{
+	while (count--)
+	{
+		task(args[count]);
+		executed++;
+	}
+	return 0;
+}
+
+static int refuse(void* param, rsacrttask task, void* args[], size_t count)
+{
+	return -1;
+}
+
 static const char* rsa_m  = "0001ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff003021300906052b0e03021a05000414da39a3ee5e6b4b0d3255bfef95601890afd80709";
 
 int main()
@@ -45,7 +64,10 @@ int main()
 
 	rsakp keypair;
 	mpnumber m, sig, sigcrt;
+	rsacrtpolicy policy, saved;
+	rsacrtmode mode;
 	randomGeneratorContext rngc;
+	mpw* wksp;
 
 	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()) == 0)
 	{
@@ -86,6 +108,80 @@ int main()
 			failures++;
 		}
 
+		/* the same, in workspace of our own */
+		wksp = (mpw*) malloc(RSAPRICRT_WKSP(keypair.p.size, keypair.q.size) * sizeof(mpw));
+
+		if (rsapricrt_w(&keypair.n, &keypair.p, &keypair.q, &keypair.dp, &keypair.dq, &keypair.qi, &m, &sigcrt, wksp) || mpnex(sig.size, sig.data, sigcrt.size, sigcrt.data))
+		{
+			printf("rsapricrt_w failed\n");
+			failures++;
+		}
+
+		free(wksp);
+
+		wksp = (mpw*) malloc(RSAVRFY_WKSP(keypair.n.size) * sizeof(mpw));
+
+		if (rsavrfy_w(&keypair.n, &keypair.e, &sig, &m, wksp) != 1)
+		{
+			printf("rsavrfy_w failed\n");
+			failures++;
+		}
+
+		free(wksp);
+
+		/* the same, under each execution policy */
+		rsacrtGetPolicy(&saved);
+
+		for (mode = RSACRT_AUTO; mode <= RSACRT_EXECUTOR; mode++)
+		{
+			policy.mode = mode;
+			policy.minbits = 1;
+			policy.threads = 2;
+			policy.executor = (mode == RSACRT_EXECUTOR) ? reverse : (rsacrtexecutor) 0;
+			policy.param = (void*) 0;
+
+			if (rsacrtSetPolicy(&policy))
+			{
+				printf("rsacrtSetPolicy failed for mode %d\n", (int) mode);
+				failures++;
+				continue;
+			}
+
+			mpnsetw(&sigcrt, 0);
+
+			if (rsapricrt(&keypair.n, &keypair.p, &keypair.q, &keypair.dp, &keypair.dq, &keypair.qi, &m, &sigcrt) || mpnex(sig.size, sig.data, sigcrt.size, sigcrt.data))
+			{
+				printf("rsapricrt failed for mode %d\n", (int) mode);
+				failures++;
+			}
+		}
+
+		if (executed != 2)
+		{
+			printf("executor ran %d tasks instead of 2\n", executed);
+			failures++;
+		}
+
+		/* an executor which refuses the tasks leaves them to rsapricrt */
+		policy.executor = refuse;
+
+		if (rsacrtSetPolicy(&policy) || rsapricrt(&keypair.n, &keypair.p, &keypair.q, &keypair.dp, &keypair.dq, &keypair.qi, &m, &sigcrt) || mpnex(sig.size, sig.data, sigcrt.size, sigcrt.data))
+		{
+			printf("rsapricrt failed with a refusing executor\n");
+			failures++;
+		}
+
+		/* an executor policy needs an executor */
+		policy.executor = (rsacrtexecutor) 0;
+
+		if (rsacrtSetPolicy(&policy) == 0)
+		{
+			printf("rsacrtSetPolicy accepted an executor policy without executor\n");
+			failures++;
+		}
+
+		rsacrtSetPolicy(&saved);
+
 		mpnfree(&sigcrt);
 		mpnfree(&sig);
 		mpnfree(&m);
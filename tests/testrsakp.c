@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testrsakp.c
+ * \brief Unit test program for RSA keypair generation.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/rsa.h"
+
+/*
+ * testkeypair
+ *  generates a keypair, and checks its size and that it decrypts what its
+ *  public key encrypts, with and without the chinese remainder theorem
+ */
+static int testkeypair(randomGeneratorContext* rngc, size_t bits, int threads)
+{
+	int failures = 0;
+	rsakp kp;
+	mpnumber m, c, r;
+
+	rsakpInit(&kp);
+	mpnzero(&m);
+	mpnzero(&c);
+	mpnzero(&r);
+
+	if (rsakpMakeThreads(&kp, rngc, bits, threads))
+	{
+		printf("failed to generate %d-bit keypair with %d threads\n", (int) bits, threads);
+		return 1;
+	}
+
+	if (mpbits(kp.n.size, kp.n.modl) != bits)
+	{
+		printf("failed modulus size of %d-bit keypair with %d threads\n", (int) bits, threads);
+		failures++;
+	}
+
+	if (mpeqx(kp.p.size, kp.p.modl, kp.q.size, kp.q.modl))
+	{
+		printf("failed distinct primes of %d-bit keypair with %d threads\n", (int) bits, threads);
+		failures++;
+	}
+
+	mpnsize(&m, kp.n.size);
+	rngc->rng->next(rngc->param, (byte*) m.data, MP_WORDS_TO_BYTES(m.size));
+	m.data[0] &= (MP_ALLMASK >> 1);
+
+	rsapub(&kp.n, &kp.e, &m, &c);
+
+	rsapricrt(&kp.n, &kp.p, &kp.q, &kp.dp, &kp.dq, &kp.qi, &c, &r);
+	if (mpnex(m.size, m.data, r.size, r.data))
+	{
+		printf("failed crt decryption with %d-bit keypair with %d threads\n", (int) bits, threads);
+		failures++;
+	}
+
+	rsapri(&kp.n, &kp.d, &c, &r);
+	if (mpnex(m.size, m.data, r.size, r.data))
+	{
+		printf("failed decryption with %d-bit keypair with %d threads\n", (int) bits, threads);
+		failures++;
+	}
+
+	mpnfree(&m);
+	mpnfree(&c);
+	mpnfree(&r);
+	rsakpFree(&kp);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	randomGeneratorContext rngc;
+
+	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()))
+		return -1;
+
+	failures += testkeypair(&rngc, 1024, 1);
+	failures += testkeypair(&rngc, 1024, 4);
+	failures += testkeypair(&rngc, 2048, 3);
+	failures += testkeypair(&rngc, 2048, 0);
+
+	if (randomGeneratorContextFree(&rngc))
+		failures++;
+
+	return failures;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testsfmt.c
+ * \brief Unit test program for the SFMT generator.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/sfmt.h"
+
+/* the first outputs of the reference implementation after init_by_array */
+static const uint32_t seedkey[4] = { 0x1234, 0x5678, 0x9abc, 0xdef0 };
+static const uint32_t expect[5] = { 2920711183U, 3885745737U, 3501893680U, 856470934U, 1421864068U };
+
+/*
+ * the contexts hold parameters of the size the library was built with
+ */
+static int init(randomGeneratorContext* rngc)
+{
+	if (randomGeneratorContextInit(rngc, &sfmtprng))
+		return -1;
+
+	return sfmtSeed((sfmtParam*) rngc->param, (const byte*) seedkey, sizeof(seedkey));
+}
+
+/*
+ * testjump
+ *  compares a jump, taken in the middle of a block, with generating the
+ *  skipped output
+ */
+static int testjump(uint64_t steps)
+{
+	int failures = 0;
+	randomGeneratorContext a, b;
+	uint32_t x[250], y[250];
+	uint64_t i;
+
+	if (init(&a) || init(&b))
+		return -1;
+
+	sfmtNext((sfmtParam*) a.param, (byte*) x, 40);
+	sfmtNext((sfmtParam*) b.param, (byte*) y, 40);
+
+	if (sfmtJump((sfmtParam*) a.param, steps))
+		failures++;
+	for (i = 0; i < steps; i++)
+		sfmtNext((sfmtParam*) b.param, (byte*) y, 16);
+
+	sfmtNext((sfmtParam*) a.param, (byte*) x, sizeof(x));
+	sfmtNext((sfmtParam*) b.param, (byte*) y, sizeof(y));
+	if (memcmp(x, y, sizeof(x)))
+	{
+		printf("failed jump of %lu steps\n", (unsigned long) steps);
+		failures++;
+	}
+
+	randomGeneratorContextFree(&a);
+	randomGeneratorContextFree(&b);
+
+	return failures;
+}
+
+/*
+ * testdistance
+ *  checks that two jumps add up, for distances too large to generate
+ */
+static int testdistance()
+{
+	int failures = 0;
+	randomGeneratorContext a, b;
+	uint32_t x[16], y[16];
+
+	if (init(&a) || init(&b))
+		return -1;
+
+	if (sfmtJump((sfmtParam*) a.param, 1ULL << 62) || sfmtJump((sfmtParam*) a.param, (1ULL << 62) + 12345))
+		failures++;
+	if (sfmtJump((sfmtParam*) b.param, (1ULL << 63) + 12345))
+		failures++;
+
+	sfmtNext((sfmtParam*) a.param, (byte*) x, sizeof(x));
+	sfmtNext((sfmtParam*) b.param, (byte*) y, sizeof(y));
+	if (memcmp(x, y, sizeof(x)))
+	{
+		printf("failed sum of jumps\n");
+		failures++;
+	}
+
+	randomGeneratorContextFree(&a);
+	randomGeneratorContextFree(&b);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	randomGeneratorContext rngc;
+	uint32_t out[5];
+
+	if (init(&rngc))
+		return -1;
+
+	sfmtNext((sfmtParam*) rngc.param, (byte*) out, sizeof(out));
+	if (memcmp(out, expect, sizeof(out)))
+	{
+		printf("failed seeded output\n");
+		failures++;
+	}
+
+	if (randomGeneratorContextFree(&rngc))
+		failures++;
+
+	failures += testjump(1);
+	failures += testjump(SFMT_N);
+	failures += testjump(100000);
+	failures += testdistance();
+
+	/* the generator must also work through a context, seeded from entropy */
+	if (randomGeneratorContextInit(&rngc, randomGeneratorFind("SFMT")))
+		return -1;
+	if (randomGeneratorContextNext(&rngc, (byte*) out, sizeof(out)))
+		failures++;
+	if (randomGeneratorContextFree(&rngc))
+		failures++;
+
+	return failures;
+}
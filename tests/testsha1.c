@@ -27,6 +27,7 @@
 #include <stdio.h>
 
 #include "beecrypt/sha1.h"
+#include "beecrypt/cpu.h"
 #include "beecrypt/memchunk.h"
 
 struct vector
@@ -43,7 +44,7 @@ struct vector table[2] = {
 		  (byte*) "\x84\x98\x3E\x44\x1C\x3B\xD2\x6E\xBA\xAE\x4A\xA1\xF9\x51\x29\xE5\xE5\x46\x70\xF1" }
 };
 
-int main()
+static int testvectors()
 {
 	int i, failures = 0;
 	byte digest[20];
@@ -66,3 +67,53 @@ int main()
 	}
 	return failures;
 }
+
+#define NBYTES	1000
+
+/* the digest of one million times 'a', from FIPS 180-2 */
+static const byte million[20] = "\x34\xaa\x97\x3c\xd4\xc4\xda\xa4\xf6\x1e\xeb\x2b\xdb\xad\x27\x31\x65\x34\x01\x6f";
+
+/*
+ * testmillion
+ *  hashes one million times 'a', fed in pieces whose sizes grow from a
+ *  single byte to many blocks, so that they start and end all over a block
+ */
+static int testmillion()
+{
+	byte data[NBYTES];
+	byte digest[20];
+	sha1Param param;
+	size_t off, chunk;
+
+	memset(data, 'a', NBYTES);
+
+	if (sha1Reset(&param))
+		return -1;
+	for (off = 0, chunk = 1; off < 1000000; off += chunk, chunk = (chunk > NBYTES / 3) ? 1 : chunk * 3 + 1)
+		if (sha1Update(&param, data, (off + chunk > 1000000) ? 1000000 - off : chunk))
+			return -1;
+	if (sha1Digest(&param, digest))
+		return -1;
+
+	if (memcmp(digest, million, 20))
+	{
+		printf("failed test vector million\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int main()
+{
+	int failures = 0;
+
+	cpuFeaturesMask(0);
+	failures += testvectors();
+	failures += testmillion();
+	cpuFeaturesMask(~0U);
+	failures += testvectors();
+	failures += testmillion();
+
+	return failures;
+}
@@ -24,6 +24,7 @@
 #include <stdio.h>
 
 #include "beecrypt/sha224.h"
+#include "beecrypt/cpu.h"
 
 struct vector
 {
@@ -40,7 +41,7 @@ struct vector table[2] = {
 	      (byte*) "\x75\x38\x8b\x16\x51\x27\x76\xcc\x5d\xba\x5d\xa1\xfd\x89\x01\x50\xb0\xc6\x45\x5c\xb4\xf5\x8b\x19\x52\x52\x25\x25" }
 };
 
-int main()
+static int testvectors()
 {
 	int i, failures = 0;
 	sha224Param param;
@@ -63,3 +64,53 @@ int main()
 	}
 	return failures;
 }
+
+#define NBYTES	1000
+
+/* the digest of one million times 'a', from FIPS 180-2 */
+static const byte million[28] = "\x20\x79\x46\x55\x98\x0c\x91\xd8\xbb\xb4\xc1\xea\x97\x61\x8a\x4b\xf0\x3f\x42\x58\x19\x48\xb2\xee\x4e\xe7\xad\x67";
+
+/*
+ * testmillion
+ *  hashes one million times 'a', fed in pieces whose sizes grow from a
+ *  single byte to many blocks, so that they start and end all over a block
+ */
+static int testmillion()
+{
+	byte data[NBYTES];
+	byte digest[28];
+	sha224Param param;
+	size_t off, chunk;
+
+	memset(data, 'a', NBYTES);
+
+	if (sha224Reset(&param))
+		return -1;
+	for (off = 0, chunk = 1; off < 1000000; off += chunk, chunk = (chunk > NBYTES / 3) ? 1 : chunk * 3 + 1)
+		if (sha224Update(&param, data, (off + chunk > 1000000) ? 1000000 - off : chunk))
+			return -1;
+	if (sha224Digest(&param, digest))
+		return -1;
+
+	if (memcmp(digest, million, 28))
+	{
+		printf("failed test vector million\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int main()
+{
+	int failures = 0;
+
+	cpuFeaturesMask(0);
+	failures += testvectors();
+	failures += testmillion();
+	cpuFeaturesMask(~0U);
+	failures += testvectors();
+	failures += testmillion();
+
+	return failures;
+}
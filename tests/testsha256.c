@@ -24,6 +24,7 @@
 #include <stdio.h>
 
 #include "beecrypt/sha256.h"
+#include "beecrypt/cpu.h"
 
 struct vector
 {
@@ -40,7 +41,7 @@ struct vector table[2] = {
 	      (byte*) "\x24\x8d\x6a\x61\xd2\x06\x38\xb8\xe5\xc0\x26\x93\x0c\x3e\x60\x39\xa3\x3c\xe4\x59\x64\xff\x21\x67\xf6\xec\xed\xd4\x19\xdb\x06\xc1" }
 };
 
-int main()
+static int testvectors()
 {
 	int i, failures = 0;
 	sha256Param param;
@@ -63,3 +64,53 @@ int main()
 	}
 	return failures;
 }
+
+#define NBYTES	1000
+
+/* the digest of one million times 'a', from FIPS 180-2 */
+static const byte million[32] = "\xcd\xc7\x6e\x5c\x99\x14\xfb\x92\x81\xa1\xc7\xe2\x84\xd7\x3e\x67\xf1\x80\x9a\x48\xa4\x97\x20\x0e\x04\x6d\x39\xcc\xc7\x11\x2c\xd0";
+
+/*
+ * testmillion
+ *  hashes one million times 'a', fed in pieces whose sizes grow from a
+ *  single byte to many blocks, so that they start and end all over a block
+ */
+static int testmillion()
+{
+	byte data[NBYTES];
+	byte digest[32];
+	sha256Param param;
+	size_t off, chunk;
+
+	memset(data, 'a', NBYTES);
+
+	if (sha256Reset(&param))
+		return -1;
+	for (off = 0, chunk = 1; off < 1000000; off += chunk, chunk = (chunk > NBYTES / 3) ? 1 : chunk * 3 + 1)
+		if (sha256Update(&param, data, (off + chunk > 1000000) ? 1000000 - off : chunk))
+			return -1;
+	if (sha256Digest(&param, digest))
+		return -1;
+
+	if (memcmp(digest, million, 32))
+	{
+		printf("failed test vector million\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int main()
+{
+	int failures = 0;
+
+	cpuFeaturesMask(0);
+	failures += testvectors();
+	failures += testmillion();
+	cpuFeaturesMask(~0U);
+	failures += testvectors();
+	failures += testmillion();
+
+	return failures;
+}
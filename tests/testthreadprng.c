@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testthreadprng.c
+ * \brief Unit test program for the per-thread random generators.
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/threadprng.h"
+
+#define NTHREADS	4
+#define NBYTES		256
+
+struct job
+{
+	const randomGenerator*	rng;
+	byte					data[2][NBYTES];
+	int						rc;
+};
+
+/*
+ * generate
+ *  produces two blocks through two contexts in the same thread; the second
+ *  block continues the first since both contexts share the thread's state
+ */
+static void* generate(void* arg)
+{
+	struct job* j = (struct job*) arg;
+	randomGeneratorContext rngc[2];
+	int i;
+
+	j->rc = 0;
+	for (i = 0; i < 2; i++)
+	{
+		if (randomGeneratorContextInit(rngc+i, j->rng))
+		{
+			j->rc = -1;
+			return arg;
+		}
+		if (randomGeneratorContextNext(rngc+i, j->data[i], NBYTES))
+			j->rc = -1;
+		if (randomGeneratorContextFree(rngc+i))
+			j->rc = -1;
+	}
+	return arg;
+}
+
+static int testthreads(const randomGenerator* rng)
+{
+	int failures = 0;
+	struct job jobs[NTHREADS];
+	pthread_t threads[NTHREADS];
+	int i, k;
+
+	for (i = 0; i < NTHREADS; i++)
+	{
+		jobs[i].rng = rng;
+		if (pthread_create(threads+i, (pthread_attr_t*) 0, generate, jobs+i))
+			return -1;
+	}
+	for (i = 0; i < NTHREADS; i++)
+		pthread_join(threads[i], (void**) 0);
+
+	for (i = 0; i < NTHREADS; i++)
+	{
+		if (jobs[i].rc)
+		{
+			printf("%s: thread %d failed\n", rng->name, i);
+			failures++;
+		}
+		if (memcmp(jobs[i].data[0], jobs[i].data[1], NBYTES) == 0)
+		{
+			printf("%s: thread %d repeated its output\n", rng->name, i);
+			failures++;
+		}
+		for (k = 0; k < i; k++)
+		{
+			if (memcmp(jobs[i].data[0], jobs[k].data[0], NBYTES) == 0)
+			{
+				printf("%s: threads %d and %d produced the same output\n", rng->name, k, i);
+				failures++;
+			}
+		}
+	}
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+
+	if (randomGeneratorFind(fips186threadprng.name) != &fips186threadprng || randomGeneratorFind(mtthreadprng.name) != &mtthreadprng)
+	{
+		printf("generators not found\n");
+		failures++;
+	}
+
+	failures += testthreads(&fips186threadprng);
+	failures += testthreads(&mtthreadprng);
+
+	return failures;
+}
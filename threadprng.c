@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2009 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file threadprng.c
+ * \brief Per-thread pseudo-random number generators.
+ *
+ * The generators in this file keep a separate FIPS 186 or Mersenne Twister
+ * state for every thread, so that threads don't contend for the lock of a
+ * shared generator. A thread's state is created and seeded from a shared
+ * FIPS 186 generator the first time the thread needs it, and wiped when the
+ * thread exits.
+ *
+ * Where POSIX threads aren't available the generators fall back to a shared
+ * state, guarded by its lock as usual.
+ *
+ * \ingroup PRNG_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/threadprng.h"
+#include "beecrypt/fips186.h"
+#include "beecrypt/mtprng.h"
+
+#if defined(_REENTRANT) && !WIN32 && !(HAVE_THREAD_H && HAVE_SYNCH_H) && HAVE_PTHREAD_H
+# define THREADPRNG_TLS 1
+#endif
+
+/*!\addtogroup PRNG_m
+ * \{
+ */
+
+#if THREADPRNG_TLS
+static fips186Param master;
+static pthread_once_t masteronce = PTHREAD_ONCE_INIT;
+static pthread_key_t fips186key, mtkey;
+static int masterstatus = -1;
+
+static void fips186threadfree(void* fp)
+{
+	memset(fp, 0, sizeof(fips186Param));
+	free(fp);
+}
+
+static void mtthreadfree(void* mp)
+{
+	memset(mp, 0, sizeof(mtprngParam));
+	free(mp);
+}
+
+static void masterinit(void)
+{
+	if (fips186Setup(&master))
+		return;
+	if (pthread_key_create(&fips186key, fips186threadfree))
+		return;
+	if (pthread_key_create(&mtkey, mtthreadfree))
+		return;
+
+	masterstatus = 0;
+}
+
+static int threadprngSetup(randomGeneratorParam* unused)
+{
+	if (pthread_once(&masteronce, masterinit))
+		return -1;
+
+	return masterstatus;
+}
+
+/*
+ * fips186thread and mtthread
+ *  return the calling thread's state, creating it if necessary; the state
+ *  only gets its lock when it's used through the locked functions, which is
+ *  never the case here
+ */
+static fips186Param* fips186thread(void)
+{
+	fips186Param* fp = (fips186Param*) pthread_getspecific(fips186key);
+
+	if (fp == (fips186Param*) 0)
+	{
+		if ((fp = (fips186Param*) calloc(1, sizeof(fips186Param))) == (fips186Param*) 0)
+			return (fips186Param*) 0;
+
+		if (fips186Next(&master, (byte*) fp->state, sizeof(fp->state)) || pthread_setspecific(fips186key, fp))
+		{
+			fips186threadfree(fp);
+			return (fips186Param*) 0;
+		}
+	}
+	return fp;
+}
+
+static mtprngParam* mtthread(void)
+{
+	mtprngParam* mp = (mtprngParam*) pthread_getspecific(mtkey);
+
+	if (mp == (mtprngParam*) 0)
+	{
+		if ((mp = (mtprngParam*) calloc(1, sizeof(mtprngParam))) == (mtprngParam*) 0)
+			return (mtprngParam*) 0;
+
+		if (fips186Next(&master, (byte*) mp->state, sizeof(mp->state)) || pthread_setspecific(mtkey, mp))
+		{
+			mtthreadfree(mp);
+			return (mtprngParam*) 0;
+		}
+	}
+	return mp;
+}
+
+# define fips186ThreadSeed	fips186SeedUnlocked
+# define fips186ThreadNext	fips186NextUnlocked
+# define mtThreadSeed		mtprngSeedUnlocked
+# define mtThreadNext		mtprngNextUnlocked
+#else
+static fips186Param fips186shared;
+static mtprngParam mtshared;
+static int sharedinit = 0, sharedstatus = -1;
+
+static int threadprngSetup(randomGeneratorParam* unused)
+{
+	if (!sharedinit)
+	{
+		sharedinit = 1;
+		if (fips186Setup(&fips186shared) == 0 && mtprngSetup(&mtshared) == 0)
+			sharedstatus = 0;
+	}
+	return sharedstatus;
+}
+
+# define fips186thread()	(&fips186shared)
+# define mtthread()			(&mtshared)
+
+# define fips186ThreadSeed	fips186Seed
+# define fips186ThreadNext	fips186Next
+# define mtThreadSeed		mtprngSeed
+# define mtThreadNext		mtprngNext
+#endif
+
+static int fips186threadSeed(randomGeneratorParam* unused, const byte* data, size_t size)
+{
+	return fips186ThreadSeed(fips186thread(), data, size);
+}
+
+static int fips186threadNext(randomGeneratorParam* unused, byte* data, size_t size)
+{
+	return fips186ThreadNext(fips186thread(), data, size);
+}
+
+static int mtthreadSeed(randomGeneratorParam* unused, const byte* data, size_t size)
+{
+	return mtThreadSeed(mtthread(), data, size);
+}
+
+static int mtthreadNext(randomGeneratorParam* unused, byte* data, size_t size)
+{
+	return mtThreadNext(mtthread(), data, size);
+}
+
+static int threadprngCleanup(randomGeneratorParam* unused)
+{
+	/* the thread states outlive the contexts */
+	return 0;
+}
+
+const randomGenerator fips186threadprng = {
+	"FIPS 186 per-thread",
+	0,
+	threadprngSetup,
+	fips186threadSeed,
+	fips186threadNext,
+	threadprngCleanup
+};
+
+const randomGenerator mtthreadprng = {
+	"Mersenne Twister per-thread",
+	0,
+	threadprngSetup,
+	mtthreadSeed,
+	mtthreadNext,
+	threadprngCleanup
+};
+
+/*!\}
+ */